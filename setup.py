@@ -45,6 +45,7 @@ orderedstructs = Extension(
         'src/cpy/cOrderedStructs.cpp',
         'src/cpy/OrderedStructs.cpp',
         'src/cpy/cSkipList.cpp',
+        'src/cpy/cRollingMedian.cpp',
         'src/cpy/cmpPyObject.cpp',
         'src/cpp/SkipList.cpp',
     ],
@@ -54,7 +55,7 @@ orderedstructs = Extension(
     ],
     library_dirs=[os.getcwd(), ],
     extra_compile_args=extra_compile_args,
-    extra_link_args=['-lstdc++'],
+    extra_link_args=['-lstdc++', '-pthread'],
     language='c++20',
 )
 
@@ -0,0 +1,535 @@
+//
+//  ConcurrentHeadNode.h
+//  SkipList
+//
+
+#ifndef SkipList_ConcurrentHeadNode_h
+#define SkipList_ConcurrentHeadNode_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+#include "SkipList.h"
+#include "EpochReclamation.h"
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/// Maximum height of a ConcurrentHeadNode tower.
+        const size_t CONCURRENT_HEADNODE_MAX_HEIGHT = 32;
+
+/**
+ * @brief A lock with a version number for optimistic readers.
+ *
+ * The version is odd whilst a writer holds the lock. A reader records the (even) version, reads the protected data
+ * then validates that the version has not changed, if it has the data may be inconsistent and the reader must retry.
+ */
+        struct VersionLock {
+            /// Incremented on lock and on unlock.
+            std::atomic<uint64_t> version{0};
+
+            void lock() {
+                for (size_t spin = 0;; ++spin) {
+                    uint64_t v = version.load(std::memory_order_relaxed);
+                    if (!(v & 1) && version.compare_exchange_weak(v, v + 1, std::memory_order_acquire,
+                                                                  std::memory_order_relaxed)) {
+                        // Order the odd version before any of the writer's stores.
+                        std::atomic_thread_fence(std::memory_order_release);
+                        return;
+                    }
+                    if (spin > 64) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            void unlock() {
+                version.fetch_add(1, std::memory_order_release);
+            }
+            // Wait until there is no writer and return the version.
+            uint64_t read_begin() const {
+                for (size_t spin = 0;; ++spin) {
+                    uint64_t v = version.load(std::memory_order_acquire);
+                    if (!(v & 1)) {
+                        return v;
+                    }
+                    if (spin > 64) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            // Returns true if there has been no writer since read_begin() returned v.
+            bool validate(uint64_t v) const {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return version.load(std::memory_order_relaxed) == v;
+            }
+        };
+
+/**
+ * @brief A Skip List that can be shared between threads without the global mutex and that keeps at() and index().
+ *
+ * Every level of every node has its own VersionLock protecting the link to the next node and the width of that link.
+ *
+ * Writers, insert() and remove(), descend from the top of the head with lock coupling: the lock on the next node at
+ * a level, or on the same node at the level below, is taken before the current one is released. The widths of the
+ * links that span the change are fixed up on the way down whilst the lock on that link is held. As the links near the
+ * top of the head span most of the list every writer passes through them but only holds each one briefly, below that
+ * writers in different key regions take different locks and proceed in parallel. All locks are taken in the order of
+ * decreasing level then increasing position so writers can not deadlock.
+ *
+ * Readers, has(), at() and index(), take no locks. They use the same lock coupled descent but record versions rather
+ * than locking and restart from the top if a version changes. A reader therefore sees either all or none of a
+ * writer's changes to any path it follows so at() and index() are linearizable with the writers.
+ *
+ * Removed nodes may still be being read by a reader so they are freed by epoch based reclamation.
+ *
+ * Duplicate values are allowed, each node has a unique insertion sequence number that orders equal values.
+ * Values that do not compare equal to themselves, such as NaN, are rejected with a FailedComparison exception.
+ *
+ * @tparam T The type of the values, it must be copy constructible.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class ConcurrentHeadNode {
+        public:
+            explicit ConcurrentHeadNode(Compare cmp=Compare());
+            // Destruction must not be concurrent with any other operation.
+            ~ConcurrentHeadNode();
+            ConcurrentHeadNode(const ConcurrentHeadNode &) = delete;
+            ConcurrentHeadNode &operator=(const ConcurrentHeadNode &) = delete;
+
+            // Returns true if the value is present.
+            bool has(const T &value) const;
+            // Returns a copy of the value at the index.
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            T at(size_t index) const;
+            // Computes index of the first occurrence of a value.
+            // Will throw a ValueError if the value does not exist.
+            size_t index(const T &value) const;
+            // Number of values, this is exact when there are no concurrent writers.
+            size_t size() const {
+                return _count.load(std::memory_order_relaxed);
+            }
+            // Insert a value.
+            void insert(const T &value);
+            // Remove a value and return it.
+            // Will throw a ValueError is value not present.
+            T remove(const T &value);
+            // Check the ordering, heights and widths, there must be no concurrent operations.
+            IntegrityCheck lacksIntegrity() const;
+        protected:
+            struct Node;
+            /// One level of a tower, the link to the next node at this level and the number of steps it spans.
+            /// The width is not maintained whilst the link is null.
+            struct Level {
+                VersionLock lock;
+                std::atomic<Node *> next{nullptr};
+                std::atomic<size_t> width{0};
+            };
+            /// A node, the tower is a separate allocation of height levels.
+            struct Node {
+                Node(const T &v, uint64_t s, size_t h) : value(v), seq(s), height(h), claimed(false),
+                                                         levels(new Level[h]) {}
+                T value;
+                /// Insertion sequence number, orders equal values.
+                uint64_t seq;
+                size_t height;
+                /// Set by the remove() that owns the removal of this node.
+                std::atomic<bool> claimed;
+                std::unique_ptr<Level[]> levels;
+            };
+            static void _delete(void *ptr) {
+                delete static_cast<Node *>(ptr);
+            }
+            // Returns true if node is ordered before (value, seq).
+            bool _before(const Node *node, const T &value, uint64_t seq) const {
+                return _compare(node->value, value) || (!_compare(value, node->value) && node->seq < seq);
+            }
+            // Optimistic descent for readers, see the implementation.
+            template <typename Advance>
+            void _read_descend(Advance advance, const Node *&pred, size_t &rank, const Node *&next) const;
+            // Lock the head at the top level, returns the number of levels.
+            size_t _lock_head(size_t min_height);
+            void _throwIfValueDoesNotCompare(const T &value) const {
+                if (value != value) {
+                    throw FailedComparison(
+                        "Can not work with something that does not compare equal to itself.");
+                }
+            }
+            void _throwValueErrorNotFound(const T &value) const;
+            /// The head tower.
+            Level _head[CONCURRENT_HEADNODE_MAX_HEIGHT];
+            /// The height of the tallest node ever inserted, only increases.
+            std::atomic<size_t> _height;
+            /// The number of values.
+            std::atomic<size_t> _count;
+            /// Source of the insertion sequence numbers.
+            std::atomic<uint64_t> _sequence;
+            /// Comparison function.
+            Compare _compare;
+            /// Reclamation of removed nodes.
+            std::shared_ptr<EpochDomain> _domain;
+        };
+
+        template <typename T, typename Compare>
+        ConcurrentHeadNode<T, Compare>::ConcurrentHeadNode(Compare cmp) :
+                _height(1), _count(0), _sequence(0), _compare(cmp),
+                _domain(std::make_shared<EpochDomain>(_delete)) {}
+
+        template <typename T, typename Compare>
+        ConcurrentHeadNode<T, Compare>::~ConcurrentHeadNode() {
+            Node *node = _head[0].next.load();
+            while (node) {
+                Node *next = node->levels[0].next.load();
+                delete node;
+                node = next;
+            }
+            _domain->drain();
+        }
+
+/**
+ * Descend from the top of the head without taking any locks. At each level this moves right whilst
+ * <tt>advance(next, rank, width)</tt> is true, where rank is the rank of the current node (the head is 0) and width
+ * the width of the link to next. Each link is read between recording and validating the version of its level, moving
+ * to the next node records its version before validating the current one. If any validation fails the descent restarts.
+ *
+ * The caller must be pinned.
+ *
+ * @param advance Function that decides whether to move right.
+ * @param pred On return the last node at the bottom level where advance was false, nullptr for the head.
+ * @param rank On return the rank of pred.
+ * @param next On return the successor of pred at the bottom level, may be nullptr.
+ */
+        template <typename T, typename Compare>
+        template <typename Advance>
+        void ConcurrentHeadNode<T, Compare>::_read_descend(Advance advance, const Node *&pred, size_t &rank,
+                                                           const Node *&next) const {
+        restart:
+            size_t height = _height.load(std::memory_order_acquire);
+            const Level *levels = _head;
+            pred = nullptr;
+            rank = 0;
+            uint64_t version = levels[height - 1].lock.read_begin();
+            if (_height.load(std::memory_order_acquire) != height) {
+                goto restart;
+            }
+            for (size_t l = height; l-- > 0;) {
+                while (true) {
+                    next = levels[l].next.load(std::memory_order_acquire);
+                    size_t width = levels[l].width.load(std::memory_order_relaxed);
+                    if (!levels[l].lock.validate(version)) {
+                        goto restart;
+                    }
+                    if (!next || !advance(next, rank, width)) {
+                        break;
+                    }
+                    uint64_t next_version = next->levels[l].lock.read_begin();
+                    if (!levels[l].lock.validate(version)) {
+                        goto restart;
+                    }
+                    levels = next->levels.get();
+                    pred = next;
+                    rank += width;
+                    version = next_version;
+                }
+                if (l > 0) {
+                    uint64_t down_version = levels[l - 1].lock.read_begin();
+                    if (!levels[l].lock.validate(version)) {
+                        goto restart;
+                    }
+                    version = down_version;
+                }
+            }
+        }
+
+/**
+ * Returns true if the value is present.
+ *
+ * @param value The value to search for.
+ * @return true if present.
+ */
+        template <typename T, typename Compare>
+        bool ConcurrentHeadNode<T, Compare>::has(const T &value) const {
+            _throwIfValueDoesNotCompare(value);
+            EpochGuard guard(_domain);
+            const Node *pred = nullptr;
+            const Node *next = nullptr;
+            size_t rank = 0;
+            _read_descend([this, &value](const Node *node, size_t, size_t) {
+                return _compare(node->value, value);
+            }, pred, rank, next);
+            return next && !_compare(value, next->value);
+        }
+
+/**
+ * Returns a copy of the value at a particular index, a reference could be invalidated by a concurrent remove().
+ * Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+ *
+ * @param index The index.
+ * @return The value at that index.
+ */
+        template <typename T, typename Compare>
+        T ConcurrentHeadNode<T, Compare>::at(size_t index) const {
+            EpochGuard guard(_domain);
+            const Node *pred = nullptr;
+            const Node *next = nullptr;
+            size_t rank = 0;
+            _read_descend([index](const Node *, size_t node_rank, size_t width) {
+                return node_rank + width <= index + 1;
+            }, pred, rank, next);
+            if (!pred || rank != index + 1) {
+                _throw_exceeds_size(size());
+            }
+            return pred->value;
+        }
+
+/**
+ * Finds the index of the first occurrence of a value.
+ * Will throw a OrderedStructs::SkipList::ValueError if the value does not exist.
+ *
+ * @param value The value to search for.
+ * @return The index.
+ */
+        template <typename T, typename Compare>
+        size_t ConcurrentHeadNode<T, Compare>::index(const T &value) const {
+            _throwIfValueDoesNotCompare(value);
+            EpochGuard guard(_domain);
+            const Node *pred = nullptr;
+            const Node *next = nullptr;
+            size_t rank = 0;
+            _read_descend([this, &value](const Node *node, size_t, size_t) {
+                return _compare(node->value, value);
+            }, pred, rank, next);
+            if (!next || _compare(value, next->value)) {
+                _throwValueErrorNotFound(value);
+            }
+            return rank;
+        }
+
+/**
+ * Lock the head at the top level. If the height has increased after the lock was taken a taller node has been
+ * inserted so this unlocks and tries again at the new height.
+ *
+ * @param min_height The height of the node being inserted, the head is locked at least at this height.
+ * @return The number of levels to descend.
+ */
+        template <typename T, typename Compare>
+        size_t ConcurrentHeadNode<T, Compare>::_lock_head(size_t min_height) {
+            while (true) {
+                size_t top = std::max(_height.load(std::memory_order_acquire), min_height);
+                _head[top - 1].lock.lock();
+                if (_height.load(std::memory_order_acquire) <= top) {
+                    return top;
+                }
+                _head[top - 1].lock.unlock();
+            }
+        }
+
+/**
+ * Insert a value after any equal values.
+ *
+ * This descends with lock coupling. Above the height of the new node the width of the link that will span the new
+ * node is incremented and the lock released as soon as the level below is locked. Below the height of the new node the
+ * locks on the predecessors are kept, together with the widths passed at each level, until the bottom is reached.
+ * Then the new node is linked in at every level with the widths split either side of it.
+ *
+ * @param value The value to insert.
+ */
+        template <typename T, typename Compare>
+        void ConcurrentHeadNode<T, Compare>::insert(const T &value) {
+            _throwIfValueDoesNotCompare(value);
+            EpochGuard guard(_domain);
+            const uint64_t seq = _sequence.fetch_add(1, std::memory_order_relaxed);
+            const size_t height = randomHeight(CONCURRENT_HEADNODE_MAX_HEIGHT);
+            Node *node = new Node(value, seq, height);
+            Level *preds[CONCURRENT_HEADNODE_MAX_HEIGHT];
+            // Sum of the widths passed at each level, from the predecessor at the level above to the one at this level.
+            size_t gaps[CONCURRENT_HEADNODE_MAX_HEIGHT];
+
+            size_t top = _lock_head(height);
+            Level *levels = _head;
+            for (size_t l = top; l-- > 0;) {
+                gaps[l] = 0;
+                while (true) {
+                    Node *next = levels[l].next.load(std::memory_order_relaxed);
+                    if (!next || !_before(next, value, seq)) {
+                        break;
+                    }
+                    next->levels[l].lock.lock();
+                    gaps[l] += levels[l].width.load(std::memory_order_relaxed);
+                    levels[l].lock.unlock();
+                    levels = next->levels.get();
+                }
+                preds[l] = levels;
+                if (l >= height) {
+                    levels[l].width.store(levels[l].width.load(std::memory_order_relaxed) + 1,
+                                          std::memory_order_relaxed);
+                }
+                if (l > 0) {
+                    levels[l - 1].lock.lock();
+                    if (l >= height) {
+                        levels[l].lock.unlock();
+                    }
+                }
+            }
+            // Distance from the predecessor at level l to the new node.
+            size_t distance = 1;
+            for (size_t l = 0; l < height; ++l) {
+                if (l > 0) {
+                    distance += gaps[l - 1];
+                }
+                Level &pred = preds[l][l];
+                Node *succ = pred.next.load(std::memory_order_relaxed);
+                node->levels[l].next.store(succ, std::memory_order_relaxed);
+                node->levels[l].width.store(
+                        succ ? pred.width.load(std::memory_order_relaxed) + 1 - distance : 0,
+                        std::memory_order_relaxed);
+                pred.width.store(distance, std::memory_order_relaxed);
+                pred.next.store(node, std::memory_order_release);
+            }
+            size_t current = _height.load(std::memory_order_relaxed);
+            while (current < height && !_height.compare_exchange_weak(current, height, std::memory_order_release)) {}
+            _count.fetch_add(1, std::memory_order_relaxed);
+            for (size_t l = 0; l < height; ++l) {
+                preds[l][l].lock.unlock();
+            }
+        }
+
+/**
+ * Remove a value.
+ *
+ * First an optimistic search finds a node with the value and claims it so no other remove() can take it. If every
+ * node with the value is claimed the search is repeated until they have gone. Then a lock coupled descent, like
+ * insert(), decrements the widths that span the node and unlinks it at every level of its tower.
+ *
+ * @param value The value to remove.
+ * @return The value removed.
+ */
+        template <typename T, typename Compare>
+        T ConcurrentHeadNode<T, Compare>::remove(const T &value) {
+            _throwIfValueDoesNotCompare(value);
+            EpochGuard guard(_domain);
+            Node *victim = nullptr;
+            while (!victim) {
+                const Node *pred = nullptr;
+                const Node *next = nullptr;
+                size_t rank = 0;
+                _read_descend([this, &value](const Node *node, size_t, size_t) {
+                    return _compare(node->value, value);
+                }, pred, rank, next);
+                bool seen_claimed = false;
+                for (Node *node = const_cast<Node *>(next); node && !_compare(value, node->value);
+                     node = node->levels[0].next.load(std::memory_order_acquire)) {
+                    bool expected = false;
+                    if (node->claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                        victim = node;
+                        break;
+                    }
+                    seen_claimed = true;
+                }
+                if (!victim) {
+                    if (!seen_claimed) {
+                        _throwValueErrorNotFound(value);
+                    }
+                    std::this_thread::yield();
+                }
+            }
+            const uint64_t seq = victim->seq;
+            const size_t height = victim->height;
+            size_t top = _lock_head(height);
+            Level *levels = _head;
+            for (size_t l = top; l-- > 0;) {
+                while (true) {
+                    Node *next = levels[l].next.load(std::memory_order_relaxed);
+                    if (!next || next == victim || !_before(next, value, seq)) {
+                        break;
+                    }
+                    next->levels[l].lock.lock();
+                    levels[l].lock.unlock();
+                    levels = next->levels.get();
+                }
+                if (l >= height) {
+                    levels[l].width.store(levels[l].width.load(std::memory_order_relaxed) - 1,
+                                          std::memory_order_relaxed);
+                } else {
+                    assert(levels[l].next.load() == victim);
+                    Level &removed = victim->levels[l];
+                    removed.lock.lock();
+                    Node *succ = removed.next.load(std::memory_order_relaxed);
+                    levels[l].width.store(succ ? levels[l].width.load(std::memory_order_relaxed) +
+                                                 removed.width.load(std::memory_order_relaxed) - 1 : 0,
+                                          std::memory_order_relaxed);
+                    levels[l].next.store(succ, std::memory_order_release);
+                    removed.lock.unlock();
+                }
+                if (l > 0) {
+                    levels[l - 1].lock.lock();
+                }
+                levels[l].lock.unlock();
+            }
+            _count.fetch_sub(1, std::memory_order_relaxed);
+            T result = victim->value;
+            guard.retire(victim);
+            return result;
+        }
+
+        template <typename T, typename Compare>
+        void ConcurrentHeadNode<T, Compare>::_throwValueErrorNotFound(const T &value) const {
+#ifdef INCLUDE_METHODS_THAT_USE_STREAMS
+            std::ostringstream oss;
+            oss << "Value " << value << " not found.";
+            std::string err_msg = oss.str();
+#else
+            std::string err_msg = "Value not found.";
+#endif
+            throw ValueError(err_msg);
+        }
+
+/**
+ * Check that every level is in strictly increasing order of (value, sequence number), only contains nodes that are
+ * tall enough and that every non-null link has the correct width. Also checks that the count matches the bottom level.
+ * There must be no concurrent operations.
+ *
+ * @return INTEGRITY_SUCCESS or an IntegrityCheck error code.
+ */
+        template <typename T, typename Compare>
+        IntegrityCheck ConcurrentHeadNode<T, Compare>::lacksIntegrity() const {
+            std::unordered_map<const Node *, size_t> ranks;
+            size_t rank = 0;
+            for (const Node *node = _head[0].next.load(); node; node = node->levels[0].next.load()) {
+                ranks[node] = ++rank;
+            }
+            if (rank != size()) {
+                return HEADNODE_COUNT_MISMATCH;
+            }
+            for (size_t l = 0; l < CONCURRENT_HEADNODE_MAX_HEIGHT; ++l) {
+                const Node *prev = nullptr;
+                const Level *levels = _head;
+                while (const Node *next = levels[l].next.load()) {
+                    if (next->height <= l) {
+                        return NODE_HEIGHT_EXCEEDS_HEADNODE;
+                    }
+                    if (ranks.find(next) == ranks.end()) {
+                        return NODE_REFERENCES_NOT_IN_GLOBAL_SET;
+                    }
+                    if (prev && !_before(prev, next->value, next->seq)) {
+                        return HEADNODE_DETECTS_OUT_OF_ORDER;
+                    }
+                    if (levels[l].width.load() != ranks[next] - (prev ? ranks[prev] : 0)) {
+                        return HEADNODE_LEVEL_WIDTHS_MISMATCH;
+                    }
+                    prev = next;
+                    levels = next->levels.get();
+                }
+            }
+            return INTEGRITY_SUCCESS;
+        }
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_ConcurrentHeadNode_h
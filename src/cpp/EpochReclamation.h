@@ -0,0 +1,270 @@
+//
+//  EpochReclamation.h
+//  SkipList
+//
+
+#ifndef SkipList_EpochReclamation_h
+#define SkipList_EpochReclamation_h
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/************************ Epoch based reclamation ****************************/
+
+/**
+ * @brief Per thread state for epoch based reclamation.
+ *
+ * A thread claims a record for the duration of its use of an EpochDomain. The announced epoch is zero when the thread
+ * is not inside an operation, otherwise it is <tt>(epoch << 1) | 1</tt>. Retired pointers are kept in three buckets
+ * indexed by the epoch in which they were retired, only the owning thread touches the buckets.
+ */
+        struct alignas(64) EpochRecord {
+            /// The announced epoch, see above.
+            std::atomic<uint64_t> announced{0};
+            /// True if this record is claimed by a thread.
+            std::atomic<bool> in_use{true};
+            /// Next record in the domain, immutable once published.
+            EpochRecord *next = nullptr;
+            /// The epoch observed by the last pin().
+            uint64_t epoch = 0;
+            /// Retired pointers by epoch modulo 3.
+            std::vector<void *> limbo[3];
+            /// The epoch of the pointers in each of the limbo buckets.
+            uint64_t limbo_epoch[3] = {0, 0, 0};
+            /// Number of retirements since the last attempt to advance the global epoch.
+            size_t retired_count = 0;
+        };
+
+/**
+ * @brief Epoch based reclamation of memory that may still be visible to concurrent readers.
+ *
+ * A pointer that has been made unreachable is retired in the current epoch and is only freed once the global epoch
+ * has advanced twice. The global epoch only advances when every thread inside an operation has observed the current
+ * epoch so no thread can still hold a reference to the retired pointer.
+ *
+ * The domain is owned by a std::shared_ptr so that a thread's cached record stays valid after the owning container has
+ * been destroyed, the record is released when the thread exits.
+ */
+        class EpochDomain {
+        public:
+            /**
+             * Constructor.
+             *
+             * @param deleter Function used to free a retired pointer.
+             */
+            explicit EpochDomain(void (*deleter)(void *)) : _deleter(deleter) {}
+            // Free everything retired, there must be no concurrent operations.
+            ~EpochDomain();
+            // Claim a record for this thread, creating one if necessary.
+            EpochRecord *acquire();
+            // Announce the current epoch and free anything that is now safe to free.
+            void pin(EpochRecord *record);
+            // Announce that this thread holds no references.
+            void unpin(EpochRecord *record) {
+                record->announced.store(0, std::memory_order_release);
+            }
+            // Retire a pointer that is no longer reachable, it will be freed when it is safe to do so.
+            void retire(EpochRecord *record, void *ptr);
+            // Free everything retired, there must be no concurrent operations.
+            void drain();
+        protected:
+            // Free the contents of a limbo bucket.
+            void _free_bucket(EpochRecord *record, size_t bucket);
+            // Advance the global epoch if every pinned thread has observed it.
+            void _try_advance(uint64_t epoch);
+            /// The global epoch.
+            std::atomic<uint64_t> _epoch{1};
+            /// Singly linked list of records, records are never removed whilst the domain exists.
+            std::atomic<EpochRecord *> _records{nullptr};
+            /// Frees a retired pointer.
+            void (*_deleter)(void *);
+        };
+
+/// Number of retirements by a thread before it attempts to advance the global epoch.
+        const size_t EPOCH_ADVANCE_INTERVAL = 64;
+
+/**
+ * @brief The records claimed by a thread, one per domain, released when the thread exits.
+ */
+        struct EpochThreadCache {
+            /// The domains and the records claimed in them.
+            std::vector<std::pair<std::shared_ptr<EpochDomain>, EpochRecord *>> entries;
+
+            // Find or claim the record for the domain.
+            EpochRecord *record(const std::shared_ptr<EpochDomain> &domain);
+
+            ~EpochThreadCache() {
+                for (auto &entry: entries) {
+                    entry.second->in_use.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+/// The records claimed by this thread.
+        inline thread_local EpochThreadCache tEpochThreadCache;
+
+/**
+ * @brief RAII guard for an operation, the thread is pinned for the lifetime of the guard.
+ */
+        class EpochGuard {
+        public:
+            explicit EpochGuard(const std::shared_ptr<EpochDomain> &domain) :
+                    _domain(domain.get()), _record(tEpochThreadCache.record(domain)) {
+                _domain->pin(_record);
+            }
+            ~EpochGuard() {
+                _domain->unpin(_record);
+            }
+            EpochGuard(const EpochGuard &) = delete;
+            EpochGuard &operator=(const EpochGuard &) = delete;
+            // Retire a pointer in the pinned epoch.
+            void retire(void *ptr) {
+                _domain->retire(_record, ptr);
+            }
+        private:
+            EpochDomain *_domain;
+            EpochRecord *_record;
+        };
+
+        inline EpochDomain::~EpochDomain() {
+            drain();
+            EpochRecord *record = _records.load();
+            while (record) {
+                EpochRecord *next = record->next;
+                delete record;
+                record = next;
+            }
+        }
+
+/**
+ * Claim an unused record or, if all are in use, create one and push it on to the front of the list.
+ *
+ * @return The record, owned by this thread until it is released.
+ */
+        inline EpochRecord *EpochDomain::acquire() {
+            for (EpochRecord *record = _records.load(std::memory_order_acquire); record; record = record->next) {
+                bool expected = false;
+                if (!record->in_use.load(std::memory_order_relaxed) &&
+                    record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return record;
+                }
+            }
+            EpochRecord *record = new EpochRecord();
+            record->next = _records.load(std::memory_order_relaxed);
+            while (!_records.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                   std::memory_order_relaxed)) {}
+            return record;
+        }
+
+/**
+ * Announce the current epoch. The fence orders the announcement before any subsequent load of a shared pointer
+ * so a thread advancing the epoch either sees this thread as pinned or this thread can not see anything retired
+ * before the announcement.
+ *
+ * @param record This thread's record.
+ */
+        inline void EpochDomain::pin(EpochRecord *record) {
+            uint64_t epoch = _epoch.load(std::memory_order_acquire);
+            record->announced.store((epoch << 1) | 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (epoch != record->epoch) {
+                record->epoch = epoch;
+                for (size_t bucket = 0; bucket < 3; ++bucket) {
+                    if (record->limbo_epoch[bucket] + 2 <= epoch) {
+                        _free_bucket(record, bucket);
+                    }
+                }
+            }
+        }
+
+/**
+ * Retire a pointer in the current global epoch.
+ * This is read after the pointer was made unreachable rather than using the pinned epoch, which may be one behind, as
+ * a thread pinned in the following epoch may still have seen the pointer before it was unlinked.
+ * A bucket that holds pointers of an earlier epoch congruent modulo 3 is at least three epochs old so is freed first.
+ *
+ * @param record This thread's record.
+ * @param ptr The pointer, it must already be unreachable by any thread that pins after this call.
+ */
+        inline void EpochDomain::retire(EpochRecord *record, void *ptr) {
+            uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+            size_t bucket = epoch % 3;
+            if (record->limbo_epoch[bucket] != epoch) {
+                _free_bucket(record, bucket);
+                record->limbo_epoch[bucket] = epoch;
+            }
+            record->limbo[bucket].push_back(ptr);
+            if (++record->retired_count >= EPOCH_ADVANCE_INTERVAL) {
+                record->retired_count = 0;
+                _try_advance(record->epoch);
+            }
+        }
+
+        inline void EpochDomain::drain() {
+            for (EpochRecord *record = _records.load(); record; record = record->next) {
+                for (size_t bucket = 0; bucket < 3; ++bucket) {
+                    _free_bucket(record, bucket);
+                }
+            }
+        }
+
+        inline void EpochDomain::_free_bucket(EpochRecord *record, size_t bucket) {
+            for (void *ptr: record->limbo[bucket]) {
+                _deleter(ptr);
+            }
+            record->limbo[bucket].clear();
+        }
+
+/**
+ * Advance the global epoch from epoch to epoch + 1 if no thread is pinned in an earlier epoch.
+ *
+ * @param epoch The epoch observed by the caller.
+ */
+        inline void EpochDomain::_try_advance(uint64_t epoch) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for (EpochRecord *record = _records.load(std::memory_order_acquire); record; record = record->next) {
+                uint64_t announced = record->announced.load(std::memory_order_acquire);
+                if ((announced & 1) && (announced >> 1) != epoch) {
+                    return;
+                }
+            }
+            _epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+        }
+
+/**
+ * Find this thread's record for the domain or claim one. Entries for domains that are only referenced by this cache,
+ * that is their container has been destroyed, are released and dropped.
+ *
+ * @param domain The domain.
+ * @return The record.
+ */
+        inline EpochRecord *EpochThreadCache::record(const std::shared_ptr<EpochDomain> &domain) {
+            for (auto &entry: entries) {
+                if (entry.first == domain) {
+                    return entry.second;
+                }
+            }
+            for (auto iter = entries.begin(); iter != entries.end();) {
+                if (iter->first.use_count() == 1) {
+                    iter->second->in_use.store(false, std::memory_order_release);
+                    iter = entries.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+            entries.emplace_back(domain, domain->acquire());
+            return entries.back().second;
+        }
+
+/************************ END: Epoch based reclamation ****************************/
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_EpochReclamation_h
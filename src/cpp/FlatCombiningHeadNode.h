@@ -0,0 +1,261 @@
+//
+//  FlatCombiningHeadNode.h
+//  SkipList
+//
+
+#ifndef SkipList_FlatCombiningHeadNode_h
+#define SkipList_FlatCombiningHeadNode_h
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/// Number of publication slots, this many threads can have a request outstanding at once.
+        const size_t FLAT_COMBINING_SLOTS = 64;
+/// The combiner scans the slots at most this many times before releasing the lock.
+        const size_t FLAT_COMBINING_PASSES = 4;
+
+/**
+ * @brief A HeadNode shared between many threads by flat combining rather than by handing a mutex between them.
+ *
+ * A thread posts its request in a publication slot then tries to take the combining lock. The thread that gets the lock
+ * becomes the combiner, it collects every pending request, sorts them by value so that consecutive operations search
+ * along nearby paths, applies them to the HeadNode and publishes the results. Other threads wait for their result or
+ * for the lock to become free. So under contention the lock is taken once per batch rather than once per operation and
+ * the Skip List stays in the cache of the combiner.
+ *
+ * All the requests in one batch are concurrent so any order of applying them is linearizable. Within a batch, for equal
+ * values, inserts are applied before queries and queries before removes.
+ *
+ * The HeadNode does not use the global mutex. Exceptions, such as a ValueError from remove(), are rethrown in the thread
+ * that made the request.
+ *
+ * @tparam T The type of the values, it must be copy constructible.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class FlatCombiningHeadNode {
+        public:
+            explicit FlatCombiningHeadNode(Compare cmp=Compare()) : _list(cmp, false), _count(0), _compare(cmp) {}
+            FlatCombiningHeadNode(const FlatCombiningHeadNode &) = delete;
+            FlatCombiningHeadNode &operator=(const FlatCombiningHeadNode &) = delete;
+
+            // Returns true if the value is present.
+            bool has(const T &value) {
+                return _execute(HAS, &value, 0).flag;
+            }
+            // Returns a copy of the value at the index.
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            T at(size_t index) {
+                return *_execute(AT, nullptr, index).value;
+            }
+            // Computes index of the first occurrence of a value.
+            // Will throw a ValueError if the value does not exist.
+            size_t index(const T &value) {
+                return _execute(INDEX, &value, 0).index;
+            }
+            // Number of values, this is exact when there are no concurrent writers.
+            size_t size() const {
+                return _count.load(std::memory_order_relaxed);
+            }
+            // Insert a value.
+            void insert(const T &value) {
+                _execute(INSERT, &value, 0);
+            }
+            // Remove a value and return it.
+            // Will throw a ValueError is value not present.
+            T remove(const T &value) {
+                return *_execute(REMOVE, &value, 0).value;
+            }
+            // Check the integrity of the HeadNode, there must be no concurrent operations.
+            IntegrityCheck lacksIntegrity() const {
+                return _list.lacksIntegrity();
+            }
+        protected:
+            /// Operations, for equal values they are applied in this order.
+            enum Operation {
+                INSERT, HAS, INDEX, AT, REMOVE
+            };
+            /// Slot states.
+            enum State {
+                FREE, CLAIMED, PENDING, DONE
+            };
+            /// The result of one request.
+            struct Result {
+                bool flag = false;
+                size_t index = 0;
+                std::optional<T> value;
+                std::exception_ptr error;
+            };
+            /// A publication slot on its own cache line.
+            struct alignas(64) Slot {
+                std::atomic<int> state{FREE};
+                Operation operation = INSERT;
+                /// The value for the request, it is owned by the requesting thread which waits for the result.
+                const T *value = nullptr;
+                size_t index = 0;
+                Result result;
+            };
+            // Post a request and wait for its result, combining if this thread gets the lock.
+            Result _execute(Operation operation, const T *value, size_t index);
+            // Apply every pending request, the combining lock must be held.
+            void _combine();
+            // Apply one request.
+            void _apply(Slot &slot);
+
+            Slot _slots[FLAT_COMBINING_SLOTS];
+            /// Held by the combiner.
+            std::mutex _combiner;
+            /// The Skip List, only accessed by the combiner.
+            HeadNode<T, Compare> _list;
+            /// Mirror of _list.size() that can be read without the lock.
+            std::atomic<size_t> _count;
+            /// Comparison function.
+            Compare _compare;
+        };
+
+/**
+ * If the combining lock is free apply the request directly. Otherwise claim a slot, starting at one chosen by the
+ * thread id so that threads rarely compete for a slot, fill in the request then either combine or wait for a combiner
+ * to complete it.
+ * If the request threw an exception this rethrows it.
+ *
+ * @param operation The operation.
+ * @param value Pointer to the value, nullptr for at().
+ * @param index The index for at().
+ * @return The result.
+ */
+        template <typename T, typename Compare>
+        typename FlatCombiningHeadNode<T, Compare>::Result
+        FlatCombiningHeadNode<T, Compare>::_execute(Operation operation, const T *value, size_t index) {
+            if (value && *value != *value) {
+                throw FailedComparison("Can not work with something that does not compare equal to itself.");
+            }
+            // Uncontended, apply it directly.
+            if (_combiner.try_lock()) {
+                Slot slot;
+                slot.operation = operation;
+                slot.value = value;
+                slot.index = index;
+                _apply(slot);
+                _count.store(_list.size(), std::memory_order_relaxed);
+                _combiner.unlock();
+                if (slot.result.error) {
+                    std::rethrow_exception(slot.result.error);
+                }
+                return std::move(slot.result);
+            }
+            size_t slot_index = std::hash<std::thread::id>()(std::this_thread::get_id()) % FLAT_COMBINING_SLOTS;
+            while (true) {
+                int expected = FREE;
+                if (_slots[slot_index].state.compare_exchange_weak(expected, CLAIMED, std::memory_order_acquire,
+                                                                   std::memory_order_relaxed)) {
+                    break;
+                }
+                slot_index = (slot_index + 1) % FLAT_COMBINING_SLOTS;
+                if (slot_index == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            Slot &slot = _slots[slot_index];
+            slot.operation = operation;
+            slot.value = value;
+            slot.index = index;
+            slot.state.store(PENDING, std::memory_order_release);
+            while (slot.state.load(std::memory_order_acquire) != DONE) {
+                if (_combiner.try_lock()) {
+                    _combine();
+                    _combiner.unlock();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            Result result = std::move(slot.result);
+            slot.result = Result();
+            slot.state.store(FREE, std::memory_order_release);
+            if (result.error) {
+                std::rethrow_exception(result.error);
+            }
+            return result;
+        }
+
+/**
+ * Gather the pending requests, sort them by value and apply them. Repeat whilst new requests keep arriving, up to
+ * FLAT_COMBINING_PASSES times so that one thread is not the combiner for ever.
+ */
+        template <typename T, typename Compare>
+        void FlatCombiningHeadNode<T, Compare>::_combine() {
+            std::vector<Slot *> batch;
+            batch.reserve(FLAT_COMBINING_SLOTS);
+            for (size_t pass = 0; pass < FLAT_COMBINING_PASSES; ++pass) {
+                batch.clear();
+                for (Slot &slot: _slots) {
+                    if (slot.state.load(std::memory_order_acquire) == PENDING) {
+                        batch.push_back(&slot);
+                    }
+                }
+                if (batch.empty()) {
+                    break;
+                }
+                // at() has no value so goes last, in index order.
+                std::sort(batch.begin(), batch.end(), [this](const Slot *a, const Slot *b) {
+                    if (!a->value || !b->value) {
+                        return b->value ? false : (a->value ? true : a->index < b->index);
+                    }
+                    if (_compare(*a->value, *b->value)) {
+                        return true;
+                    }
+                    if (_compare(*b->value, *a->value)) {
+                        return false;
+                    }
+                    return a->operation < b->operation;
+                });
+                for (Slot *slot: batch) {
+                    _apply(*slot);
+                }
+                _count.store(_list.size(), std::memory_order_relaxed);
+                for (Slot *slot: batch) {
+                    slot->state.store(DONE, std::memory_order_release);
+                }
+            }
+        }
+
+        template <typename T, typename Compare>
+        void FlatCombiningHeadNode<T, Compare>::_apply(Slot &slot) {
+            try {
+                switch (slot.operation) {
+                    case INSERT:
+                        _list.insert(*slot.value);
+                        break;
+                    case HAS:
+                        slot.result.flag = _list.has(*slot.value);
+                        break;
+                    case INDEX:
+                        slot.result.index = _list.index(*slot.value);
+                        break;
+                    case AT:
+                        slot.result.value = _list.at(slot.index);
+                        break;
+                    case REMOVE:
+                        slot.result.value = _list.remove(*slot.value);
+                        break;
+                }
+            } catch (...) {
+                slot.result.error = std::current_exception();
+            }
+        }
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_FlatCombiningHeadNode_h
@@ -36,6 +36,9 @@
 #define SkipList_HeadNode_h
 
 #include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
 //#ifdef SKIPLIST_THREAD_SUPPORT
 //    #include <mutex>
 //#endif
@@ -53,6 +56,10 @@
 namespace OrderedStructs {
     namespace SkipList {
 
+/// Height up to which removal by index keeps its per level references on the stack, a tower grows with probability 1/2
+/// so no practical Skip List is taller than this.
+        const size_t HEADNODE_STACK_HEIGHT = 64;
+
 /** HeadNode
  *
  * @brief A HeadNode is a skip list. This is the single node leading to all other content Nodes.
@@ -69,22 +76,42 @@ namespace OrderedStructs {
  *      sl.remove(sl.at(50)); // Remove 50 pi
  * @endcode
  *
+ * The widths can be augmented to carry, for example, the sum of the values that they skip over. This gives O(log(n))
+ * prefix and range sums by rank or by value:
+ *
+ * @code
+ *      OrderedStructs::SkipList::HeadNode<double, std::less<double>,
+ *          OrderedStructs::SkipList::SumSquaresAugment<double>> sl;
+ *      // ... insert values.
+ *      // Mean and variance of the central 80% of the values.
+ *      size_t trim = sl.size() / 10;
+ *      OrderedStructs::SkipList::SumSquaresAugment<double> aug = sl.range(trim, sl.size() - 2 * trim);
+ *      aug.mean(sl.size() - 2 * trim);
+ *      aug.variance(sl.size() - 2 * trim);
+ * @endcode
+ *
  * Created by Paul Ross on 03/12/2015.
  *
  * Copyright (c) 2015-2023 Paul Ross. All rights reserved.
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Augmentation of the widths.
  */
-template <typename T, typename Compare=std::less<T>>
+template <typename T, typename Compare=std::less<T>, typename Augment=NoAugment<T>>
 class HeadNode {
 public:
     /**
      * Constructor for and Empty Skip List.
      *
+     * If @ref SKIPLIST_THREAD_SUPPORT is defined then every method locks the global gSkipListMutex. A Skip List that is
+     * confined to a single thread, such as one used by a worker thread, can avoid that with thread_safe=false.
+     *
      * @param cmp The comparison function for comparing Node values.
+     * @param thread_safe If false then this Skip List will not lock the global mutex.
      */
-    HeadNode(Compare cmp=Compare()) : _count(0), _compare(cmp) {
+    HeadNode(Compare cmp=Compare(), bool thread_safe=true) : _count(0), _total(), _compare(cmp), _max_spare_nodes(0),
+                                                              _thread_safe(thread_safe) {
 #ifdef INCLUDE_METHODS_THAT_USE_STREAMS
         _dot_file_subgraph = 0;
 #endif
@@ -101,18 +128,72 @@ public:
     // This is useful for rolling median on even length lists where
     // the caller might want to implement the mean of two values.
     void at(size_t index, size_t count, std::vector<T> &dest) const;
+    // Returns the first, smallest, value in O(1).
+    // Will throw an OrderedStructs::SkipList::IndexError if empty.
+    const T &front() const;
     // Computes index of the first occurrence of a value
     // Will throw a ValueError if the value does not exist in the skip list
     size_t index(const T& value) const;
+    // The largest value <= value, empty if there is none.
+    std::optional<T> floor(const T &value) const;
+    // The smallest value >= value, empty if there is none.
+    std::optional<T> ceiling(const T &value) const;
+    // The value closest to value, the smaller if two are equally close, empty if the skip list is empty.
+    // This needs T to support subtraction.
+    std::optional<T> nearest(const T &value) const;
     // Number of values in the skip list.
     size_t size() const;
+    // Augmentation accumulated over all the values in the skip list.
+    Augment total() const;
+    // Augmentation accumulated over the first count values.
+    // Will throw an OrderedStructs::SkipList::IndexError if count > size().
+    Augment prefix(size_t count) const;
+    // Augmentation accumulated over count values starting at index.
+    // Will throw an OrderedStructs::SkipList::IndexError if index + count > size().
+    Augment range(size_t index, size_t count) const;
+    // Augmentation accumulated over all the values that are less than the given value.
+    Augment prefix_value(const T &value) const;
+    // Returns the first value where the cumulative weight reaches the given weight.
+    // This requires an Augment with a weight such as WeightAugment.
+    // Will throw an OrderedStructs::SkipList::IndexError if weight exceeds the total weight.
+    const T &at_weight(double weight) const;
     // Non-const methods
     //
     // Insert a value.
     void insert(const T &value);
+    // Insert a value and return the index where it landed, this costs no more than insert().
+    size_t insert_with_rank(const T &value);
     // Remove a value and return it.
     // Will throw a ValueError is value not present.
     T remove(const T &value);
+    // Remove the value at the index and return it, this is O(log(n)).
+    // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+    T remove_at(size_t index);
+    // Remove the first value and return it.
+    // Will throw an OrderedStructs::SkipList::IndexError if empty.
+    T pop_front();
+    // Remove the last value and return it.
+    // Will throw an OrderedStructs::SkipList::IndexError if empty.
+    T pop_back();
+    // Remove the values from index begin up to, but not including, index end. This is O(log(n) + end - begin).
+    // Will throw an OrderedStructs::SkipList::IndexError if begin > end or end > size().
+    void remove_range(size_t begin, size_t end);
+    // Keep up to max_spare_nodes removed Nodes for reuse by insert().
+    // This is useful where there is a steady state of insert()/remove() such as a rolling median.
+    void set_node_reuse(size_t max_spare_nodes);
+    // Create a copy of the skip list in O(n), the copy has the same structure so needs no comparisons.
+    std::unique_ptr<HeadNode> clone() const;
+    // Keep the values before index and return the rest in a new skip list, this is O(log(n)).
+    // Will throw an OrderedStructs::SkipList::IndexError if index > size().
+    std::unique_ptr<HeadNode> split_at_index(size_t index);
+    // Keep the values less than value and return the rest in a new skip list, this is O(log(n)).
+    std::unique_ptr<HeadNode> split_at_value(const T &value);
+    // Append all the values of other, none of which may be less than the values in this, and leave other empty.
+    // This is O(log(n)). Will throw a ValueError if the ranges of values overlap.
+    void join(HeadNode &other);
+    // Merge all the values of other into this and leave other empty, the ranges of values may overlap, values from other
+    // go after equal values in this. This is O(n + m).
+    void merge(HeadNode &other);
     
     // Const methods that are mostly used for debugging and visualisation.
     //
@@ -138,8 +219,18 @@ public:
     virtual ~HeadNode();
     
 protected:
-    void _adjRemoveRefs(size_t level, Node<T, Compare> *pNode);
-    const Node<T, Compare> *_nodeAt(size_t idx) const;
+    void _adjRemoveRefs(size_t level, Node<T, Compare, Augment> *pNode);
+    const Node<T, Compare, Augment> *_nodeAt(size_t idx) const;
+    Node<T, Compare, Augment> *_newNode(const T &value);
+    void _freeNode(Node<T, Compare, Augment> *pNode);
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> _lock() const;
+#endif
+    Augment _prefix(size_t count) const;
+    template <typename Advance>
+    std::unique_ptr<HeadNode> _split(Advance advance);
+    const Node<T, Compare, Augment> *_floorNode(const T &value) const;
+    Node<T, Compare, Augment> *_unlinkRange(size_t index, size_t count);
     
 protected:
     // Standardised way of throwing a ValueError
@@ -153,10 +244,18 @@ protected:
 protected:
     /// Number of nodes in the list.
     size_t _count;
+    /// Augmentation accumulated over all the nodes in the list.
+    [[no_unique_address]] Augment _total;
     /// My node references, the size of this is the largest height in the list
-    SwappableNodeRefStack<T, Compare> _nodeRefs;
+    SwappableNodeRefStack<T, Compare, Augment> _nodeRefs;
     /// Comparison function.
     Compare _compare;
+    /// Removed Nodes that are available for reuse by insert().
+    std::vector<Node<T, Compare, Augment>*> _spare_nodes;
+    /// Maximum number of removed Nodes to keep for reuse, zero means none.
+    size_t _max_spare_nodes;
+    /// If false then this is confined to a single thread and the global mutex is not used.
+    bool _thread_safe;
 #ifdef INCLUDE_METHODS_THAT_USE_STREAMS
     /// Used to count how many sub-graphs have been plotted
     mutable size_t _dot_file_subgraph;
@@ -178,19 +277,20 @@ private:
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param value Value to check if it is in the Skip List.
  * @return true if in the Skip List.
  */
-template <typename T, typename Compare>
-bool HeadNode<T, Compare>::has(const T &value) const {
+template <typename T, typename Compare, typename Augment>
+bool HeadNode<T, Compare, Augment>::has(const T &value) const {
     _throwIfValueDoesNotCompare(value);
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     for (size_t l = _nodeRefs.height(); l-- > 0;) {
         assert(_nodeRefs[l].pNode);
-        if (_nodeRefs[l].pNode->has(value)) {
-            return true;
+        if (!_compare(value, _nodeRefs[l].pNode->value())) {
+            return _nodeRefs[l].pNode->has(value);
         }
     }
     return false;
@@ -206,15 +306,16 @@ bool HeadNode<T, Compare>::has(const T &value) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param index The index.
  * @return The value at that index.
  */
-template <typename T, typename Compare>
-const T &HeadNode<T, Compare>::at(size_t index) const {
+template <typename T, typename Compare, typename Augment>
+const T &HeadNode<T, Compare, Augment>::at(size_t index) const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
-    const Node<T, Compare> *pNode = _nodeAt(index);
+    const Node<T, Compare, Augment> *pNode = _nodeAt(index);
     assert(pNode);
     return pNode->value();
 }
@@ -229,18 +330,19 @@ const T &HeadNode<T, Compare>::at(size_t index) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param index The index.
  * @param count The number of values to retrieve.
  * @param dest The vector of values
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::at(size_t index, size_t count,
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::at(size_t index, size_t count,
                                std::vector<T> &dest) const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     dest.clear();
-    const Node<T, Compare> *pNode = _nodeAt(index);
+    const Node<T, Compare, Augment> *pNode = _nodeAt(index);
     // _nodeAt will (should) throw an IndexError so this
     // assert should always be true
     assert(pNode);
@@ -254,6 +356,28 @@ void HeadNode<T, Compare>::at(size_t index, size_t count,
     }
 }
 
+/**
+ * Returns the first, smallest, value. This is the Node at my level 0 reference so, unlike <tt>at(0)</tt>, there is no
+ * descent.
+ * Will throw a OrderedStructs::SkipList::IndexError if the Skip List is empty.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @return The first value.
+ */
+template <typename T, typename Compare, typename Augment>
+const T &HeadNode<T, Compare, Augment>::front() const {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (! _count) {
+        _throw_exceeds_size(_count);
+    }
+    assert(_nodeRefs.height() && _nodeRefs[0].pNode);
+    return _nodeRefs[0].pNode->value();
+}
+
 /**
  * Computes index of the first occurrence of a value
  * Will throw a OrderedStructs::SkipList::ValueError if the value does not exist in the skip list
@@ -261,23 +385,28 @@ void HeadNode<T, Compare>::at(size_t index, size_t count,
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param value The value to search for.
  * @return
  */
-template <typename T, typename Compare>
-size_t HeadNode<T, Compare>::index(const T& value) const {
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::index(const T& value) const {
     _throwIfValueDoesNotCompare(value);
     size_t idx;
     
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     for (size_t l = _nodeRefs.height(); l-- > 0;) {
         assert(_nodeRefs[l].pNode);
-        if (_nodeRefs[l].pNode->index(value, idx, l)) {
-            idx += _nodeRefs[l].width;
-            assert(idx > 0);
-            return idx - 1;
+        // Effectively: if (l == 0 || _nodeRefs[l].pNode->value() < value) {
+        if (l == 0 || _compare(_nodeRefs[l].pNode->value(), value)) {
+            if (_nodeRefs[l].pNode->index(value, idx, l)) {
+                idx += _nodeRefs[l].width;
+                assert(idx > 0);
+                return idx - 1;
+            }
+            break;
         }
     }
     _throwValueErrorNotFound(value);
@@ -289,17 +418,246 @@ size_t HeadNode<T, Compare>::index(const T& value) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return The number of values in the Skip List.
  */
-template <typename T, typename Compare>
-size_t HeadNode<T, Compare>::size() const {
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::size() const {
     return _count;
 }
 
-template <typename T, typename Compare>
-size_t HeadNode<T, Compare>::height() const {
+/**
+ * Return the augmentation accumulated over all the values in the Skip List.
+ * For example with a SumAugment this is the sum of all the values.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @return The accumulated augmentation.
+ */
+template <typename T, typename Compare, typename Augment>
+Augment HeadNode<T, Compare, Augment>::total() const {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    return _total;
+}
+
+/**
+ * Return the augmentation accumulated over the first count values in the Skip List.
+ * For example with a SumAugment <tt>prefix(3)</tt> is the sum of <tt>at(0)</tt>, <tt>at(1)</tt> and <tt>at(2)</tt>.
+ * This is O(log(n)).
+ *
+ * Will throw an OrderedStructs::SkipList::IndexError if count is greater than size().
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param count The number of values to accumulate.
+ * @return The accumulated augmentation.
+ */
+template <typename T, typename Compare, typename Augment>
+Augment HeadNode<T, Compare, Augment>::prefix(size_t count) const {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    return _prefix(count);
+}
+
+/**
+ * Return the augmentation accumulated over count values in the Skip List starting at index.
+ * This is O(log(n)).
+ *
+ * Will throw an OrderedStructs::SkipList::IndexError if index + count is greater than size().
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param index The index of the first value.
+ * @param count The number of values to accumulate.
+ * @return The accumulated augmentation.
+ */
+template <typename T, typename Compare, typename Augment>
+Augment HeadNode<T, Compare, Augment>::range(size_t index, size_t count) const {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    Augment result = _prefix(index + count);
+    result -= _prefix(index);
+    return result;
+}
+
+/**
+ * Return the augmentation accumulated over all the values in the Skip List that are less than the given value.
+ * This is O(log(n)).
+ *
+ * Will throw a OrderedStructs::SkipList::FailedComparison if the value is not comparable.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value to compare with.
+ * @return The accumulated augmentation.
+ */
+template <typename T, typename Compare, typename Augment>
+Augment HeadNode<T, Compare, Augment>::prefix_value(const T &value) const {
+    _throwIfValueDoesNotCompare(value);
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    Augment result;
+    const SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    for (size_t l = _nodeRefs.height(); l-- > 0;) {
+        // Effectively: while (pNode && pNode->value() < value)
+        while ((*pRefs)[l].pNode && _compare((*pRefs)[l].pNode->value(), value)) {
+            result += (*pRefs)[l].aug;
+            pRefs = &(*pRefs)[l].pNode->nodeRefs();
+        }
+    }
+    return result;
+}
+
+/**
+ * Return the largest value that is less than or equal to the given value, by the comparison function, from a single
+ * descent. If there are equal values this is the last of them.
+ * This is O(log(n)).
+ *
+ * Will throw a OrderedStructs::SkipList::FailedComparison if the value is not comparable.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value to compare with.
+ * @return A copy of the value or empty if all the values are greater than value.
+ */
+template <typename T, typename Compare, typename Augment>
+std::optional<T> HeadNode<T, Compare, Augment>::floor(const T &value) const {
+    _throwIfValueDoesNotCompare(value);
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    const Node<T, Compare, Augment> *pFloor = _floorNode(value);
+    if (pFloor) {
+        return pFloor->value();
+    }
+    return std::nullopt;
+}
+
+/**
+ * Return the smallest value that is greater than or equal to the given value, by the comparison function, from a
+ * single descent. If there are equal values this is the first of them.
+ * This is O(log(n)).
+ *
+ * Will throw a OrderedStructs::SkipList::FailedComparison if the value is not comparable.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value to compare with.
+ * @return A copy of the value or empty if all the values are less than value.
+ */
+template <typename T, typename Compare, typename Augment>
+std::optional<T> HeadNode<T, Compare, Augment>::ceiling(const T &value) const {
+    _throwIfValueDoesNotCompare(value);
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    const SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    for (size_t l = _nodeRefs.height(); l-- > 0;) {
+        // Effectively: while (pNode && pNode->value() < value)
+        while ((*pRefs)[l].pNode && _compare((*pRefs)[l].pNode->value(), value)) {
+            pRefs = &(*pRefs)[l].pNode->nodeRefs();
+        }
+    }
+    if (pRefs->height() && (*pRefs)[0].pNode) {
+        return (*pRefs)[0].pNode->value();
+    }
+    return std::nullopt;
+}
+
+/**
+ * Return the value closest to the given value from a single descent. This finds the floor then the Node after it is
+ * the ceiling unless the floor is equal to the value. The distances are compared by subtraction, for integers this is
+ * done unsigned so it does not overflow. If two values are equally close the first, by the comparison function, is
+ * returned.
+ * This is O(log(n)).
+ *
+ * Will throw a OrderedStructs::SkipList::FailedComparison if the value is not comparable.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value to compare with.
+ * @return A copy of the closest value or empty if the Skip List is empty.
+ */
+template <typename T, typename Compare, typename Augment>
+std::optional<T> HeadNode<T, Compare, Augment>::nearest(const T &value) const {
+    _throwIfValueDoesNotCompare(value);
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    const Node<T, Compare, Augment> *pFloor = _floorNode(value);
+    const Node<T, Compare, Augment> *pCeiling = nullptr;
+    if (pFloor) {
+        if (! _compare(pFloor->value(), value)) {
+            // Equal.
+            return pFloor->value();
+        }
+        pCeiling = pFloor->next();
+    } else if (_nodeRefs.height()) {
+        pCeiling = _nodeRefs[0].pNode;
+    }
+    if (! pFloor && ! pCeiling) {
+        return std::nullopt;
+    }
+    if (! pCeiling) {
+        return pFloor->value();
+    }
+    if (! pFloor) {
+        return pCeiling->value();
+    }
+    auto distance = [](const T &a, const T &b) {
+        if constexpr (std::is_integral<T>::value) {
+            typedef typename std::make_unsigned<T>::type U;
+            return a < b ? static_cast<U>(static_cast<U>(b) - static_cast<U>(a))
+                         : static_cast<U>(static_cast<U>(a) - static_cast<U>(b));
+        } else {
+            return a < b ? b - a : a - b;
+        }
+    };
+    if (distance(value, pCeiling->value()) < distance(pFloor->value(), value)) {
+        return pCeiling->value();
+    }
+    return pFloor->value();
+}
+
+/**
+ * Return the last Node with a value less than or equal to the given value, the mutex must be held.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value to compare with.
+ * @return The Node or nullptr if all the values are greater than value.
+ */
+template <typename T, typename Compare, typename Augment>
+const Node<T, Compare, Augment> *HeadNode<T, Compare, Augment>::_floorNode(const T &value) const {
+    const Node<T, Compare, Augment> *pFloor = nullptr;
+    const SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    for (size_t l = _nodeRefs.height(); l-- > 0;) {
+        // Effectively: while (pNode && pNode->value() <= value)
+        while ((*pRefs)[l].pNode && ! _compare(value, (*pRefs)[l].pNode->value())) {
+            pFloor = (*pRefs)[l].pNode;
+            pRefs = &pFloor->nodeRefs();
+        }
+    }
+    return pFloor;
+}
+
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::height() const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     size_t val = _nodeRefs.height();
     return val;
@@ -312,15 +670,16 @@ size_t HeadNode<T, Compare>::height() const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param idx The index of the Skip List node.
  * @return The number of linked lists that the node at the index has.
  */
-template <typename T, typename Compare>
-size_t HeadNode<T, Compare>::height(size_t idx) const {
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::height(size_t idx) const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
-    const Node<T, Compare> *pNode = _nodeAt(idx);
+    const Node<T, Compare, Augment> *pNode = _nodeAt(idx);
     assert(pNode);
     return pNode->height();
 }
@@ -331,17 +690,18 @@ size_t HeadNode<T, Compare>::height(size_t idx) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param idx The index.
  * @param level The level.
  * @return Width of Node.
  */
-template <typename T, typename Compare>
-size_t HeadNode<T, Compare>::width(size_t idx, size_t level) const {
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::width(size_t idx, size_t level) const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     // Will throw if out of range.
-    const Node<T, Compare> *pNode = _nodeAt(idx);
+    const Node<T, Compare, Augment> *pNode = _nodeAt(idx);
     assert(pNode);
     if (level >= pNode->height()) {
         _throw_exceeds_size(pNode->height());
@@ -355,16 +715,17 @@ size_t HeadNode<T, Compare>::width(size_t idx, size_t level) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param idx The index.
  * @return The Node.
  */
-template <typename T, typename Compare>
-const Node<T, Compare> *HeadNode<T, Compare>::_nodeAt(size_t idx) const {
+template <typename T, typename Compare, typename Augment>
+const Node<T, Compare, Augment> *HeadNode<T, Compare, Augment>::_nodeAt(size_t idx) const {
     if (idx < _count) {
         for (size_t l = _nodeRefs.height(); l-- > 0;) {
             if (_nodeRefs[l].pNode && _nodeRefs[l].width <= idx + 1) {
                 size_t new_index = idx + 1 - _nodeRefs[l].width;
-                const Node<T, Compare> *pNode = _nodeRefs[l].pNode->at(new_index);
+                const Node<T, Compare, Augment> *pNode = _nodeRefs[l].pNode->at(new_index);
                 if (pNode) {
                     return pNode;
                 }
@@ -377,6 +738,74 @@ const Node<T, Compare> *HeadNode<T, Compare>::_nodeAt(size_t idx) const {
     return NULL;
 }
 
+/**
+ * Returns the first value where the cumulative weight, including that value, reaches the given weight.
+ * For example the weighted median is <tt>at_weight(total().weight.value() / 2)</tt>.
+ * This is O(log(n)).
+ *
+ * This requires an Augment with a <tt>weight</tt> member that is a CompensatedSum such as WeightAugment.
+ * The weights must all be non-negative.
+ *
+ * Will throw an OrderedStructs::SkipList::IndexError if the weight is greater than the total weight.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param weight The cumulative weight.
+ * @return The value.
+ */
+template <typename T, typename Compare, typename Augment>
+const T &HeadNode<T, Compare, Augment>::at_weight(double weight) const {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    CompensatedSum cumulative;
+    const SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    for (size_t l = _nodeRefs.height(); l-- > 0;) {
+        while ((*pRefs)[l].pNode) {
+            CompensatedSum next = cumulative;
+            next += (*pRefs)[l].aug.weight;
+            if (next.value() >= weight) {
+                break;
+            }
+            cumulative = next;
+            pRefs = &(*pRefs)[l].pNode->nodeRefs();
+        }
+    }
+    if (_nodeRefs.height() == 0 || ! (*pRefs)[0].pNode) {
+        _throw_exceeds_size(_count);
+    }
+    return (*pRefs)[0].pNode->value();
+}
+
+/**
+ * Accumulate the augmentation over the first count values.
+ * Will throw an IndexError if count is greater than the number of values.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param count The number of values.
+ * @return The accumulated augmentation.
+ */
+template <typename T, typename Compare, typename Augment>
+Augment HeadNode<T, Compare, Augment>::_prefix(size_t count) const {
+    if (count > _count) {
+        _throw_exceeds_size(_count);
+    }
+    Augment result;
+    const SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    for (size_t l = _nodeRefs.height(); l-- > 0;) {
+        while ((*pRefs)[l].pNode && (*pRefs)[l].width <= count) {
+            count -= (*pRefs)[l].width;
+            result += (*pRefs)[l].aug;
+            pRefs = &(*pRefs)[l].pNode->nodeRefs();
+        }
+    }
+    assert(count == 0);
+    return result;
+}
+
 #pragma mark class HeadNode public non-const methods
 
 /**
@@ -384,37 +813,69 @@ const Node<T, Compare> *HeadNode<T, Compare>::_nodeAt(size_t idx) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param value
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::insert(const T &value) {
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::insert(const T &value) {
+    insert_with_rank(value);
+}
+
+/**
+ * Insert a value and return the index where it landed.
+ * A duplicate value is inserted after the last same value so this is one more than the index of that value.
+ * The index is the sum of the widths along the search path of the insert so, unlike insert() followed by index(), this
+ * is a single descent.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value
+ * @return The index of the inserted value.
+ */
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::insert_with_rank(const T &value) {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #ifdef SKIPLIST_THREAD_SUPPORT_TRACE
     std::cout << "HeadNode insert(" << value << ") thread: " << std::this_thread::get_id() << std::endl;
 #endif
 #endif
-    Node<T, Compare> *pNode = nullptr;
+    Node<T, Compare, Augment> *pNode = nullptr;
     size_t level = _nodeRefs.height();
+    // The HeadNode is at position 0 and the Node at index i is at position i + 1.
+    size_t distance = 0;
     
     _throwIfValueDoesNotCompare(value);
-    while (level-- > 0) {
-        assert(_nodeRefs[level].pNode);
-        pNode = _nodeRefs[level].pNode->insert(value);
-        if (pNode) {
-            break;
+    Node<T, Compare, Augment> *pNewNode = _newNode(value);
+    try {
+        while (level-- > 0) {
+            assert(_nodeRefs[level].pNode);
+            pNode = _nodeRefs[level].pNode->insert(pNewNode, distance);
+            if (pNode) {
+                // Position of the new Node, my references have not yet been adjusted for it.
+                distance += _nodeRefs[level].width;
+                break;
+            }
         }
+    } catch (...) {
+        // A comparison has thrown, for example a Python object that can not be ordered. This can only happen during
+        // the search, before the new Node has been linked in, so it can be given back.
+        _freeNode(pNewNode);
+        throw;
     }
     if (! pNode) {
-        pNode = new Node<T, Compare>(value, _compare);
+        pNode = pNewNode;
         level = 0;
+        distance = 1;
     }
     assert(pNode);
-    SwappableNodeRefStack<T, Compare> &thatRefs = pNode->nodeRefs();
+    const Augment aug_value(value);
+    SwappableNodeRefStack<T, Compare, Augment> &thatRefs = pNode->nodeRefs();
     if (thatRefs.canSwap()) {
         // Expand this to that
         while (_nodeRefs.height() < thatRefs.height()) {
-            _nodeRefs.push_back(nullptr, _count + 1);
+            _nodeRefs.push_back(nullptr, _count + 1, _total);
         }
         if (level < thatRefs.swapLevel()) {
             // Happens when we were originally, say 3 high (max height of any
@@ -423,6 +884,7 @@ void HeadNode<T, Compare>::insert(const T &value) {
             // thatRefs.swapLevel() will be 3
             assert(level + 1 == thatRefs.swapLevel());
             thatRefs[thatRefs.swapLevel()].width += _nodeRefs[level].width;
+            thatRefs[thatRefs.swapLevel()].aug += _nodeRefs[level].aug;
             ++level;
         }
         // Now swap
@@ -430,10 +892,13 @@ void HeadNode<T, Compare>::insert(const T &value) {
             assert(thatRefs.canSwap());
             assert(level == thatRefs.swapLevel());
             _nodeRefs[level].width -= thatRefs[level].width - 1;
+            _nodeRefs[level].aug -= thatRefs[level].aug;
+            _nodeRefs[level].aug += aug_value;
             thatRefs.swap(_nodeRefs);
             if (thatRefs.canSwap()) {
                 assert(thatRefs[thatRefs.swapLevel()].width == 0);
                 thatRefs[thatRefs.swapLevel()].width = _nodeRefs[level].width;
+                thatRefs[thatRefs.swapLevel()].aug = _nodeRefs[level].aug;
             }
             ++level;
         }
@@ -452,14 +917,17 @@ void HeadNode<T, Compare>::insert(const T &value) {
     // Increment my widths as my references are now going over the top of
     // pNode.
     while (level < _nodeRefs.height() && level >= thatRefs.height()) {
+        _nodeRefs[level].aug += aug_value;
         _nodeRefs[level++].width += 1;
     }
     ++_count;
+    _total += aug_value;
 #ifdef SKIPLIST_THREAD_SUPPORT
 #ifdef SKIPLIST_THREAD_SUPPORT_TRACE
     std::cout << "HeadNode insert(" << value << ") thread: " << std::this_thread::get_id() << " DONE" << std::endl;
 #endif
 #endif
+    return distance - 1;
 }
 
 /**
@@ -467,14 +935,16 @@ void HeadNode<T, Compare>::insert(const T &value) {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param level Current level.
  * @param pNode Node to swap references with.
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::_adjRemoveRefs(size_t level,
-                                           Node<T, Compare> *pNode) {
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::_adjRemoveRefs(size_t level,
+                                           Node<T, Compare, Augment> *pNode) {
     assert(pNode);
-    SwappableNodeRefStack<T, Compare> &thatRefs = pNode->nodeRefs();
+    SwappableNodeRefStack<T, Compare, Augment> &thatRefs = pNode->nodeRefs();
+    const Augment aug_value(pNode->value());
     
     // Swap all remaining levels
     // This assertion checks that if swapping can take place we must be at the
@@ -484,6 +954,8 @@ void HeadNode<T, Compare>::_adjRemoveRefs(size_t level,
         assert(level == thatRefs.swapLevel());
         // Compute the new width for the new node
         thatRefs[level].width += _nodeRefs[level].width - 1;
+        thatRefs[level].aug += _nodeRefs[level].aug;
+        thatRefs[level].aug -= aug_value;
         thatRefs.swap(_nodeRefs);
         ++level;
         if (! thatRefs.canSwap()) {
@@ -494,6 +966,7 @@ void HeadNode<T, Compare>::_adjRemoveRefs(size_t level,
     // Decrement my widths as my references are now going over the top of
     // pNode.
     while (level < _nodeRefs.height()) {
+        _nodeRefs[level].aug -= aug_value;
         _nodeRefs[level++].width -= 1;
     }
     // Decrement my stack while top has a NULL pointer.
@@ -508,18 +981,19 @@ void HeadNode<T, Compare>::_adjRemoveRefs(size_t level,
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param value The value in the Node to remove.
  * @return The value removed.
  */
-template <typename T, typename Compare>
-T HeadNode<T, Compare>::remove(const T &value) {
+template <typename T, typename Compare, typename Augment>
+T HeadNode<T, Compare, Augment>::remove(const T &value) {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #ifdef SKIPLIST_THREAD_SUPPORT_TRACE
     std::cout << "HeadNode remove() thread: " << std::this_thread::get_id() << std::endl;
 #endif
 #endif
-    Node<T, Compare> *pNode = nullptr;
+    Node<T, Compare, Augment> *pNode = nullptr;
     size_t level;
 
     _throwIfValueDoesNotCompare(value);
@@ -536,23 +1010,589 @@ T HeadNode<T, Compare>::remove(const T &value) {
     // Take swap level as some swaps will have been dealt with by the remove() above.
     _adjRemoveRefs(pNode->nodeRefs().swapLevel(), pNode);
     --_count;
+    if (_count) {
+        _total -= Augment(pNode->value());
+    } else {
+        // Start afresh rather than carry any residual rounding error.
+        _total = Augment();
+    }
     T ret_val = pNode->value();
-    delete pNode;
+    _freeNode(pNode);
 #ifdef SKIPLIST_THREAD_SUPPORT_TRACE
     std::cout << "HeadNode remove() thread: " << std::this_thread::get_id() << " DONE" << std::endl;
 #endif
     return ret_val;
 }
 
+/**
+ * Remove the value at the index and return it. Unlike <tt>remove(at(index))</tt> this is a single descent by width
+ * and, with duplicate values, removes exactly the Node at that index.
+ * Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param index The index of the value to remove.
+ * @return The value removed.
+ */
+template <typename T, typename Compare, typename Augment>
+T HeadNode<T, Compare, Augment>::remove_at(size_t index) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (index >= _count) {
+        _throw_exceeds_size(_count);
+    }
+    Node<T, Compare, Augment> *pNode = _unlinkRange(index, 1);
+    T ret_val = pNode->value();
+    _freeNode(pNode);
+    return ret_val;
+}
+
+/**
+ * Remove the first, smallest, value and return it.
+ * Will throw an OrderedStructs::SkipList::IndexError if the Skip List is empty.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @return The value removed.
+ */
+template <typename T, typename Compare, typename Augment>
+T HeadNode<T, Compare, Augment>::pop_front() {
+    return remove_at(0);
+}
+
+/**
+ * Remove the last, largest, value and return it.
+ * Will throw an OrderedStructs::SkipList::IndexError if the Skip List is empty.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @return The value removed.
+ */
+template <typename T, typename Compare, typename Augment>
+T HeadNode<T, Compare, Augment>::pop_back() {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (! _count) {
+        _throw_exceeds_size(_count);
+    }
+    Node<T, Compare, Augment> *pNode = _unlinkRange(_count - 1, 1);
+    T ret_val = pNode->value();
+    _freeNode(pNode);
+    return ret_val;
+}
+
+/**
+ * Remove the values from index begin up to, but not including, index end.
+ * This is a single descent by width to the first value then the removed Nodes are unlinked at every level, this is
+ * O(log(n) + end - begin).
+ * Will throw an OrderedStructs::SkipList::IndexError if begin > end or end > size().
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param begin The index of the first value to remove.
+ * @param end The index after the last value to remove.
+ */
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::remove_range(size_t begin, size_t end) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (begin > end || end > _count) {
+        _throw_exceeds_size(_count);
+    }
+    if (begin == end) {
+        return;
+    }
+    Node<T, Compare, Augment> *pNode = _unlinkRange(begin, end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        Node<T, Compare, Augment> *pNext = pNode->nodeRefs()[0].pNode;
+        _freeNode(pNode);
+        pNode = pNext;
+    }
+}
+
+/**
+ * Keep up to max_spare_nodes removed Nodes so that a subsequent insert() can reuse them rather than allocating a
+ * new Node. This is worthwhile where there is a steady state of insert()/remove() pairs such as a rolling median
+ * where one spare Node is sufficient.
+ *
+ * If max_spare_nodes is less than the current number of spare Nodes the excess are deleted.
+ * The default is zero so that removed Nodes are always deleted.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param max_spare_nodes The maximum number of removed Nodes to keep.
+ */
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::set_node_reuse(size_t max_spare_nodes) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    _max_spare_nodes = max_spare_nodes;
+    while (_spare_nodes.size() > _max_spare_nodes) {
+        delete _spare_nodes.back();
+        _spare_nodes.pop_back();
+    }
+    _spare_nodes.reserve(_max_spare_nodes);
+}
+
+/**
+ * Create a copy of this Skip List in one pass along level 0.
+ * Each copied Node has the same height, widths and augmentation as the original so no coins are tossed and no values
+ * are compared. The copy has the same comparison function, thread safety and Node reuse limit but no spare Nodes.
+ *
+ * This is O(n) whereas inserting every value into a new Skip List is O(n log(n)).
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @return The copy.
+ */
+template <typename T, typename Compare, typename Augment>
+std::unique_ptr<HeadNode<T, Compare, Augment>> HeadNode<T, Compare, Augment>::clone() const {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    // Not thread safe until complete so that if copying a value throws the destructor does not lock the mutex again.
+    std::unique_ptr<HeadNode<T, Compare, Augment>> result(new HeadNode<T, Compare, Augment>(_compare, false));
+    result->_nodeRefs.assign(_nodeRefs);
+    // At each level the references that are waiting to be linked to the next Node of that height.
+    std::vector<SwappableNodeRefStack<T, Compare, Augment> *> pending(_nodeRefs.height(), &result->_nodeRefs);
+    const Node<T, Compare, Augment> *pNode = _nodeRefs.height() ? _nodeRefs[0].pNode : nullptr;
+    while (pNode) {
+        Node<T, Compare, Augment> *pCopy = new Node<T, Compare, Augment>(pNode->value(), _compare, pNode->nodeRefs());
+        for (size_t level = 0; level < pCopy->height(); ++level) {
+            (*pending[level])[level].pNode = pCopy;
+            pending[level] = &pCopy->nodeRefs();
+        }
+        ++result->_count;
+        pNode = pNode->next();
+    }
+    assert(result->_count == _count);
+    result->_total = _total;
+    result->_max_spare_nodes = _max_spare_nodes;
+    result->_thread_safe = _thread_safe;
+    return result;
+}
+
+/**
+ * Split the Skip List so that this keeps the first index values and the rest are returned in a new Skip List.
+ * This is O(log(n)), only the references along the search path for the index are cut.
+ * The new Skip List has the same comparison function and thread safety.
+ *
+ * Will throw an OrderedStructs::SkipList::IndexError if index > size().
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param index The index of the first value to move to the new Skip List.
+ * @return The new Skip List with the values from index onwards.
+ */
+template <typename T, typename Compare, typename Augment>
+std::unique_ptr<HeadNode<T, Compare, Augment>> HeadNode<T, Compare, Augment>::split_at_index(size_t index) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (index > _count) {
+        _throw_exceeds_size(_count);
+    }
+    return _split([index](const Node<T, Compare, Augment> */* pNode */, size_t position) {
+        return position <= index;
+    });
+}
+
+/**
+ * Split the Skip List so that this keeps the values less than value and the rest, including any equal to value, are
+ * returned in a new Skip List.
+ * This is O(log(n)), only the references along the search path for the value are cut.
+ * The new Skip List has the same comparison function and thread safety.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value to split at.
+ * @return The new Skip List with the values not less than value.
+ */
+template <typename T, typename Compare, typename Augment>
+std::unique_ptr<HeadNode<T, Compare, Augment>> HeadNode<T, Compare, Augment>::split_at_value(const T &value) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    _throwIfValueDoesNotCompare(value);
+    return _split([this, &value](const Node<T, Compare, Augment> *pNode, size_t /* position */) {
+        return _compare(pNode->value(), value);
+    });
+}
+
+/**
+ * Append all the values of other to this Skip List and leave other empty. None of the values of other may be less than
+ * the values in this Skip List, equal values are allowed.
+ * This is O(log(n)), the references along the right hand edge of this Skip List are linked to the references of the
+ * other HeadNode and their widths extended. The Nodes are moved, not copied.
+ *
+ * Will throw a ValueError if the ranges of values overlap or other is this Skip List.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param other The Skip List to append.
+ */
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::join(HeadNode &other) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (&other == this) {
+        throw ValueError("Can not join a Skip List to itself.");
+    }
+    if (! other._count) {
+        return;
+    }
+    if (_count && _compare(other._nodeRefs[0].pNode->value(), _nodeAt(_count - 1)->value())) {
+        throw ValueError("Can not join Skip Lists where the ranges of values overlap.");
+    }
+    while (_nodeRefs.height() < other._nodeRefs.height()) {
+        _nodeRefs.push_back(nullptr, _count + 1, _total);
+    }
+    // Follow the right hand edge down, at each level the last reference runs to the end so is extended over other.
+    SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    for (size_t level = _nodeRefs.height(); level-- > 0;) {
+        while ((*pRefs)[level].pNode) {
+            pRefs = &(*pRefs)[level].pNode->nodeRefs();
+        }
+        NodeRef<T, Compare, Augment> &ref = (*pRefs)[level];
+        if (level < other._nodeRefs.height()) {
+            ref.pNode = other._nodeRefs[level].pNode;
+            ref.width += other._nodeRefs[level].width - 1;
+            ref.aug += other._nodeRefs[level].aug;
+        } else {
+            ref.width += other._count;
+            ref.aug += other._total;
+        }
+    }
+    _count += other._count;
+    _total += other._total;
+    other._nodeRefs.clear();
+    other._count = 0;
+    other._total = Augment();
+}
+
+/**
+ * Merge all the values of other into this Skip List and leave other empty. The ranges of values may overlap, values
+ * from other are placed after equal values in this, as they would be by insert().
+ *
+ * This is a linear merge of the two level 0 lists followed by one pass that links every level, each Node keeps its
+ * height and the widths and augmentation are rebuilt. The Nodes of other are moved, not copied.
+ * This is O(n + m) rather than the O(m log(n)) of inserting the values of other so it is best where m is not much
+ * smaller than n, for example combining Skip Lists built by different threads.
+ *
+ * Values are only compared whilst finding the merged order so if a comparison throws neither Skip List is changed.
+ * Will throw a ValueError if other is this Skip List.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param other The Skip List to merge.
+ */
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::merge(HeadNode &other) {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    std::unique_lock<std::mutex> lock = _lock();
+#endif
+    if (&other == this) {
+        throw ValueError("Can not merge a Skip List with itself.");
+    }
+    if (! other._count) {
+        return;
+    }
+    std::vector<Node<T, Compare, Augment> *> nodes;
+    nodes.reserve(_count + other._count);
+    Node<T, Compare, Augment> *pThis = _count ? _nodeRefs[0].pNode : nullptr;
+    Node<T, Compare, Augment> *pOther = other._nodeRefs[0].pNode;
+    while (pThis && pOther) {
+        if (_compare(pOther->value(), pThis->value())) {
+            nodes.push_back(pOther);
+            pOther = pOther->nodeRefs()[0].pNode;
+        } else {
+            nodes.push_back(pThis);
+            pThis = pThis->nodeRefs()[0].pNode;
+        }
+    }
+    for (; pThis; pThis = pThis->nodeRefs()[0].pNode) {
+        nodes.push_back(pThis);
+    }
+    for (; pOther; pOther = pOther->nodeRefs()[0].pNode) {
+        nodes.push_back(pOther);
+    }
+    while (_nodeRefs.height() < other._nodeRefs.height()) {
+        _nodeRefs.push_back(nullptr, 0);
+    }
+    // Link the Nodes in order. At each level record the references waiting for the next Node of that height, their
+    // position and the augmentation since then. When a reference is linked its augmentation is added to the span of
+    // the level above, as insert() does.
+    const size_t height = _nodeRefs.height();
+    std::vector<SwappableNodeRefStack<T, Compare, Augment> *> pending(height, &_nodeRefs);
+    std::vector<size_t> positions(height, 0);
+    std::vector<Augment> spans(height);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        SwappableNodeRefStack<T, Compare, Augment> &refs = nodes[i]->nodeRefs();
+        spans[0] += Augment(nodes[i]->value());
+        for (size_t level = 0; level < refs.height(); ++level) {
+            NodeRef<T, Compare, Augment> &ref = (*pending[level])[level];
+            ref.pNode = nodes[i];
+            ref.width = i + 1 - positions[level];
+            ref.aug = spans[level];
+            if (level + 1 < height) {
+                spans[level + 1] += spans[level];
+            }
+            pending[level] = &refs;
+            positions[level] = i + 1;
+            spans[level] = Augment();
+        }
+    }
+    // The last reference at each level runs to the end, it includes the last span of the level below.
+    Augment below;
+    for (size_t level = 0; level < height; ++level) {
+        NodeRef<T, Compare, Augment> &ref = (*pending[level])[level];
+        spans[level] += below;
+        ref.pNode = nullptr;
+        ref.width = nodes.size() + 1 - positions[level];
+        ref.aug = spans[level];
+        below = spans[level];
+    }
+    _count += other._count;
+    _total += other._total;
+    other._nodeRefs.clear();
+    other._count = 0;
+    other._total = Augment();
+}
+
+#pragma mark class HeadNode protected methods
+
+/**
+ * Split the Skip List after the last Node that advance() accepts and return the rest in a new Skip List.
+ * The search records, at each level, the references of the last Node before the split. These are cut, the part that
+ * is after the split becomes the references of the new HeadNode. The positions along the path give the widths and the
+ * accumulated augmentation gives the augmentation of each part.
+ *
+ * The mutex must be held.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @tparam Advance Callable (const Node *pNode, size_t position) -> bool, position is the index of pNode + 1. This must
+ * be true for a prefix of the Nodes.
+ * @param advance Returns true if the Node stays in this Skip List.
+ * @return The new Skip List.
+ */
+template <typename T, typename Compare, typename Augment>
+template <typename Advance>
+std::unique_ptr<HeadNode<T, Compare, Augment>> HeadNode<T, Compare, Augment>::_split(Advance advance) {
+    std::unique_ptr<HeadNode<T, Compare, Augment>> result(new HeadNode<T, Compare, Augment>(_compare, _thread_safe));
+    const size_t height = _nodeRefs.height();
+    // At each level the references of the last Node before the split, its position and the augmentation up to it.
+    std::vector<SwappableNodeRefStack<T, Compare, Augment> *> pred_refs(height);
+    std::vector<size_t> pred_positions(height);
+    std::vector<Augment> pred_prefixes(height);
+    // The HeadNode is at position 0 and the Node at index i is at position i + 1.
+    SwappableNodeRefStack<T, Compare, Augment> *pRefs = &_nodeRefs;
+    size_t position = 0;
+    Augment prefix;
+    for (size_t level = height; level-- > 0;) {
+        while ((*pRefs)[level].pNode && advance((*pRefs)[level].pNode, position + (*pRefs)[level].width)) {
+            position += (*pRefs)[level].width;
+            prefix += (*pRefs)[level].aug;
+            pRefs = &(*pRefs)[level].pNode->nodeRefs();
+        }
+        pred_refs[level] = pRefs;
+        pred_positions[level] = position;
+        pred_prefixes[level] = prefix;
+    }
+    // position is now the number of values that stay and prefix is their augmentation.
+    for (size_t level = 0; level < height; ++level) {
+        NodeRef<T, Compare, Augment> &ref = (*pred_refs[level])[level];
+        Augment before = prefix;
+        before -= pred_prefixes[level];
+        Augment after = ref.aug;
+        after -= before;
+        result->_nodeRefs.push_back(ref.pNode, pred_positions[level] + ref.width - position, after);
+        ref.pNode = nullptr;
+        ref.width = position + 1 - pred_positions[level];
+        ref.aug = before;
+    }
+    result->_count = _count - position;
+    result->_total = _total;
+    result->_total -= prefix;
+    _count = position;
+    _total = prefix;
+    while (_nodeRefs.height() && ! _nodeRefs[_nodeRefs.height() - 1].pNode) {
+        _nodeRefs.pop_back();
+    }
+    while (result->_nodeRefs.height() && ! result->_nodeRefs[result->_nodeRefs.height() - 1].pNode) {
+        result->_nodeRefs.pop_back();
+    }
+    return result;
+}
+
+
+/**
+ * Unlink count Nodes starting at index, these must exist.
+ * This is a single descent by width with two fingers. At each level one finger stops at the last Node before index and
+ * the other at the last Node to be unlinked. The reference of the first is then set to the successor of the second at
+ * that level, its width and augmentation are found from the positions and the augmentation accumulated by the fingers.
+ * The unlinked Nodes themselves are not visited so this is O(log(n)).
+ *
+ * The mutex must be held.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param index The index of the first Node to unlink.
+ * @param count The number of Nodes to unlink, at least one.
+ * @return The first unlinked Node, the rest follow it at level 0. The caller must free them.
+ */
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment> *HeadNode<T, Compare, Augment>::_unlinkRange(size_t index, size_t count) {
+    assert(count && index + count <= _count);
+    const size_t height = _nodeRefs.height();
+    // The relinked reference at each level, the augmentation of the unlinked Nodes is subtracted once it is known.
+    // These are on the stack so that remove_at(), pop_front() and pop_back() do not allocate.
+    NodeRef<T, Compare, Augment> *pred_refs_stack[HEADNODE_STACK_HEIGHT];
+    std::vector<NodeRef<T, Compare, Augment> *> pred_refs_heap;
+    NodeRef<T, Compare, Augment> **pred_refs = pred_refs_stack;
+    if (height > HEADNODE_STACK_HEIGHT) {
+        pred_refs_heap.resize(height);
+        pred_refs = pred_refs_heap.data();
+    }
+    // The HeadNode is at position 0 and the Node at index i is at position i + 1.
+    // So the Nodes to unlink are at positions (index, last].
+    const size_t last = index + count;
+    SwappableNodeRefStack<T, Compare, Augment> *pPredRefs = &_nodeRefs;
+    size_t pred_position = 0;
+    Augment pred_prefix;
+    SwappableNodeRefStack<T, Compare, Augment> *pLastRefs = &_nodeRefs;
+    size_t last_position = 0;
+    Augment last_prefix;
+    Node<T, Compare, Augment> *pFirst = nullptr;
+    for (size_t level = height; level-- > 0;) {
+        while ((*pPredRefs)[level].pNode && pred_position + (*pPredRefs)[level].width <= index) {
+            pred_position += (*pPredRefs)[level].width;
+            pred_prefix += (*pPredRefs)[level].aug;
+            pPredRefs = &(*pPredRefs)[level].pNode->nodeRefs();
+        }
+        if (last_position < pred_position) {
+            pLastRefs = pPredRefs;
+            last_position = pred_position;
+            last_prefix = pred_prefix;
+        }
+        while ((*pLastRefs)[level].pNode && last_position + (*pLastRefs)[level].width <= last) {
+            last_position += (*pLastRefs)[level].width;
+            last_prefix += (*pLastRefs)[level].aug;
+            pLastRefs = &(*pLastRefs)[level].pNode->nodeRefs();
+        }
+        // Copy as this may be the same reference that is relinked.
+        const NodeRef<T, Compare, Augment> succ = (*pLastRefs)[level];
+        NodeRef<T, Compare, Augment> &ref = (*pPredRefs)[level];
+        pFirst = ref.pNode;
+        ref.pNode = succ.pNode;
+        ref.width = last_position + succ.width - pred_position - count;
+        ref.aug = last_prefix;
+        ref.aug += succ.aug;
+        ref.aug -= pred_prefix;
+        pred_refs[level] = &ref;
+    }
+    // pred_prefix and last_prefix are now the augmentation up to index and up to the last unlinked Node.
+    Augment removed = last_prefix;
+    removed -= pred_prefix;
+    for (size_t level = 0; level < height; ++level) {
+        pred_refs[level]->aug -= removed;
+    }
+    _count -= count;
+    if (_count) {
+        _total -= removed;
+    } else {
+        // As remove(), start afresh rather than carry any residual rounding error.
+        _total = Augment();
+    }
+    while (_nodeRefs.height() && ! _nodeRefs[_nodeRefs.height() - 1].pNode) {
+        _nodeRefs.pop_back();
+    }
+    return pFirst;
+}
+
+/**
+ * Create a new Node for insert(), this reuses a spare Node if one is available.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param value The value of the Node.
+ * @return The new Node.
+ */
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment> *HeadNode<T, Compare, Augment>::_newNode(const T &value) {
+    if (_spare_nodes.empty()) {
+        return new Node<T, Compare, Augment>(value, _compare);
+    }
+    Node<T, Compare, Augment> *pNode = _spare_nodes.back();
+    _spare_nodes.pop_back();
+    pNode->reuse(value);
+    return pNode;
+}
+
+/**
+ * Dispose of a Node that has been removed, it is either kept for reuse or deleted.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @param pNode The Node that has been removed.
+ */
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::_freeNode(Node<T, Compare, Augment> *pNode) {
+    if (_spare_nodes.size() < _max_spare_nodes) {
+        _spare_nodes.push_back(pNode);
+    } else {
+        delete pNode;
+    }
+}
+
+#ifdef SKIPLIST_THREAD_SUPPORT
+/**
+ * Lock the global gSkipListMutex unless this Skip List has been constructed with thread_safe=false in which case this
+ * returns a lock that does not own a mutex.
+ *
+ * @tparam T Type of the values in the Skip List.
+ * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
+ * @return The lock, this is released when it goes out of scope.
+ */
+template <typename T, typename Compare, typename Augment>
+std::unique_lock<std::mutex> HeadNode<T, Compare, Augment>::_lock() const {
+    if (_thread_safe) {
+        return std::unique_lock<std::mutex>(gSkipListMutex);
+    }
+    return std::unique_lock<std::mutex>();
+}
+#endif
+
 /**
  * Throw a ValueError in a consistent fashion.
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param value The value to put into the ValueError.
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::_throwValueErrorNotFound(const T &value) const {
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::_throwValueErrorNotFound(const T &value) const {
 #ifdef INCLUDE_METHODS_THAT_USE_STREAMS
     std::ostringstream oss;
     oss << "Value " << value << " not found.";
@@ -572,10 +1612,11 @@ void HeadNode<T, Compare>::_throwValueErrorNotFound(const T &value) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param value
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::_throwIfValueDoesNotCompare(const T &value) const {
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::_throwIfValueDoesNotCompare(const T &value) const {
     if (value != value) {
         throw FailedComparison(
             "Can not work with something that does not compare equal to itself.");
@@ -588,15 +1629,16 @@ void HeadNode<T, Compare>::_throwIfValueDoesNotCompare(const T &value) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityCyclicReferences() const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck HeadNode<T, Compare, Augment>::_lacksIntegrityCyclicReferences() const {
     assert(_nodeRefs.height());
     // Check for cyclic references at each level
     for (size_t level = 0; level < _nodeRefs.height(); ++level) {
-        Node<T, Compare> *p1 = _nodeRefs[level].pNode;
-        Node<T, Compare> *p2 = _nodeRefs[level].pNode;
+        Node<T, Compare, Augment> *p1 = _nodeRefs[level].pNode;
+        Node<T, Compare, Augment> *p2 = _nodeRefs[level].pNode;
         while (p1 && p2) {
             p1 = p1->nodeRefs()[level].pNode;
             if (p2->nodeRefs()[level].pNode) {
@@ -618,14 +1660,15 @@ IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityCyclicReferences() const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityWidthAccumulation() const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck HeadNode<T, Compare, Augment>::_lacksIntegrityWidthAccumulation() const {
     assert(_nodeRefs.height());
     for (size_t level = 1; level < _nodeRefs.height(); ++level) {
-        const Node<T, Compare> *pl = _nodeRefs[level].pNode;
-        const Node<T, Compare> *pl_1 = _nodeRefs[level - 1].pNode;
+        const Node<T, Compare, Augment> *pl = _nodeRefs[level].pNode;
+        const Node<T, Compare, Augment> *pl_1 = _nodeRefs[level - 1].pNode;
         assert(pl && pl_1); // No nulls allowed in HeadNode
         size_t wl = _nodeRefs[level].width;
         size_t wl_1 = _nodeRefs[level - 1].width;
@@ -655,15 +1698,16 @@ IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityWidthAccumulation() const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityNodeReferencesNotInList() const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck HeadNode<T, Compare, Augment>::_lacksIntegrityNodeReferencesNotInList() const {
     assert(_nodeRefs.height());
 
     IntegrityCheck result;
-    std::set<const Node<T, Compare>*> nodeSet;
-    const Node<T, Compare> *pNode = _nodeRefs[0].pNode;
+    std::set<const Node<T, Compare, Augment>*> nodeSet;
+    const Node<T, Compare, Augment> *pNode = _nodeRefs[0].pNode;
     assert(pNode);
     
     // First gather all nodes, slightly awkward code here is so that
@@ -693,15 +1737,16 @@ IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityNodeReferencesNotInList() co
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityOrder() const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck HeadNode<T, Compare, Augment>::_lacksIntegrityOrder() const {
     if (_nodeRefs.height()) {
         // Traverse the lowest level list iteratively deleting as we go
         // Doing this recursivley could be expensive as we are at level 0.
-        const Node<T, Compare> *node = _nodeRefs[0].pNode;
-        const Node<T, Compare> *next;
+        const Node<T, Compare, Augment> *node = _nodeRefs[0].pNode;
+        const Node<T, Compare, Augment> *next;
         while (node) {
             next = node->next();
             if (next && _compare(next->value(), node->value())) {
@@ -719,12 +1764,13 @@ IntegrityCheck HeadNode<T, Compare>::_lacksIntegrityOrder() const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck HeadNode<T, Compare>::lacksIntegrity() const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck HeadNode<T, Compare, Augment>::lacksIntegrity() const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     if (_nodeRefs.height()) {
         IntegrityCheck result = _nodeRefs.lacksIntegrity();
@@ -735,7 +1781,7 @@ IntegrityCheck HeadNode<T, Compare>::lacksIntegrity() const {
             return HEADNODE_CONTAINS_NULL;
         }
         // Check all nodes for integrity
-        const Node<T, Compare> *pNode = _nodeRefs[0].pNode;
+        const Node<T, Compare, Augment> *pNode = _nodeRefs[0].pNode;
         while (pNode) {
             result = pNode->lacksIntegrity(_nodeRefs.height());
             if (result) {
@@ -778,23 +1824,27 @@ IntegrityCheck HeadNode<T, Compare>::lacksIntegrity() const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @return The size of the memory estimate.
  */
-template <typename T, typename Compare>
-size_t HeadNode<T, Compare>::size_of() const {
+template <typename T, typename Compare, typename Augment>
+size_t HeadNode<T, Compare, Augment>::size_of() const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     // sizeof(*this) includes the size of _nodeRefs but _nodeRefs.size_of()
     // includes sizeof(_nodeRefs) so we need to subtract to avoid double counting
     size_t ret_val = sizeof(*this) + _nodeRefs.size_of() - sizeof(_nodeRefs);
     if (_nodeRefs.height()) {
-        const Node<T, Compare> *node = _nodeRefs[0].pNode;
+        const Node<T, Compare, Augment> *node = _nodeRefs[0].pNode;
         while (node) {
             ret_val += node->size_of();
             node = node->next();
         }
     }
+    for (const Node<T, Compare, Augment> *spare: _spare_nodes) {
+        ret_val += spare->size_of();
+    }
     return ret_val;
 }
 
@@ -804,18 +1854,19 @@ size_t HeadNode<T, Compare>::size_of() const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  */
-template <typename T, typename Compare>
-HeadNode<T, Compare>::~HeadNode() {
+template <typename T, typename Compare, typename Augment>
+HeadNode<T, Compare, Augment>::~HeadNode() {
     // Hmm could this deadlock?
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     if (_nodeRefs.height()) {
         // Traverse the lowest level list iteratively deleting as we go
         // Doing this recursivley could be expensive as we are at level 0.
-        const Node<T, Compare> *node = _nodeRefs[0].pNode;
-        const Node<T, Compare> *next;
+        const Node<T, Compare, Augment> *node = _nodeRefs[0].pNode;
+        const Node<T, Compare, Augment> *next;
         while (node) {
             next = node->next();
             delete node;
@@ -824,6 +1875,9 @@ HeadNode<T, Compare>::~HeadNode() {
         }
     }
     assert(_count == 0);
+    for (Node<T, Compare, Augment> *spare: _spare_nodes) {
+        delete spare;
+    }
 }
 
 #ifdef INCLUDE_METHODS_THAT_USE_STREAMS
@@ -833,12 +1887,13 @@ HeadNode<T, Compare>::~HeadNode() {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param os Where to write the DOT file.
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::dotFile(std::ostream &os) const {
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::dotFile(std::ostream &os) const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     if (_dot_file_subgraph == 0) {
         os << "digraph SkipList {" << std::endl;
@@ -883,7 +1938,7 @@ void HeadNode<T, Compare>::dotFile(std::ostream &os) const {
     os << std::endl;
     // Now all nodes via level 0, if non-empty
     if (_nodeRefs.height()) {
-        Node<T, Compare> *pNode = this->_nodeRefs[0].pNode;
+        Node<T, Compare, Augment> *pNode = this->_nodeRefs[0].pNode;
         pNode->dotFile(os, _dot_file_subgraph);
     }
     os << std::endl;
@@ -911,12 +1966,13 @@ void HeadNode<T, Compare>::dotFile(std::ostream &os) const {
  *
  * @tparam T Type of the values in the Skip List.
  * @tparam Compare Compare function.
+ * @tparam Augment Augmentation of the widths.
  * @param os Where to write the DOT file.
  */
-template <typename T, typename Compare>
-void HeadNode<T, Compare>::dotFileFinalise(std::ostream &os) const {
+template <typename T, typename Compare, typename Augment>
+void HeadNode<T, Compare, Augment>::dotFileFinalise(std::ostream &os) const {
 #ifdef SKIPLIST_THREAD_SUPPORT
-    std::lock_guard<std::mutex> lock(gSkipListMutex);
+    std::unique_lock<std::mutex> lock = _lock();
 #endif
     if (_dot_file_subgraph > 0) {
         // Link the nodes together with an invisible node.
@@ -0,0 +1,218 @@
+//
+//  HistogramWindow.h
+//  SkipList
+//
+
+#ifndef SkipList_HistogramWindow_h
+#define SkipList_HistogramWindow_h
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace RollingMedian {
+
+/**
+ * The maximum number of bins in a HistogramWindow, this covers all uint8_t and uint16_t values.
+ */
+        const size_t HISTOGRAM_WINDOW_MAX_BIN_COUNT = 1 << 16;
+
+/**
+ * @brief A counting histogram of integer values with the same insert()/remove()/at() interface as a
+ * SkipList::HeadNode.
+ *
+ * This is for integer data with a small range of values, such as image rows or ADC readings. insert() and remove()
+ * are O(1) as they just increment or decrement a bin count, there are no comparisons and no memory allocation.
+ *
+ * at() keeps a cursor on the last bin found along with the count of values below it. A rolling median only moves the
+ * median by a few bins each step so at() is O(1) amortised. The bins are also counted in blocks so that the cursor can
+ * skip over empty regions of a sparse histogram.
+ *
+ * @tparam T The integral type of the values.
+ */
+        template <typename T>
+        class HistogramWindow {
+            static_assert(std::is_integral<T>::value, "HistogramWindow needs an integral type.");
+        public:
+            /**
+             * Constructor, all the bins are allocated up front.
+             *
+             * @param min_value The smallest value that can be inserted.
+             * @param max_value The largest value that can be inserted.
+             */
+            HistogramWindow(T min_value, T max_value);
+            // Insert a value.
+            // Will throw an OrderedStructs::SkipList::ValueError if the value is out of range.
+            void insert(const T &value);
+            // Remove a value and return it.
+            // Will throw an OrderedStructs::SkipList::ValueError if the value is not present.
+            T remove(const T &value);
+            // Returns the value at the index.
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            T at(size_t index) const;
+            // Find the value at index and write count values to dest.
+            // Will throw an OrderedStructs::SkipList::IndexError if any index out of range.
+            void at(size_t index, size_t count, std::vector<T> &dest) const;
+            // Number of values.
+            size_t size() const {
+                return _size;
+            }
+        protected:
+            /// Number of bins in a block.
+            static const size_t BLOCK_SIZE = 256;
+            // The bin of the value or throw a ValueError if out of range.
+            size_t _bin(const T &value) const;
+            /// The value of the first bin.
+            T _min_value;
+            /// Count of each value.
+            std::vector<size_t> _bins;
+            /// Count of the values in each block of BLOCK_SIZE bins.
+            std::vector<size_t> _blocks;
+            /// Total number of values.
+            size_t _size;
+            /// The bin last found by at().
+            mutable size_t _cursor;
+            /// The number of values in the bins below _cursor.
+            mutable size_t _below;
+        };
+
+/**
+ * Constructor.
+ *
+ * @tparam T The integral type of the values.
+ * @param min_value The smallest value that can be inserted.
+ * @param max_value The largest value that can be inserted, there must be no more than HISTOGRAM_WINDOW_MAX_BIN_COUNT
+ * values in the range.
+ */
+        template <typename T>
+        HistogramWindow<T>::HistogramWindow(T min_value, T max_value) : _min_value(min_value),
+                                                                        _size(0),
+                                                                        _cursor(0),
+                                                                        _below(0) {
+            // Unsigned arithmetic avoids overflow of signed types.
+            uint64_t bin_count = static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value) + 1;
+            if (max_value < min_value || bin_count > HISTOGRAM_WINDOW_MAX_BIN_COUNT) {
+                throw SkipList::ValueError("Histogram range is too large.");
+            }
+            _bins.resize(bin_count);
+            _blocks.resize((bin_count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        }
+
+/**
+ * The bin index of a value.
+ *
+ * @tparam T The integral type of the values.
+ * @param value The value.
+ * @return The bin index.
+ */
+        template <typename T>
+        size_t HistogramWindow<T>::_bin(const T &value) const {
+            uint64_t bin = static_cast<uint64_t>(value) - static_cast<uint64_t>(_min_value);
+            if (value < _min_value || bin >= _bins.size()) {
+                throw SkipList::ValueError("Value out of histogram range.");
+            }
+            return static_cast<size_t>(bin);
+        }
+
+/**
+ * Insert a value.
+ *
+ * @tparam T The integral type of the values.
+ * @param value The value to insert.
+ */
+        template <typename T>
+        void HistogramWindow<T>::insert(const T &value) {
+            size_t bin = _bin(value);
+            ++_bins[bin];
+            ++_blocks[bin / BLOCK_SIZE];
+            ++_size;
+            if (bin < _cursor) {
+                ++_below;
+            }
+        }
+
+/**
+ * Remove a value.
+ *
+ * @tparam T The integral type of the values.
+ * @param value The value to remove.
+ * @return The value removed.
+ */
+        template <typename T>
+        T HistogramWindow<T>::remove(const T &value) {
+            size_t bin = _bin(value);
+            if (_bins[bin] == 0) {
+                throw SkipList::ValueError("Value not found.");
+            }
+            --_bins[bin];
+            --_blocks[bin / BLOCK_SIZE];
+            --_size;
+            if (bin < _cursor) {
+                --_below;
+            }
+            return value;
+        }
+
+/**
+ * Returns the value at a particular index.
+ *
+ * This moves the cursor from the bin last found, skipping whole blocks where possible.
+ *
+ * @tparam T The integral type of the values.
+ * @param index The index.
+ * @return The value at that index.
+ */
+        template <typename T>
+        T HistogramWindow<T>::at(size_t index) const {
+            if (index >= _size) {
+                SkipList::_throw_exceeds_size(_size);
+            }
+            // Move down until the values below the cursor do not include the index.
+            while (_below > index) {
+                if (_cursor % BLOCK_SIZE == 0 && _below - _blocks[_cursor / BLOCK_SIZE - 1] > index) {
+                    _cursor -= BLOCK_SIZE;
+                    _below -= _blocks[_cursor / BLOCK_SIZE];
+                } else {
+                    --_cursor;
+                    _below -= _bins[_cursor];
+                }
+            }
+            // Move up until the cursor bin includes the index.
+            while (_below + _bins[_cursor] <= index) {
+                if (_cursor % BLOCK_SIZE == 0 && _below + _blocks[_cursor / BLOCK_SIZE] <= index) {
+                    _below += _blocks[_cursor / BLOCK_SIZE];
+                    _cursor += BLOCK_SIZE;
+                } else {
+                    _below += _bins[_cursor];
+                    ++_cursor;
+                }
+            }
+            return static_cast<T>(static_cast<uint64_t>(_min_value) + _cursor);
+        }
+
+/**
+ * Find the count number of values starting at index and write them to dest.
+ *
+ * @tparam T The integral type of the values.
+ * @param index The index.
+ * @param count The number of values to retrieve.
+ * @param dest The vector of values.
+ */
+        template <typename T>
+        void HistogramWindow<T>::at(size_t index, size_t count, std::vector<T> &dest) const {
+            if (index + count > _size) {
+                SkipList::_throw_exceeds_size(_size);
+            }
+            dest.clear();
+            for (size_t i = 0; i < count; ++i) {
+                dest.push_back(at(index + i));
+            }
+        }
+
+    } // namespace RollingMedian
+} // namespace OrderedStructs
+
+#endif // SkipList_HistogramWindow_h
@@ -0,0 +1,342 @@
+//
+//  LockFreeSkipList.h
+//  SkipList
+//
+
+#ifndef SkipList_LockFreeSkipList_h
+#define SkipList_LockFreeSkipList_h
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "SkipList.h"
+#include "EpochReclamation.h"
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/// Maximum height of a LockFreeSkipList tower.
+        const size_t LOCK_FREE_SKIPLIST_MAX_HEIGHT = 32;
+
+/**
+ * @brief A lock-free ordered set supporting concurrent has(), insert() and remove().
+ *
+ * Unlike HeadNode this does not use the global mutex and does not maintain the widths so it does not support at() or
+ * index(), it is intended for workloads where many threads insert and probe one shared set.
+ *
+ * Each node is a tower of atomic next pointers where the low bit is a mark meaning the node has been logically removed
+ * at that level. A value is in the set if its node is linked at the bottom level and that level is not marked.
+ * Searches unlink marked nodes as they go. A node is removed by marking its tower from the top down, the thread that
+ * marks the bottom level owns the removal. Unlinked nodes are freed by epoch based reclamation once no concurrent
+ * operation can hold a reference to them.
+ *
+ * Values are unique, inserting a value that is present returns false. Values that do not compare equal to themselves,
+ * such as NaN, are rejected with a FailedComparison exception.
+ *
+ * size() is relaxed: it is exact when there are no concurrent operations and otherwise may lag concurrent inserts and
+ * removes.
+ *
+ * @tparam T The type of the values, it must be copy constructible.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class LockFreeSkipList {
+        public:
+            explicit LockFreeSkipList(Compare cmp=Compare());
+            // Destruction must not be concurrent with any other operation.
+            ~LockFreeSkipList();
+            LockFreeSkipList(const LockFreeSkipList &) = delete;
+            LockFreeSkipList &operator=(const LockFreeSkipList &) = delete;
+
+            // Returns true if the value is present.
+            bool has(const T &value) const;
+            // Insert a value, returns false if it was already present.
+            bool insert(const T &value);
+            // Remove a value, returns false if it was not present.
+            bool remove(const T &value);
+            // Approximate number of values, exact when there are no concurrent operations.
+            size_t size() const {
+                long count = _count.load(std::memory_order_relaxed);
+                return count > 0 ? static_cast<size_t>(count) : 0;
+            }
+            // Check the ordering and heights, there must be no concurrent operations.
+            IntegrityCheck lacksIntegrity() const;
+        protected:
+            /// A node, the tower of next pointers is a separate allocation of height atomics.
+            struct Node {
+                Node(const T &v, size_t h) : value(v), height(h), refs(2),
+                                             next(new std::atomic<uintptr_t>[h]) {}
+                T value;
+                size_t height;
+                /// References held by the inserting thread and by membership of the set.
+                std::atomic<int> refs;
+                std::unique_ptr<std::atomic<uintptr_t>[]> next;
+            };
+            static Node *_node(uintptr_t link) {
+                return reinterpret_cast<Node *>(link & ~static_cast<uintptr_t>(1));
+            }
+            static bool _marked(uintptr_t link) {
+                return link & 1;
+            }
+            static uintptr_t _link(Node *node) {
+                return reinterpret_cast<uintptr_t>(node);
+            }
+            static void _delete(void *ptr) {
+                delete static_cast<Node *>(ptr);
+            }
+            // Fill preds/succs and unlink marked nodes on the way, returns true if an unmarked value is found.
+            bool _find(const T &value, std::atomic<uintptr_t> **preds, Node **succs);
+            // Drop one of the two references to a node, the last one retires it.
+            void _release(EpochGuard &guard, Node *node) {
+                if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    guard.retire(node);
+                }
+            }
+            /// The head tower.
+            std::atomic<uintptr_t> _head[LOCK_FREE_SKIPLIST_MAX_HEIGHT];
+            /// The approximate count.
+            std::atomic<long> _count;
+            /// Comparison function.
+            Compare _compare;
+            /// Reclamation of removed nodes.
+            std::shared_ptr<EpochDomain> _domain;
+        };
+
+        template <typename T, typename Compare>
+        LockFreeSkipList<T, Compare>::LockFreeSkipList(Compare cmp) : _count(0), _compare(cmp),
+                                                                      _domain(std::make_shared<EpochDomain>(_delete)) {
+            for (auto &link: _head) {
+                link.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        template <typename T, typename Compare>
+        LockFreeSkipList<T, Compare>::~LockFreeSkipList() {
+            Node *node = _node(_head[0].load());
+            while (node) {
+                Node *next = _node(node->next[0].load());
+                delete node;
+                node = next;
+            }
+            _domain->drain();
+        }
+
+/**
+ * Search for a value recording, at every level, the tower whose next pointer is the last one before the value and
+ * the first node not before the value. Marked nodes on the way are unlinked, if an unlink fails because the
+ * predecessor has changed the search restarts.
+ *
+ * The caller must be pinned.
+ *
+ * @param value The value to find.
+ * @param preds The next pointers of the predecessors, one per level.
+ * @param succs The successors, one per level, nullptr at the end of a level.
+ * @return true if an unmarked node with an equal value is linked at the bottom level.
+ */
+        template <typename T, typename Compare>
+        bool LockFreeSkipList<T, Compare>::_find(const T &value, std::atomic<uintptr_t> **preds, Node **succs) {
+        retry:
+            std::atomic<uintptr_t> *pred = _head;
+            Node *curr = nullptr;
+            for (size_t l = LOCK_FREE_SKIPLIST_MAX_HEIGHT; l-- > 0;) {
+                curr = _node(pred[l].load(std::memory_order_acquire));
+                while (curr) {
+                    uintptr_t succ = curr->next[l].load(std::memory_order_acquire);
+                    if (_marked(succ)) {
+                        uintptr_t expected = _link(curr);
+                        if (!pred[l].compare_exchange_strong(expected, succ & ~static_cast<uintptr_t>(1),
+                                                             std::memory_order_acq_rel)) {
+                            goto retry;
+                        }
+                        curr = _node(succ);
+                        continue;
+                    }
+                    if (!_compare(curr->value, value)) {
+                        break;
+                    }
+                    pred = curr->next.get();
+                    curr = _node(succ);
+                }
+                preds[l] = pred;
+                succs[l] = curr;
+            }
+            return curr && !_compare(value, curr->value);
+        }
+
+/**
+ * Returns true if the value is present. This does not modify the list, marked nodes are stepped over.
+ *
+ * @param value The value to search for.
+ * @return true if present.
+ */
+        template <typename T, typename Compare>
+        bool LockFreeSkipList<T, Compare>::has(const T &value) const {
+            if (value != value) {
+                throw FailedComparison(
+                    "Can not work with something that does not compare equal to itself.");
+            }
+            EpochGuard guard(_domain);
+            const std::atomic<uintptr_t> *pred = _head;
+            Node *curr = nullptr;
+            for (size_t l = LOCK_FREE_SKIPLIST_MAX_HEIGHT; l-- > 0;) {
+                curr = _node(pred[l].load(std::memory_order_acquire));
+                while (curr) {
+                    uintptr_t succ = curr->next[l].load(std::memory_order_acquire);
+                    if (_marked(succ)) {
+                        curr = _node(succ);
+                        continue;
+                    }
+                    if (!_compare(curr->value, value)) {
+                        break;
+                    }
+                    pred = curr->next.get();
+                    curr = _node(succ);
+                }
+            }
+            return curr && !_compare(value, curr->value);
+        }
+
+/**
+ * Insert a value. The node is linked at the bottom level first, which is the linearisation point, then the upper
+ * levels are linked from the bottom up.
+ *
+ * Whilst linking the upper levels the node may be concurrently removed in which case linking stops. The inserting
+ * thread holds a reference to the node until it has finished linking so that the node is not retired whilst it may
+ * still be linked in to an upper level.
+ *
+ * @param value The value to insert.
+ * @return true if inserted, false if the value was already present.
+ */
+        template <typename T, typename Compare>
+        bool LockFreeSkipList<T, Compare>::insert(const T &value) {
+            if (value != value) {
+                throw FailedComparison(
+                    "Can not work with something that does not compare equal to itself.");
+            }
+            EpochGuard guard(_domain);
+            std::atomic<uintptr_t> *preds[LOCK_FREE_SKIPLIST_MAX_HEIGHT];
+            Node *succs[LOCK_FREE_SKIPLIST_MAX_HEIGHT];
+            std::unique_ptr<Node> pending;
+            while (true) {
+                if (_find(value, preds, succs)) {
+                    return false;
+                }
+                if (!pending) {
+                    pending.reset(new Node(value, randomHeight(LOCK_FREE_SKIPLIST_MAX_HEIGHT)));
+                }
+                for (size_t l = 0; l < pending->height; ++l) {
+                    pending->next[l].store(_link(succs[l]), std::memory_order_relaxed);
+                }
+                uintptr_t expected = _link(succs[0]);
+                if (preds[0][0].compare_exchange_strong(expected, _link(pending.get()), std::memory_order_acq_rel)) {
+                    break;
+                }
+            }
+            Node *node = pending.release();
+            _count.fetch_add(1, std::memory_order_relaxed);
+            for (size_t l = 1; l < node->height; ++l) {
+                while (true) {
+                    uintptr_t next = node->next[l].load(std::memory_order_acquire);
+                    if (_marked(next)) {
+                        // Concurrently removed, do not link any higher.
+                        goto linked;
+                    }
+                    Node *succ = succs[l];
+                    if (succ && succ != node && !_compare(value, succ->value)) {
+                        // A removed node with an equal value, unlink it first so that it is never behind this one.
+                        _find(value, preds, succs);
+                        continue;
+                    }
+                    if (next != _link(succ) &&
+                        !node->next[l].compare_exchange_strong(next, _link(succ), std::memory_order_acq_rel)) {
+                        continue;
+                    }
+                    uintptr_t expected = _link(succ);
+                    if (preds[l][l].compare_exchange_strong(expected, _link(node), std::memory_order_acq_rel)) {
+                        break;
+                    }
+                    _find(value, preds, succs);
+                }
+            }
+        linked:
+            if (_marked(node->next[0].load(std::memory_order_acquire))) {
+                // Removed whilst linking, make sure every level is unlinked before dropping the reference.
+                _find(value, preds, succs);
+            }
+            _release(guard, node);
+            return true;
+        }
+
+/**
+ * Remove a value by marking its tower from the top down. The thread that marks the bottom level owns the removal,
+ * which is the linearisation point, it then searches for the value to unlink the tower from every level.
+ *
+ * @param value The value to remove.
+ * @return true if removed, false if the value was not present.
+ */
+        template <typename T, typename Compare>
+        bool LockFreeSkipList<T, Compare>::remove(const T &value) {
+            if (value != value) {
+                throw FailedComparison(
+                    "Can not work with something that does not compare equal to itself.");
+            }
+            EpochGuard guard(_domain);
+            std::atomic<uintptr_t> *preds[LOCK_FREE_SKIPLIST_MAX_HEIGHT];
+            Node *succs[LOCK_FREE_SKIPLIST_MAX_HEIGHT];
+            if (!_find(value, preds, succs)) {
+                return false;
+            }
+            Node *node = succs[0];
+            for (size_t l = node->height; l-- > 1;) {
+                node->next[l].fetch_or(1, std::memory_order_acq_rel);
+            }
+            if (_marked(node->next[0].fetch_or(1, std::memory_order_acq_rel))) {
+                return false;
+            }
+            _count.fetch_sub(1, std::memory_order_relaxed);
+            _find(value, preds, succs);
+            _release(guard, node);
+            return true;
+        }
+
+/**
+ * Check that every level is in strictly increasing order, has no marked links and only contains nodes that are tall
+ * enough. Also checks that the count matches the bottom level.
+ * There must be no concurrent operations.
+ *
+ * @return INTEGRITY_SUCCESS or an IntegrityCheck error code.
+ */
+        template <typename T, typename Compare>
+        IntegrityCheck LockFreeSkipList<T, Compare>::lacksIntegrity() const {
+            for (size_t l = 0; l < LOCK_FREE_SKIPLIST_MAX_HEIGHT; ++l) {
+                size_t count = 0;
+                Node *prev = nullptr;
+                uintptr_t link = _head[l].load();
+                while (link) {
+                    if (_marked(link)) {
+                        return HEADNODE_CONTAINS_NULL;
+                    }
+                    Node *node = _node(link);
+                    if (node->height <= l) {
+                        return NODE_HEIGHT_EXCEEDS_HEADNODE;
+                    }
+                    if (prev && !_compare(prev->value, node->value)) {
+                        return HEADNODE_DETECTS_OUT_OF_ORDER;
+                    }
+                    prev = node;
+                    link = node->next[l].load();
+                    ++count;
+                }
+                if (l == 0 && count != size()) {
+                    return HEADNODE_COUNT_MISMATCH;
+                }
+            }
+            return INTEGRITY_SUCCESS;
+        }
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_LockFreeSkipList_h
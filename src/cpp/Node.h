@@ -55,11 +55,14 @@ namespace OrderedStructs {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  */
-template <typename T, typename Compare>
+template <typename T, typename Compare, typename Augment>
 class Node {
 public:
     Node(const T &value, Compare _cmp);
+    // A Node with the same height, widths and augmentation as refs, the references are unlinked.
+    Node(const T &value, Compare _cmp, const SwappableNodeRefStack<T, Compare, Augment> &refs);
     // Const methods
     //
     /// Returns the node value
@@ -68,28 +71,30 @@ public:
     bool has(const T &value) const;
     // Returns the value at the index in the skip list from this node onwards.
     // Will return nullptr is not found.
-    const Node<T, Compare> *at(size_t idx) const;
+    const Node<T, Compare, Augment> *at(size_t idx) const;
     // Computes index of the first occurrence of a value
     bool index(const T& value, size_t &idx, size_t level) const;
     /// Number of linked lists that this node engages in, minimum 1.
     size_t height() const { return _nodeRefs.height(); }
     // Return the pointer to the next node at level 0
-    const Node<T, Compare> *next() const;
+    const Node<T, Compare, Augment> *next() const;
     // Return the width at given level.
     size_t width(size_t level) const;
     // Return the node pointer at given level, only used for HeadNode
     // integrity checks.
-    const Node<T, Compare> *pNode(size_t level) const;
+    const Node<T, Compare, Augment> *pNode(size_t level) const;
     
     // Non-const methods
     /// Get a reference to the node references
-    SwappableNodeRefStack<T, Compare> &nodeRefs() { return _nodeRefs; }
+    SwappableNodeRefStack<T, Compare, Augment> &nodeRefs() { return _nodeRefs; }
     /// Get a reference to the node references
-    const SwappableNodeRefStack<T, Compare> &nodeRefs() const { return _nodeRefs; }
-    // Insert a node
-    Node<T, Compare> *insert(const T &value);
+    const SwappableNodeRefStack<T, Compare, Augment> &nodeRefs() const { return _nodeRefs; }
+    // Insert a new node, distance is set to how far the new node is after this one.
+    Node<T, Compare, Augment> *insert(Node<T, Compare, Augment> *pNewNode, size_t &distance);
+    // Re-initialise a removed node with a new value so that it can be inserted again
+    void reuse(const T &value);
     // Remove a node
-    Node<T, Compare> *remove(size_t call_level, const T &value);
+    Node<T, Compare, Augment> *remove(size_t call_level, const T &value);
     // An estimate of the number of bytes used by this node
     size_t size_of() const;
     
@@ -100,14 +105,14 @@ public:
     
     // Integrity checks, returns non-zero on failure
     IntegrityCheck lacksIntegrity(size_t headnode_height) const;
-    IntegrityCheck lacksIntegrityRefsInSet(const std::set<const Node<T, Compare>*> &nodeSet) const;
+    IntegrityCheck lacksIntegrityRefsInSet(const std::set<const Node<T, Compare, Augment>*> &nodeSet) const;
     
 protected:
-    Node<T, Compare> *_adjRemoveRefs(size_t level, Node<T, Compare> *pNode);
+    Node<T, Compare, Augment> *_adjRemoveRefs(size_t level, Node<T, Compare, Augment> *pNode);
     
 protected:
     T _value;
-    SwappableNodeRefStack<T, Compare> _nodeRefs;
+    SwappableNodeRefStack<T, Compare, Augment> _nodeRefs;
     // Comparison function
     Compare _compare;
 private:
@@ -125,14 +130,63 @@ private:
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param value The value of the Node.
  * @param _cmp The comparison function.
  */
-template <typename T, typename Compare>
-Node<T, Compare>::Node(const T &value, Compare _cmp) : \
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment>::Node(const T &value, Compare _cmp) : \
     _value(value), _compare(_cmp) {
     do {
-        _nodeRefs.push_back(this, _nodeRefs.height() ? 0 : 1);
+        if (_nodeRefs.height()) {
+            _nodeRefs.push_back(this, 0);
+        } else {
+            _nodeRefs.push_back(this, 1, Augment(value));
+        }
+    } while (tossCoin());
+}
+
+/**
+ * Constructor for copying a Skip List.
+ * This does not toss a coin, the SwappableNodeRefStack has the same height, widths and augmentation as refs but the
+ * node pointers are all nullptr for the caller to link.
+ *
+ * @tparam T The type of the Skip List Node values.
+ * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
+ * @param value The value of the Node.
+ * @param _cmp The comparison function.
+ * @param refs The references of the Node being copied.
+ */
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment>::Node(const T &value, Compare _cmp, const SwappableNodeRefStack<T, Compare, Augment> &refs) : \
+    _value(value), _compare(_cmp) {
+    _nodeRefs.assign(refs);
+}
+
+/**
+ * Re-initialise a Node that has been removed from a Skip List with a new value.
+ * This creates a new SwappableNodeRefStack of random height by tossing a virtual coin in the same way as the
+ * constructor so the Node can then be inserted again.
+ *
+ * The storage of the SwappableNodeRefStack is retained so, once the Node has been reused a few times, this
+ * very rarely needs to allocate memory.
+ *
+ * @tparam T The type of the Skip List Node values.
+ * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
+ * @param value The new value of the Node.
+ */
+template <typename T, typename Compare, typename Augment>
+void Node<T, Compare, Augment>::reuse(const T &value) {
+    _value = value;
+    _nodeRefs.clear();
+    do {
+        if (_nodeRefs.height()) {
+            _nodeRefs.push_back(this, 0);
+        } else {
+            _nodeRefs.push_back(this, 1, Augment(value));
+        }
     } while (tossCoin());
 }
 
@@ -141,18 +195,20 @@ Node<T, Compare>::Node(const T &value, Compare _cmp) : \
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param value The value to look for.
  * @return true if the value is present in the skip list from this node onwards.
  */
-template <typename T, typename Compare>
-bool Node<T, Compare>::has(const T &value) const {
+template <typename T, typename Compare, typename Augment>
+bool Node<T, Compare, Augment>::has(const T &value) const {
     assert(_nodeRefs.height());
     assert(value == value); // value can not be NaN for example
     // Effectively: if (value > _value) {
     if (_compare(_value, value)) {
+        // Move on at the highest level that does not overshoot, anything equal to value is reachable from there.
         for (size_t l = _nodeRefs.height(); l-- > 0;) {
-            if (_nodeRefs[l].pNode && _nodeRefs[l].pNode->has(value)) {
-                return true;
+            if (_nodeRefs[l].pNode && !_compare(value, _nodeRefs[l].pNode->value())) {
+                return _nodeRefs[l].pNode->has(value);
             }
         }
         return false;
@@ -168,11 +224,12 @@ bool Node<T, Compare>::has(const T &value) const {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param idx The index from hereon. If zero return this.
  * @return Pointer to the Node or nullptr.
  */
-template <typename T, typename Compare>
-const Node<T, Compare> *Node<T, Compare>::at(size_t idx) const {
+template <typename T, typename Compare, typename Augment>
+const Node<T, Compare, Augment> *Node<T, Compare, Augment>::at(size_t idx) const {
     assert(_nodeRefs.height());
     if (idx == 0) {
         return this;
@@ -190,13 +247,14 @@ const Node<T, Compare> *Node<T, Compare>::at(size_t idx) const {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param value The value to find.
  * @param idx The current index, this will be updated.
  * @param level The current level to search from.
  * @return true if found, false otherwise.
  */
-template <typename T, typename Compare>
-bool Node<T, Compare>::index(const T& value, size_t &idx, size_t level) const {
+template <typename T, typename Compare, typename Augment>
+bool Node<T, Compare, Augment>::index(const T& value, size_t &idx, size_t level) const {
     assert(_nodeRefs.height());
     assert(value == value); // value can not be NaN for example
     assert(level < _nodeRefs.height());
@@ -218,14 +276,19 @@ bool Node<T, Compare>::index(const T& value, size_t &idx, size_t level) const {
         idx = 0;
         return true;
     }
-    // Now work our way down
+    // Now work our way down, moving on at the highest level where the next node is less than value, the first equal
+    // value is after that node. Failing that it can only be the next node at level 0.
     // NOTE: We initialise l as level + 1 because l-- > 0 will decrement it to
     // the correct initial value
     for (size_t l = level + 1; l-- > 0;) {
         assert(l < _nodeRefs.height());
-        if (_nodeRefs[l].pNode && _nodeRefs[l].pNode->index(value, idx, l)) {
-            idx += _nodeRefs[l].width;
-            return true;
+        // Effectively: if (_nodeRefs[l].pNode && (l == 0 || _nodeRefs[l].pNode->value() < value)) {
+        if (_nodeRefs[l].pNode && (l == 0 || _compare(_nodeRefs[l].pNode->value(), value))) {
+            if (_nodeRefs[l].pNode->index(value, idx, l)) {
+                idx += _nodeRefs[l].width;
+                return true;
+            }
+            return false;
         }
     }
     return false;
@@ -236,10 +299,11 @@ bool Node<T, Compare>::index(const T& value, size_t &idx, size_t level) const {
  * 
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @return The next node at level 0.
  */
-template <typename T, typename Compare>
-const Node<T, Compare> *Node<T, Compare>::next() const {
+template <typename T, typename Compare, typename Augment>
+const Node<T, Compare, Augment> *Node<T, Compare, Augment>::next() const {
     assert(_nodeRefs.height());
     return _nodeRefs[0].pNode;
 }
@@ -249,11 +313,12 @@ const Node<T, Compare> *Node<T, Compare>::next() const {
  * 
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param level The requested level.
  * @return The width. 
  */
-template <typename T, typename Compare>
-size_t Node<T, Compare>::width(size_t level) const {
+template <typename T, typename Compare, typename Augment>
+size_t Node<T, Compare, Augment>::width(size_t level) const {
     assert(level < _nodeRefs.height());
     return _nodeRefs[level].width;
 }
@@ -263,11 +328,12 @@ size_t Node<T, Compare>::width(size_t level) const {
  * 
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param level The requested level. 
  * @return The Node.
  */
-template <typename T, typename Compare>
-const Node<T, Compare> *Node<T, Compare>::pNode(size_t level) const {
+template <typename T, typename Compare, typename Augment>
+const Node<T, Compare, Augment> *Node<T, Compare, Augment>::pNode(size_t level) const {
     assert(level < _nodeRefs.height());
     return _nodeRefs[level].pNode;
 }
@@ -277,13 +343,21 @@ const Node<T, Compare> *Node<T, Compare>::pNode(size_t level) const {
  * A duplicate value is inserted *after* the last same value.
  * This ensures order stability as it mirrors remove().
  *
+ * The new Node is created by the caller, either with new or by reusing a removed Node, and it is linked in to the
+ * Skip List here.
+ *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
- * @param value The value of the Node to insert.
+ * @tparam Augment Optional augmentation of the width.
+ * @param pNewNode The new Node to insert, it is inserted by its value.
+ * @param distance Set to the number of positions the new Node is after this one, this is the sum of the widths of the
+ * search path from here so costs nothing extra.
  * @return Pointer to the new Node or nullptr on failure.
  */
-template <typename T, typename Compare>
-Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment> *Node<T, Compare, Augment>::insert(Node<T, Compare, Augment> *pNewNode, size_t &distance) {
+    assert(pNewNode);
+    const T &value = pNewNode->value();
     assert(_nodeRefs.height());
     assert(_nodeRefs.noNodePointerMatches(this));
     assert(! _nodeRefs.canSwap());
@@ -294,14 +368,16 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
         return nullptr;
     }
     // Recursive search for where to put the node
-    Node<T, Compare> *pNode = nullptr;
+    Node<T, Compare, Augment> *pNode = nullptr;
     size_t level = _nodeRefs.height();
     // Effectively: if (value >= _value) {
     if (! _compare(value, _value)) {
         for (level = _nodeRefs.height(); level-- > 0;) {
             if (_nodeRefs[level].pNode) {
-                pNode = _nodeRefs[level].pNode->insert(value);
+                pNode = _nodeRefs[level].pNode->insert(pNewNode, distance);
                 if (pNode) {
+                    // My references have not yet been adjusted for the new Node.
+                    distance += _nodeRefs[level].width;
                     break;
                 }
             }
@@ -310,12 +386,15 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
     // Effectively: if (! pNode && value >= _value) {
     if (! pNode && !_compare(value, _value)) {
         // Insert new node here
-        pNode = new Node<T, Compare>(value, _compare);
+        pNode = pNewNode;
         level = 0;
+        distance = 1;
     }
     assert(pNode); // Should never get here unless a NaN has slipped through
+    // The augmentation contributed by the new value, this is treated in the same way as the width of 1.
+    const Augment aug_value(value);
     // Adjust references by marching up and recursing back.
-    SwappableNodeRefStack<T, Compare> &thatRefs = pNode->_nodeRefs;
+    SwappableNodeRefStack<T, Compare, Augment> &thatRefs = pNode->_nodeRefs;
     if (! thatRefs.canSwap()) {
         // Have an existing node or new node that is all swapped.
         // All I need to do is adjust my overshooting nodes and return
@@ -323,6 +402,7 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
         level = thatRefs.height();
         while (level < _nodeRefs.height()) {
             _nodeRefs[level].width += 1;
+            _nodeRefs[level].aug += aug_value;
             ++level;
         }
         // The caller just has to increment its references that overshoot this
@@ -338,6 +418,7 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
         // B has swapped.
         // Add the level to the accumulator at the next level
         thatRefs[thatRefs.swapLevel()].width += _nodeRefs[level].width;
+        thatRefs[thatRefs.swapLevel()].aug += _nodeRefs[level].aug;
         ++level;
     }
     size_t min_height = std::min(_nodeRefs.height(), thatRefs.height());
@@ -348,11 +429,14 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
         assert(_nodeRefs[level].width > 0);
         assert(thatRefs[level].width > 0);
         _nodeRefs[level].width -= thatRefs[level].width - 1;
+        _nodeRefs[level].aug -= thatRefs[level].aug;
+        _nodeRefs[level].aug += aug_value;
         assert(_nodeRefs[level].width > 0);
         thatRefs.swap(_nodeRefs);
         if (thatRefs.canSwap()) {
             assert(thatRefs[thatRefs.swapLevel()].width == 0);
             thatRefs[thatRefs.swapLevel()].width = _nodeRefs[level].width;
+            thatRefs[thatRefs.swapLevel()].aug = _nodeRefs[level].aug;
         }
         ++level;
     }
@@ -365,6 +449,7 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
         // Adjust my overshooting nodes
         while (level < _nodeRefs.height()) {
             _nodeRefs[level].width += 1;
+            _nodeRefs[level].aug += aug_value;
             ++level;
         }
         // The caller just has to increment its references that overshoot this
@@ -379,14 +464,17 @@ Node<T, Compare> *Node<T, Compare>::insert(const T &value) {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param level The level of the caller's node.
  * @param pNode The Node to swap references with.
  * @return The Node with swapped references.
  */
-template <typename T, typename Compare>
-Node<T, Compare> *Node<T, Compare>::_adjRemoveRefs(size_t level, Node<T, Compare> *pNode) {
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment> *Node<T, Compare, Augment>::_adjRemoveRefs(size_t level, Node<T, Compare, Augment> *pNode) {
     assert(pNode);
-    SwappableNodeRefStack<T, Compare> &thatRefs = pNode->_nodeRefs;
+    SwappableNodeRefStack<T, Compare, Augment> &thatRefs = pNode->_nodeRefs;
+    // The augmentation contributed by the removed value, this is treated in the same way as the width of 1.
+    const Augment aug_value(pNode->value());
     
     assert(pNode != this);
     if (level < thatRefs.swapLevel()) {
@@ -399,6 +487,8 @@ Node<T, Compare> *Node<T, Compare>::_adjRemoveRefs(size_t level, Node<T, Compare
             assert(level == thatRefs.swapLevel());
             // Compute the new width for the new node
             thatRefs[level].width += _nodeRefs[level].width - 1;
+            thatRefs[level].aug += _nodeRefs[level].aug;
+            thatRefs[level].aug -= aug_value;
             thatRefs.swap(_nodeRefs);
             ++level;
         }
@@ -407,6 +497,7 @@ Node<T, Compare> *Node<T, Compare>::_adjRemoveRefs(size_t level, Node<T, Compare
     // Decrement my widths as my refs are over the top of the missing pNode.
     while (level < _nodeRefs.height()) {
         _nodeRefs[level].width -= 1;
+        _nodeRefs[level].aug -= aug_value;
         ++level;
         thatRefs.incSwapLevel();
     }
@@ -422,17 +513,18 @@ Node<T, Compare> *Node<T, Compare>::_adjRemoveRefs(size_t level, Node<T, Compare
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param call_level Level the caller Node is at.
  * @param value Value of the detached Node to remove.
  * @return A pointer to the Node to be free'd or nullptr on failure.
  */
-template <typename T, typename Compare>
-Node<T, Compare> *Node<T, Compare>::remove(size_t call_level,
+template <typename T, typename Compare, typename Augment>
+Node<T, Compare, Augment> *Node<T, Compare, Augment>::remove(size_t call_level,
                          const T &value) {
     assert(_nodeRefs.height());
     assert(_nodeRefs.noNodePointerMatches(this));
     
-    Node<T, Compare> *pNode = nullptr;
+    Node<T, Compare, Augment> *pNode = nullptr;
     // Effectively: if (value >= _value) {
     if (!_compare(value, _value)) {
         for (size_t level = call_level + 1; level-- > 0;) {
@@ -483,11 +575,12 @@ Node<T, Compare> *Node<T, Compare>::remove(size_t call_level,
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param headnode_height Height of HeadNode.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck Node<T, Compare>::lacksIntegrity(size_t headnode_height) const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck Node<T, Compare, Augment>::lacksIntegrity(size_t headnode_height) const {
     IntegrityCheck result = _nodeRefs.lacksIntegrity();
     if (result) {
         return result;
@@ -524,11 +617,12 @@ IntegrityCheck Node<T, Compare>::lacksIntegrity(size_t headnode_height) const {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param nodeSet Set of Nodes held by the HeadNode.
  * @return An IntegrityCheck enum.
  */
-template <typename T, typename Compare>
-IntegrityCheck Node<T, Compare>::lacksIntegrityRefsInSet(const std::set<const Node<T, Compare>*> &nodeSet) const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck Node<T, Compare, Augment>::lacksIntegrityRefsInSet(const std::set<const Node<T, Compare, Augment>*> &nodeSet) const {
     size_t level = 0;
     while (level < _nodeRefs.height()) {
         if (nodeSet.count(_nodeRefs[level].pNode) == 0) {
@@ -546,10 +640,11 @@ IntegrityCheck Node<T, Compare>::lacksIntegrityRefsInSet(const std::set<const No
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @return The memory estimate of this Node.
  */
-template <typename T, typename Compare>
-size_t Node<T, Compare>::size_of() const {
+template <typename T, typename Compare, typename Augment>
+size_t Node<T, Compare, Augment>::size_of() const {
     // sizeof(*this) includes the size of _nodeRefs but _nodeRefs.size_of()
     // includes sizeof(_nodeRefs) so we need to subtract to avoid double counting
     return sizeof(*this) + _nodeRefs.size_of() - sizeof(_nodeRefs) + sizeof(T);
@@ -563,11 +658,12 @@ size_t Node<T, Compare>::size_of() const {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param os Where to write.
  * @param suffix The suffix (node number).
  */
-template <typename T, typename Compare>
-void Node<T, Compare>::writeNode(std::ostream &os, size_t suffix) const {
+template <typename T, typename Compare, typename Augment>
+void Node<T, Compare, Augment>::writeNode(std::ostream &os, size_t suffix) const {
     os << "\"node";
     os << suffix;
     os << std::hex << this << std::dec << "\"";
@@ -578,11 +674,12 @@ void Node<T, Compare>::writeNode(std::ostream &os, size_t suffix) const {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param os Wheere to write.
  * @param suffix The node number.
  */
-template <typename T, typename Compare>
-void Node<T, Compare>::dotFile(std::ostream &os, size_t suffix) const {
+template <typename T, typename Compare, typename Augment>
+void Node<T, Compare, Augment>::dotFile(std::ostream &os, size_t suffix) const {
     assert(_nodeRefs.height());
     writeNode(os, suffix);
     os << " [" << std::endl;
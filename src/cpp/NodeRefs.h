@@ -9,26 +9,253 @@
 #ifndef SkipList_NodeRefs_h
 #define SkipList_NodeRefs_h
 
+#include <cmath>
+
 #include "IntegrityEnums.h"
 
 namespace OrderedStructs {
     namespace SkipList {
 
+/******************** Width augmentation **********************/
+
+/**
+ * @brief The default augmentation of a NodeRef, this records nothing and occupies no space.
+ *
+ * An augmentation is carried alongside the width of every NodeRef and accumulates a per-value contribution over the
+ * values that the NodeRef skips in exactly the same way that the width accumulates a count of one per value.
+ * An augmentation type must:
+ *
+ * - Be default constructible, this is the 'zero' contribution.
+ * - Be constructible from a value of type T, this is the contribution of a single value.
+ * - Support <tt>operator+=</tt> and <tt>operator-=</tt> with another instance.
+ *
+ * See SumAugment and SumSquaresAugment for augmentations that are actually useful.
+ *
+ * @tparam T The type of the Skip List Node values.
+ */
+template <typename T>
+struct NoAugment {
+    NoAugment() {}
+    /// The contribution of a single value, nothing.
+    explicit NoAugment(const T &/* value */) {}
+    NoAugment &operator+=(const NoAugment &/* other */) { return *this; }
+    NoAugment &operator-=(const NoAugment &/* other */) { return *this; }
+};
+
+/**
+ * @brief A double precision running sum using Neumaier's variant of Kahan compensated summation.
+ *
+ * Widths in a Skip List are adjusted incrementally by adding and subtracting the contribution of values as they come
+ * and go. With a naive floating point sum the rounding errors accumulate without limit over a long running rolling
+ * operation, the compensation term here keeps the sum accurate to within a few ULP of the exact sum regardless of how
+ * many insert/remove operations have been made.
+ */
+struct CompensatedSum {
+    /// The running sum.
+    double sum;
+    /// The running compensation for the lost low order bits.
+    double compensation;
+
+    CompensatedSum() : sum(0.0), compensation(0.0) {}
+    explicit CompensatedSum(double value) : sum(value), compensation(0.0) {}
+
+    /// Add a value with compensation.
+    void add(double value) {
+        double t = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) {
+            compensation += (sum - t) + value;
+        } else {
+            compensation += (value - t) + sum;
+        }
+        sum = t;
+    }
+    CompensatedSum &operator+=(const CompensatedSum &other) {
+        add(other.sum);
+        compensation += other.compensation;
+        return *this;
+    }
+    CompensatedSum &operator-=(const CompensatedSum &other) {
+        add(-other.sum);
+        compensation -= other.compensation;
+        return *this;
+    }
+    /// The compensated value of the sum.
+    double value() const { return sum + compensation; }
+};
+
+/**
+ * @brief Augmentation that accumulates the sum of the skipped values.
+ *
+ * For example:
+ *
+ * @code
+ *      OrderedStructs::SkipList::HeadNode<double, std::less<double>, OrderedStructs::SkipList::SumAugment<double>> sl;
+ *      // ... insert values.
+ *      double mean_of_first_ten = sl.prefix(10).sum.value() / 10;
+ * @endcode
+ *
+ * @tparam T The type of the Skip List Node values, this must be convertible to a double.
+ */
+template <typename T>
+struct SumAugment {
+    /// The sum of the values.
+    CompensatedSum sum;
+
+    SumAugment() {}
+    /// The contribution of a single value.
+    explicit SumAugment(const T &value) : sum(static_cast<double>(value)) {}
+    SumAugment &operator+=(const SumAugment &other) {
+        sum += other.sum;
+        return *this;
+    }
+    SumAugment &operator-=(const SumAugment &other) {
+        sum -= other.sum;
+        return *this;
+    }
+};
+
+/**
+ * @brief Augmentation that accumulates the sum and the sum of squares of the skipped values.
+ *
+ * This is sufficient to compute the mean and variance of any contiguous range of the Skip List in O(log(n)) time.
+ *
+ * @tparam T The type of the Skip List Node values, this must be convertible to a double.
+ */
+template <typename T>
+struct SumSquaresAugment {
+    /// The sum of the values.
+    CompensatedSum sum;
+    /// The sum of the squares of the values.
+    CompensatedSum sum_squares;
+
+    SumSquaresAugment() {}
+    /// The contribution of a single value.
+    explicit SumSquaresAugment(const T &value) : sum(static_cast<double>(value)),
+        sum_squares(static_cast<double>(value) * static_cast<double>(value)) {}
+    SumSquaresAugment &operator+=(const SumSquaresAugment &other) {
+        sum += other.sum;
+        sum_squares += other.sum_squares;
+        return *this;
+    }
+    SumSquaresAugment &operator-=(const SumSquaresAugment &other) {
+        sum -= other.sum;
+        sum_squares -= other.sum_squares;
+        return *this;
+    }
+    /// The mean of count values that contributed to this.
+    double mean(size_t count) const {
+        return sum.value() / count;
+    }
+    /// The population variance of count values that contributed to this.
+    double variance(size_t count) const {
+        double mean_value = mean(count);
+        double result = sum_squares.value() / count - mean_value * mean_value;
+        // Guard against a tiny negative value from cancellation.
+        return result > 0.0 ? result : 0.0;
+    }
+};
+
+/**
+ * @brief A value with a weight, for example a price and a traded volume.
+ *
+ * These are ordered by value then by weight so that a particular value/weight pair can always be removed from a
+ * Skip List even if there are other entries with the same value but different weights.
+ *
+ * This is used with WeightAugment for weighted order statistics such as the volume weighted median, see
+ * HeadNode::at_weight().
+ *
+ * @tparam T The type of the value.
+ */
+template <typename T>
+struct WeightedValue {
+    /// The value.
+    T value;
+    /// The weight, this should be non-negative.
+    double weight;
+
+    bool operator<(const WeightedValue &other) const {
+        if (value < other.value) {
+            return true;
+        }
+        if (other.value < value) {
+            return false;
+        }
+        return weight < other.weight;
+    }
+    bool operator==(const WeightedValue &other) const {
+        return value == other.value && weight == other.weight;
+    }
+    bool operator!=(const WeightedValue &other) const {
+        return !(*this == other);
+    }
+};
+
+#ifdef INCLUDE_METHODS_THAT_USE_STREAMS
+/// Write out a WeightedValue as <tt>value(weight)</tt>.
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const WeightedValue<T> &weighted_value) {
+    os << weighted_value.value << "(" << weighted_value.weight << ")";
+    return os;
+}
+#endif // INCLUDE_METHODS_THAT_USE_STREAMS
+
+/**
+ * @brief Augmentation that accumulates the weights of the skipped values.
+ *
+ * The cumulative weight takes the place of the count for HeadNode::at_weight().
+ *
+ * For example:
+ *
+ * @code
+ *      typedef OrderedStructs::SkipList::WeightedValue<double> tWeighted;
+ *      OrderedStructs::SkipList::HeadNode<tWeighted, std::less<tWeighted>,
+ *          OrderedStructs::SkipList::WeightAugment<tWeighted>> sl;
+ *      sl.insert({100.0, 250.0}); // Price and volume.
+ *      // ... insert more.
+ *      double volume_weighted_median = sl.at_weight(sl.total().weight.value() / 2).value;
+ * @endcode
+ *
+ * @tparam T The type of the Skip List Node values, this must have a <tt>weight</tt> member, see WeightedValue.
+ */
+template <typename T>
+struct WeightAugment {
+    /// The sum of the weights.
+    CompensatedSum weight;
+
+    WeightAugment() {}
+    /// The contribution of a single value.
+    explicit WeightAugment(const T &value) : weight(value.weight) {}
+    WeightAugment &operator+=(const WeightAugment &other) {
+        weight += other.weight;
+        return *this;
+    }
+    WeightAugment &operator-=(const WeightAugment &other) {
+        weight -= other.weight;
+        return *this;
+    }
+};
+
+/******************** NodeRef **********************/
+
 /// Forward reference
-template<typename T, typename Compare>
+template <typename T, typename Compare, typename Augment>
 class Node;
 
 /**
  * @brief A PoD struct that contains a pointer to a Node and a width that represents the coarser linked list span to the
  * next Node.
  *
+ * The augmentation accumulates over the same span as the width, with the default NoAugment this takes no space.
+ *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width, see NoAugment.
  */
-template<typename T, typename Compare=std::less<T> >
+template<typename T, typename Compare=std::less<T>, typename Augment=NoAugment<T> >
 struct NodeRef {
-    Node<T, Compare> *pNode;
+    Node<T, Compare, Augment> *pNode;
     size_t width;
+    [[no_unique_address]] Augment aug;
 };
 
 /******************** SwappableNodeRefStack **********************/
@@ -43,8 +270,9 @@ struct NodeRef {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  */
-template<typename T, typename Compare>
+template <typename T, typename Compare, typename Augment>
 class SwappableNodeRefStack {
 public:
     /**
@@ -55,9 +283,9 @@ public:
     // Const methods
     // -------------
     // Subscript read/write
-    const NodeRef<T, Compare> &operator[](size_t level) const;
+    const NodeRef<T, Compare, Augment> &operator[](size_t level) const;
 
-    NodeRef<T, Compare> &operator[](size_t level);
+    NodeRef<T, Compare, Augment> &operator[](size_t level);
 
     /// Number of nodes referenced.
     size_t height() const {
@@ -72,16 +300,16 @@ public:
 
     // Returns true if there is no record of p in my data that
     // could lead to circular references
-    bool noNodePointerMatches(const Node<T, Compare> *p) const;
+    bool noNodePointerMatches(const Node<T, Compare, Augment> *p) const;
 
     // Returns true if all pointers in my data are equal to p.
-    bool allNodePointerMatch(const Node<T, Compare> *p) const;
+    bool allNodePointerMatch(const Node<T, Compare, Augment> *p) const;
 
     // Non-const methods
     // -----------------
     /// Add a new reference
-    void push_back(Node<T, Compare> *p, size_t w) {
-        struct NodeRef<T, Compare> val = {p, w};
+    void push_back(Node<T, Compare, Augment> *p, size_t w, const Augment &aug = Augment()) {
+        struct NodeRef<T, Compare, Augment> val = {p, w, aug};
         _nodes.push_back(val);
     }
 
@@ -90,8 +318,24 @@ public:
         _nodes.pop_back();
     }
 
+    /// Remove all references and reset the swap level, this retains the storage for reuse.
+    void clear() {
+        _nodes.clear();
+        _swapLevel = 0;
+    }
+
+    /// Copy the widths, augmentations and swap level of another stack, the node pointers are set to nullptr for the
+    /// caller to link.
+    void assign(const SwappableNodeRefStack<T, Compare, Augment> &that) {
+        _nodes = that._nodes;
+        for (struct NodeRef<T, Compare, Augment> &ref: _nodes) {
+            ref.pNode = nullptr;
+        }
+        _swapLevel = that._swapLevel;
+    }
+
     // Swap reference at current swap level with another SwappableNodeRefStack
-    void swap(SwappableNodeRefStack<T, Compare> &val);
+    void swap(SwappableNodeRefStack<T, Compare, Augment> &val);
 
     /// Reset the swap level (for example before starting a remove).
     void resetSwapLevel() { _swapLevel = 0; }
@@ -110,7 +354,7 @@ public:
 
 protected:
     /// Stack of NodeRef node references.
-    std::vector<struct NodeRef<T, Compare> > _nodes;
+    std::vector<struct NodeRef<T, Compare, Augment> > _nodes;
     /// The current swap level.
     size_t _swapLevel;
 
@@ -127,11 +371,12 @@ private:
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param level The level.
  * @return A reference to the Node.
  */
-template<typename T, typename Compare>
-const NodeRef<T, Compare> &SwappableNodeRefStack<T, Compare>::operator[](size_t level) const {
+template <typename T, typename Compare, typename Augment>
+const NodeRef<T, Compare, Augment> &SwappableNodeRefStack<T, Compare, Augment>::operator[](size_t level) const {
     // NOTE: No bounds checking on vector::operator[], so this assert will do
     assert(level < _nodes.size());
     return _nodes[level];
@@ -142,11 +387,12 @@ const NodeRef<T, Compare> &SwappableNodeRefStack<T, Compare>::operator[](size_t
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param level The level.
  * @return A reference to the Node.
  */
-template<typename T, typename Compare>
-NodeRef<T, Compare> &SwappableNodeRefStack<T, Compare>::operator[](size_t level) {
+template <typename T, typename Compare, typename Augment>
+NodeRef<T, Compare, Augment> &SwappableNodeRefStack<T, Compare, Augment>::operator[](size_t level) {
     // NOTE: No bounds checking on vector::operator[], so this assert will do
     assert(level < _nodes.size());
     return _nodes[level];
@@ -158,11 +404,12 @@ NodeRef<T, Compare> &SwappableNodeRefStack<T, Compare>::operator[](size_t level)
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param p The Node.
  * @return true if all the Node references are swapped (none are referring to the given Node).
  */
-template<typename T, typename Compare>
-bool SwappableNodeRefStack<T, Compare>::noNodePointerMatches(const Node<T, Compare> *p) const {
+template <typename T, typename Compare, typename Augment>
+bool SwappableNodeRefStack<T, Compare, Augment>::noNodePointerMatches(const Node<T, Compare, Augment> *p) const {
     for (size_t level = height(); level-- > 0;) {
         if (p == _nodes[level].pNode) {
             return false;
@@ -177,11 +424,12 @@ bool SwappableNodeRefStack<T, Compare>::noNodePointerMatches(const Node<T, Compa
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param p The Node.
  * @return true if all the Node references are un-swapped (all are referring to the given Node).
  */
-template<typename T, typename Compare>
-bool SwappableNodeRefStack<T, Compare>::allNodePointerMatch(const Node<T, Compare> *p) const {
+template <typename T, typename Compare, typename Augment>
+bool SwappableNodeRefStack<T, Compare, Augment>::allNodePointerMatch(const Node<T, Compare, Augment> *p) const {
     for (size_t level = height(); level-- > 0;) {
         if (p != _nodes[level].pNode) {
             return false;
@@ -196,12 +444,13 @@ bool SwappableNodeRefStack<T, Compare>::allNodePointerMatch(const Node<T, Compar
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @param val The SwappableNodeRefStack.
  */
-template<typename T, typename Compare>
-void SwappableNodeRefStack<T, Compare>::swap(SwappableNodeRefStack<T, Compare> &val) {
+template <typename T, typename Compare, typename Augment>
+void SwappableNodeRefStack<T, Compare, Augment>::swap(SwappableNodeRefStack<T, Compare, Augment> &val) {
     assert(_swapLevel < height());
-    NodeRef<T, Compare> temp = val[_swapLevel];
+    NodeRef<T, Compare, Augment> temp = val[_swapLevel];
     val[_swapLevel] = _nodes[_swapLevel];
     _nodes[_swapLevel] = temp;
     ++_swapLevel;
@@ -217,10 +466,11 @@ void SwappableNodeRefStack<T, Compare>::swap(SwappableNodeRefStack<T, Compare> &
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @return An IntegrityCheck enum.
  */
-template<typename T, typename Compare>
-IntegrityCheck SwappableNodeRefStack<T, Compare>::lacksIntegrity() const {
+template <typename T, typename Compare, typename Augment>
+IntegrityCheck SwappableNodeRefStack<T, Compare, Augment>::lacksIntegrity() const {
     if (height()) {
         if (_nodes[0].width != 1) {
             return NODEREFS_WIDTH_ZERO_NOT_UNITY;
@@ -239,11 +489,12 @@ IntegrityCheck SwappableNodeRefStack<T, Compare>::lacksIntegrity() const {
  *
  * @tparam T The type of the Skip List Node values.
  * @tparam Compare A comparison function for type T.
+ * @tparam Augment Optional augmentation of the width.
  * @return The memory estimate.
  */
-template<typename T, typename Compare>
-size_t SwappableNodeRefStack<T, Compare>::size_of() const {
-    return sizeof(*this) + _nodes.capacity() * sizeof(struct NodeRef<T>);
+template <typename T, typename Compare, typename Augment>
+size_t SwappableNodeRefStack<T, Compare, Augment>::size_of() const {
+    return sizeof(*this) + _nodes.capacity() * sizeof(struct NodeRef<T, Compare, Augment>);
 }
 
     } // namespace SkipList
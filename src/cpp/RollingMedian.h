@@ -38,12 +38,26 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <type_traits>
 
 #include "SkipList.h"
+#include "SortedWindow.h"
+#include "HistogramWindow.h"
+#include "WindowedQuantileSketch.h"
 
 namespace OrderedStructs {
     /**
      * @brief Namespace for the C++ Rolling Median.
+     *
+     * The Skip Lists used here are local to a function call, or a RollingMedian object, so they are constructed with
+     * thread_safe=false and do not lock the global mutex. This allows rolling medians to run in parallel threads.
      */
     namespace RollingMedian {
 
@@ -55,29 +69,134 @@ namespace OrderedStructs {
             ROLLING_MEDIAN_SOURCE_STRIDE,
             ROLLING_MEDIAN_DESTINATION_STRIDE,
             ROLLING_MEDIAN_WIN_LENGTH,
+            ROLLING_MEDIAN_QUANTILE,
+            ROLLING_MEDIAN_TIMESTAMP,
+            ROLLING_MEDIAN_THRESHOLD,
+            ROLLING_MEDIAN_EPSILON,
+            ROLLING_MEDIAN_WEIGHT,
         };
 
 /**
- * Vector based rolling median.
- * This handles both even and odd window lengths.
+ * How a quantile is computed when it lies between two values in the window.
+ * These are the same as the numpy.quantile() methods of the same name.
  *
- * The length of the result is data.size() - win_length
+ * The position of quantile q in a window of length n is q * (n - 1), if this is not an integer then the quantile lies
+ * between the values either side of that position.
+ */
+        enum QuantileInterpolation {
+            /// Linear interpolation between the two values.
+            QUANTILE_LINEAR = 0,
+            /// The lower value.
+            QUANTILE_LOWER,
+            /// The higher value.
+            QUANTILE_HIGHER,
+            /// The nearest value, if half way then the one with the even index.
+            QUANTILE_NEAREST,
+            /// The mean of the two values.
+            QUANTILE_MIDPOINT,
+        };
+
+/**
+ * Window lengths up to this use a SortedWindow rather than a Skip List for trivially copyable types such as double.
+ * perf_roll_med_engine_crossover() in test/test_performance.cpp shows, for doubles, the SortedWindow is 4x to 9x faster
+ * for windows up to 1000, 2.2x faster at 4097 and 1.2x faster at 8193. The Skip List is faster from about 16,000 so
+ * this is set a factor of four below that.
+ */
+        const size_t SORTED_WINDOW_MAX_WIN_LENGTH = 4096;
+
+/**
+ * Returns true if a SortedWindow should be used rather than a Skip List.
+ * Types that are not trivially copyable, such as std::string, are expensive to shift so always use a Skip List.
+ *
+ * @tparam T Type of the value(s).
+ * @param win_length Window length.
+ * @return true if a SortedWindow should be used.
+ */
+        template<typename T>
+        bool use_sorted_window(size_t win_length) {
+            return std::is_trivially_copyable<T>::value && win_length <= SORTED_WINDOW_MAX_WIN_LENGTH;
+        }
+
+/**
+ * Integral data with a range of no more than this many bins for each value in the window uses a HistogramWindow.
+ * The time taken by HistogramWindow::at() depends on how far the median moves across the bins so sparse histograms,
+ * such as a short window over a wide range of values, are faster with a SortedWindow.
+ * perf_roll_med_histogram() in test/test_performance.cpp shows the crossover.
+ */
+        const size_t HISTOGRAM_WINDOW_MAX_BINS_PER_VALUE = 256;
+
+/**
+ * Windows shorter than this never use a HistogramWindow as a SortedWindow is faster.
+ */
+        const size_t HISTOGRAM_WINDOW_MIN_WIN_LENGTH = 9;
+
+/**
+ * Returns true if a HistogramWindow should be used for a range of integral values and a window length.
+ *
+ * @tparam T Type of the value(s).
+ * @param min_value The minimum value of the data.
+ * @param max_value The maximum value of the data.
+ * @param win_length Window length.
+ * @return true if a HistogramWindow should be used.
+ */
+        template<typename T>
+        bool use_histogram_range(const T &min_value, const T &max_value, size_t win_length) {
+            if (! std::is_integral<T>::value || win_length < HISTOGRAM_WINDOW_MIN_WIN_LENGTH) {
+                return false;
+            }
+            // Unsigned arithmetic avoids overflow of signed types.
+            uint64_t bin_count = static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value) + 1;
+            return bin_count != 0 && bin_count <= HISTOGRAM_WINDOW_MAX_BIN_COUNT
+                   && bin_count <= HISTOGRAM_WINDOW_MAX_BINS_PER_VALUE * win_length;
+        }
+
+/**
+ * Returns true if a HistogramWindow should be used, this is only ever true for integral types.
+ * This scans the data for the range of values that are needed to construct the HistogramWindow.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param min_value Set to the minimum value of the data.
+ * @param max_value Set to the maximum value of the data.
+ * @return true if a HistogramWindow should be used.
+ */
+        template<typename T>
+        bool use_histogram_window(const T *src, size_t src_stride, size_t count, size_t win_length,
+                                  T &min_value, T &max_value) {
+            if (! std::is_integral<T>::value || count == 0 || win_length < HISTOGRAM_WINDOW_MIN_WIN_LENGTH) {
+                return false;
+            }
+            min_value = max_value = *src;
+            for (size_t i = 1; i < count; ++i) {
+                src += src_stride;
+                if (*src < min_value) {
+                    min_value = *src;
+                } else if (max_value < *src) {
+                    max_value = *src;
+                }
+            }
+            return use_histogram_range(min_value, max_value, win_length);
+        }
+
+/**
+ * Implementation of rolling_median() with either a SkipList::HeadNode or a SortedWindow.
  *
  * @tparam T Data type.
+ * @tparam Engine The ordered container, a SkipList::HeadNode or a SortedWindow.
+ * @param sl The empty ordered container.
  * @param data Data vector.
  * @param win_length Window length.
  * @param result Result vector.
  * @return ROLLING_MEDIAN_SUCCESS on success, non-zero on failure.
  */
-        template<typename T>
-        RollingMedianResult rolling_median(const std::vector<T> data,
-                                           size_t win_length,
-                                           std::vector<T> &result) {
-            if (win_length == 0) {
-                return ROLLING_MEDIAN_WIN_LENGTH;
-            }
-            OrderedStructs::SkipList::HeadNode<T> sl;
-
+        template<typename T, typename Engine>
+        RollingMedianResult _rolling_median(Engine &sl,
+                                            const std::vector<T> &data,
+                                            size_t win_length,
+                                            std::vector<T> &result) {
             result.clear();
             std::vector<T> buffer;
             for (size_t i = 0; i < data.size(); ++i) {
@@ -97,6 +216,44 @@ namespace OrderedStructs {
             return ROLLING_MEDIAN_SUCCESS;
         }
 
+/**
+ * Vector based rolling median.
+ * This handles both even and odd window lengths.
+ *
+ * The length of the result is data.size() - win_length
+ *
+ * Small windows of trivially copyable types use a SortedWindow rather than a Skip List and integral types with a small
+ * range of values use a HistogramWindow, the results are identical.
+ *
+ * @tparam T Data type.
+ * @param data Data vector.
+ * @param win_length Window length.
+ * @param result Result vector.
+ * @return ROLLING_MEDIAN_SUCCESS on success, non-zero on failure.
+ */
+        template<typename T>
+        RollingMedianResult rolling_median(const std::vector<T> &data,
+                                           size_t win_length,
+                                           std::vector<T> &result) {
+            if (win_length == 0) {
+                return ROLLING_MEDIAN_WIN_LENGTH;
+            }
+            if constexpr (std::is_integral<T>::value) {
+                T min_value, max_value;
+                if (use_histogram_window(data.data(), 1, data.size(), win_length, min_value, max_value)) {
+                    HistogramWindow<T> hw(min_value, max_value);
+                    return _rolling_median(hw, data, win_length, result);
+                }
+            }
+            if (use_sorted_window<T>(win_length)) {
+                // The window briefly holds win_length + 1 values.
+                SortedWindow<T> sw(win_length + 1);
+                return _rolling_median(sw, data, win_length, result);
+            }
+            OrderedStructs::SkipList::HeadNode<T> sl(std::less<T>(), false);
+            return _rolling_median(sl, data, win_length, result);
+        }
+
 /**
  * Vector based rolling median.
  * This always uses the lower bound so works correctly for odd sized window lengths.
@@ -112,13 +269,13 @@ namespace OrderedStructs {
  * @return ROLLING_MEDIAN_SUCCESS on success, non-zero on failure.
  */
         template<typename T>
-        RollingMedianResult rolling_median_lower_bound(const std::vector<T> data,
+        RollingMedianResult rolling_median_lower_bound(const std::vector<T> &data,
                                            size_t win_length,
                                            std::vector<T> &result) {
             if (win_length == 0) {
                 return ROLLING_MEDIAN_WIN_LENGTH;
             }
-            OrderedStructs::SkipList::HeadNode<T> sl;
+            OrderedStructs::SkipList::HeadNode<T> sl(std::less<T>(), false);
 
             result.clear();
             std::vector<T> buffer;
@@ -180,6 +337,55 @@ namespace OrderedStructs {
  */
         size_t dest_size(size_t count, size_t win_length, size_t dest_stride);
 
+/**
+ * Implementation of odd_index() with a SkipList::HeadNode, a SortedWindow or a HistogramWindow.
+ */
+        template<typename T, typename Engine>
+        RollingMedianResult _odd_index(Engine &sl,
+                                       const T *src, size_t src_stride,
+                                       size_t count, size_t win_length,
+                                       T *dest, size_t dest_stride) {
+            const T *tail = src;
+
+            for (size_t i = 0; i < count; ++i) {
+                sl.insert(*src);
+                if (i + 1 >= win_length) {
+                    *dest = sl.at(win_length / 2);
+                    dest += dest_stride;
+                    sl.remove(*tail);
+                    tail += src_stride;
+                }
+                src += src_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * Implementation of even_index() with a SkipList::HeadNode, a SortedWindow or a HistogramWindow.
+ */
+        template<typename T, typename Engine>
+        RollingMedianResult _even_index(Engine &sl,
+                                        const T *src, size_t src_stride,
+                                        size_t count, size_t win_length,
+                                        T *dest, size_t dest_stride) {
+            std::vector<T> buffer;
+
+            const T *tail = src;
+            for (size_t i = 0; i < count; ++i) {
+                sl.insert(*src);
+                if (i + 1 >= win_length) {
+                    sl.at((win_length - 1) / 2, 2, buffer);
+                    assert(buffer.size() == 2);
+                    *dest = buffer[0] / 2 + buffer[1] / 2;
+                    dest += dest_stride;
+                    sl.remove(*tail);
+                    tail += src_stride;
+                }
+                src += src_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
 /**
  * Rolling median where only the odd mid-index is considered.
  * The (win_length - 1) / 2 value is used.
@@ -191,6 +397,9 @@ namespace OrderedStructs {
  *
  * The number of valid values in the result is count - win_length
  *
+ * Small windows of trivially copyable types use a SortedWindow rather than a Skip List and integral types with a small
+ * range of values use a HistogramWindow, the results are identical.
+ *
  * @tparam T Type of the value(s).
  * @param src Source array of values.
  * @param src_stride Source stride for 2D arrays.
@@ -207,20 +416,19 @@ namespace OrderedStructs {
             assert(win_length % 2 == 1);
             ROLLING_MEDIAN_ERROR_CHECK;
 
-            SkipList::HeadNode<T> sl;
-            const T *tail = src;
-
-            for (size_t i = 0; i < count; ++i) {
-                sl.insert(*src);
-                if (i + 1 >= win_length) {
-                    *dest = sl.at(win_length / 2);
-                    dest += dest_stride;
-                    sl.remove(*tail);
-                    tail += src_stride;
+            if constexpr (std::is_integral<T>::value) {
+                T min_value, max_value;
+                if (use_histogram_window(src, src_stride, count, win_length, min_value, max_value)) {
+                    HistogramWindow<T> hw(min_value, max_value);
+                    return _odd_index(hw, src, src_stride, count, win_length, dest, dest_stride);
                 }
-                src += src_stride;
             }
-            return ROLLING_MEDIAN_SUCCESS;
+            if (use_sorted_window<T>(win_length)) {
+                SortedWindow<T> sw(win_length);
+                return _odd_index(sw, src, src_stride, count, win_length, dest, dest_stride);
+            }
+            SkipList::HeadNode<T> sl(std::less<T>(), false);
+            return _odd_index(sl, src, src_stride, count, win_length, dest, dest_stride);
         }
 
 /**
@@ -234,6 +442,9 @@ namespace OrderedStructs {
  *
  * The number of valid values in the result is count - win_length
  *
+ * Small windows of trivially copyable types use a SortedWindow rather than a Skip List and integral types with a small
+ * range of values use a HistogramWindow, the results are identical.
+ *
  * @tparam T Type of the value(s).
  * @param src Source array of values.
  * @param src_stride Source stride for 2D arrays.
@@ -250,23 +461,19 @@ namespace OrderedStructs {
             assert(win_length % 2 == 0);
             ROLLING_MEDIAN_ERROR_CHECK;
 
-            SkipList::HeadNode<T> sl;
-            std::vector<T> buffer;
-
-            const T *tail = src;
-            for (size_t i = 0; i < count; ++i) {
-                sl.insert(*src);
-                if (i + 1 >= win_length) {
-                    sl.at((win_length - 1) / 2, 2, buffer);
-                    assert(buffer.size() == 2);
-                    *dest = buffer[0] / 2 + buffer[1] / 2;
-                    dest += dest_stride;
-                    sl.remove(*tail);
-                    tail += src_stride;
+            if constexpr (std::is_integral<T>::value) {
+                T min_value, max_value;
+                if (use_histogram_window(src, src_stride, count, win_length, min_value, max_value)) {
+                    HistogramWindow<T> hw(min_value, max_value);
+                    return _even_index(hw, src, src_stride, count, win_length, dest, dest_stride);
                 }
-                src += src_stride;
             }
-            return ROLLING_MEDIAN_SUCCESS;
+            if (use_sorted_window<T>(win_length)) {
+                SortedWindow<T> sw(win_length);
+                return _even_index(sw, src, src_stride, count, win_length, dest, dest_stride);
+            }
+            SkipList::HeadNode<T> sl(std::less<T>(), false);
+            return _even_index(sl, src, src_stride, count, win_length, dest, dest_stride);
         }
 
 /**
@@ -302,6 +509,1250 @@ namespace OrderedStructs {
             return ret;
         }
 
+/**
+ * The number of threads to use, std::thread::hardware_concurrency() if thread_count is zero or greater than that.
+ * More threads than cores can not go faster and a very large thread_count could exhaust the resources of the process.
+ */
+        inline size_t _thread_count(size_t thread_count) {
+            const size_t hardware_threads = std::max(std::thread::hardware_concurrency(), 1U);
+            return thread_count == 0 || thread_count > hardware_threads ? hardware_threads : thread_count;
+        }
+
+/**
+ * Run task_count tasks on a pool of threads where each worker takes the next task that has not been started so the
+ * load is balanced if some tasks are slower. The calling thread is one of the workers.
+ *
+ * If any task throws then the remaining tasks are abandoned and the first exception is rethrown here once all the
+ * threads have finished.
+ * If a thread can not be started the tasks are shared between the threads that did start.
+ *
+ * @tparam Task A callable that takes the task index and returns a RollingMedianResult.
+ * @param task_count Number of tasks.
+ * @param thread_count Number of threads, if zero, or more than std::thread::hardware_concurrency(), then that is used.
+ * @param task The task.
+ * @return ROLLING_MEDIAN_SUCCESS or the failure of any task.
+ */
+        template<typename Task>
+        RollingMedianResult _parallel_for(size_t task_count, size_t thread_count, Task task) {
+            thread_count = _thread_count(thread_count);
+            if (thread_count > task_count) {
+                thread_count = task_count;
+            }
+            std::atomic<size_t> next_task(0);
+            std::atomic<int> result(ROLLING_MEDIAN_SUCCESS);
+            std::vector<std::exception_ptr> errors(std::max(thread_count, size_t(1)));
+
+            auto worker = [&](size_t thread_index) {
+                try {
+                    for (size_t t = next_task++; t < task_count; t = next_task++) {
+                        RollingMedianResult task_result = task(t);
+                        if (task_result != ROLLING_MEDIAN_SUCCESS) {
+                            result = task_result;
+                        }
+                    }
+                } catch (...) {
+                    errors[thread_index] = std::current_exception();
+                    // Abandon the remaining tasks.
+                    next_task = task_count;
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            try {
+                for (size_t t = 1; t < thread_count; ++t) {
+                    threads.emplace_back(worker, t);
+                }
+            } catch (std::system_error &err) {
+                // Carry on with the threads that have started.
+            }
+            worker(0);
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            for (const auto &error: errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+            return static_cast<RollingMedianResult>(result.load());
+        }
+
+/**
+ * Rolling median of every column of a 2D array using a pool of threads, each column is computed in the same way as
+ * even_odd_index().
+ *
+ * The value at row r and column c is src[r * src_stride + c * src_column_stride] so for a row major (C order) array of
+ * N columns src_stride is N and src_column_stride is 1. The destination is addressed in the same way and has
+ * dest_count(count, win_length) rows.
+ *
+ * Each column has its own thread confined Skip List so there is no locking between the threads.
+ * If any column throws, for example a NaN, then the remaining columns are abandoned and the first exception is
+ * rethrown here once all the threads have finished.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source 2D array of values.
+ * @param src_stride Source stride between rows.
+ * @param src_column_stride Source stride between columns.
+ * @param count Number of rows.
+ * @param column_count Number of columns.
+ * @param win_length Window length.
+ * @param dest The destination 2D array.
+ * @param dest_stride The destination stride between rows.
+ * @param dest_column_stride The destination stride between columns.
+ * @param thread_count Number of threads, if zero, or more than std::thread::hardware_concurrency(), then that is used.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult even_odd_index_columns(const T *src, size_t src_stride, size_t src_column_stride,
+                                                   size_t count, size_t column_count, size_t win_length,
+                                                   T *dest, size_t dest_stride, size_t dest_column_stride,
+                                                   size_t thread_count = 0) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+            return _parallel_for(column_count, thread_count, [&](size_t column) {
+                return even_odd_index(src + column * src_column_stride, src_stride,
+                                      count, win_length,
+                                      dest + column * dest_column_stride, dest_stride);
+            });
+        }
+
+/**
+ * Rolling median of a single long series in parallel, the result is identical to even_odd_index().
+ *
+ * The results are split into contiguous chunks, one per thread. Each worker has its own Skip List that is first warmed
+ * with the win_length - 1 values before its chunk and then computes the results for its chunk only so the output
+ * regions do not overlap.
+ *
+ * The warm up costs win_length - 1 extra inserts for each chunk so the number of chunks is limited so that each chunk
+ * has at least win_length results. Short series, or long windows, use fewer threads.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param dest The destination array.
+ * @param dest_stride The destination stride given a 2D array.
+ * @param thread_count Number of threads, if zero, or more than std::thread::hardware_concurrency(), then that is used.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult even_odd_index_parallel(const T *src, size_t src_stride,
+                                                    size_t count, size_t win_length,
+                                                    T *dest, size_t dest_stride,
+                                                    size_t thread_count = 0) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+            if (count < win_length) {
+                return ROLLING_MEDIAN_SUCCESS;
+            }
+            const size_t result_count = count - win_length + 1;
+            const size_t chunk_count = std::max(std::min(_thread_count(thread_count), result_count / win_length),
+                                                size_t(1));
+            return _parallel_for(chunk_count, chunk_count, [&](size_t chunk) {
+                // Spread any remainder over the first chunks.
+                size_t begin = chunk * (result_count / chunk_count) + std::min(chunk, result_count % chunk_count);
+                size_t end = begin + result_count / chunk_count + (chunk < result_count % chunk_count ? 1 : 0);
+                return even_odd_index(src + begin * src_stride, src_stride,
+                                      end - begin + win_length - 1, win_length,
+                                      dest + begin * dest_stride, dest_stride);
+            });
+        }
+
+/**
+ * The median of all the values in an engine in the same way as even_odd_index(), an even number of values gives the
+ * mean of the two central values.
+ */
+        template<typename T, typename Engine>
+        T _median_of_all(Engine &engine, std::vector<T> &buffer) {
+            size_t size = engine.size();
+            if (size == 0) {
+                SkipList::_throw_exceeds_size(size);
+            }
+            if (size % 2 == 1) {
+                return engine.at(size / 2);
+            }
+            engine.at((size - 1) / 2, 2, buffer);
+            assert(buffer.size() == 2);
+            return buffer[0] / 2 + buffer[1] / 2;
+        }
+
+/**
+ * Implementation of median_filter_2d() for the destination rows [row_begin, row_end) with any engine.
+ *
+ * Each destination row fills the engine with the first kernel x kernel block then slides it along the row by removing
+ * the kernel values of the column that leaves the block and inserting the kernel values of the column that enters it.
+ * The engine is emptied at the end of each row so it can be reused.
+ */
+        template<typename T, typename Engine>
+        void _median_filter_2d_rows(Engine &engine,
+                                    const T *src, size_t src_row_stride, size_t src_column_stride,
+                                    size_t columns, size_t kernel, size_t row_begin, size_t row_end,
+                                    T *dest, size_t dest_row_stride, size_t dest_column_stride) {
+            std::vector<T> buffer;
+            for (size_t row = row_begin; row < row_end; ++row) {
+                const T *top = src + row * src_row_stride;
+                T *out = dest + row * dest_row_stride;
+                for (size_t column = 0; column + kernel <= columns; ++column) {
+                    if (column == 0) {
+                        for (size_t c = 0; c < kernel; ++c) {
+                            for (size_t r = 0; r < kernel; ++r) {
+                                engine.insert(top[r * src_row_stride + c * src_column_stride]);
+                            }
+                        }
+                    } else {
+                        for (size_t r = 0; r < kernel; ++r) {
+                            engine.remove(top[r * src_row_stride + (column - 1) * src_column_stride]);
+                            engine.insert(top[r * src_row_stride + (column + kernel - 1) * src_column_stride]);
+                        }
+                    }
+                    out[column * dest_column_stride] = _median_of_all(engine, buffer);
+                }
+                for (size_t c = columns - kernel; c < columns; ++c) {
+                    for (size_t r = 0; r < kernel; ++r) {
+                        engine.remove(top[r * src_row_stride + c * src_column_stride]);
+                    }
+                }
+            }
+        }
+
+/**
+ * Run _median_filter_2d_rows() in parallel with the destination rows split into contiguous chunks, one per thread.
+ * make_engine() is called once per chunk to create an empty engine.
+ */
+        template<typename T, typename MakeEngine>
+        RollingMedianResult _median_filter_2d_parallel(MakeEngine make_engine,
+                                                       const T *src, size_t src_row_stride, size_t src_column_stride,
+                                                       size_t rows, size_t columns, size_t kernel,
+                                                       T *dest, size_t dest_row_stride, size_t dest_column_stride,
+                                                       size_t thread_count) {
+            const size_t dest_rows = rows - kernel + 1;
+            const size_t chunk_count = std::min(_thread_count(thread_count), dest_rows);
+            return _parallel_for(chunk_count, chunk_count, [&](size_t chunk) {
+                // Spread any remainder over the first chunks.
+                size_t begin = chunk * (dest_rows / chunk_count) + std::min(chunk, dest_rows % chunk_count);
+                size_t end = begin + dest_rows / chunk_count + (chunk < dest_rows % chunk_count ? 1 : 0);
+                auto engine = make_engine();
+                _median_filter_2d_rows(engine, src, src_row_stride, src_column_stride, columns, kernel, begin, end,
+                                       dest, dest_row_stride, dest_column_stride);
+                return ROLLING_MEDIAN_SUCCESS;
+            });
+        }
+
+/**
+ * A true 2D median filter of a 2D array with a square kernel x kernel window.
+ * This is the "valid" mode so the destination has rows - kernel + 1 rows and columns - kernel + 1 columns and the value
+ * at destination (r, c) is the median of the source block with (r, c) as the top left corner.
+ * An even kernel uses the mean of the two central values.
+ *
+ * This uses the incremental window update of Huang, T. S. (1979) where moving the window along a row removes and
+ * inserts only 2 * kernel values rather than kernel * kernel. The destination rows are computed in parallel.
+ *
+ * The value at row r and column c is src[r * src_row_stride + c * src_column_stride], the destination is addressed in
+ * the same way.
+ *
+ * The engine for each window is chosen from the type and the data in the same way as even_odd_index() with a window
+ * length of kernel * kernel: a HistogramWindow for integral types with a small range of values (for example uint8_t
+ * or uint16_t images), a SortedWindow for other trivially copyable types with small kernels, otherwise a Skip List.
+ *
+ * If the source has fewer rows or columns than the kernel then nothing is written.
+ * If any value throws, for example a NaN, then the remaining rows are abandoned and the first exception is rethrown
+ * here once all the threads have finished.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source 2D array of values.
+ * @param src_row_stride Source stride between rows.
+ * @param src_column_stride Source stride between columns.
+ * @param rows Number of source rows.
+ * @param columns Number of source columns.
+ * @param kernel The width and height of the window.
+ * @param dest The destination 2D array.
+ * @param dest_row_stride The destination stride between rows.
+ * @param dest_column_stride The destination stride between columns.
+ * @param thread_count Number of threads, if zero, or more than std::thread::hardware_concurrency(), then that is used.
+ * @return The result of the median filter as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult median_filter_2d(const T *src, size_t src_row_stride, size_t src_column_stride,
+                                             size_t rows, size_t columns, size_t kernel,
+                                             T *dest, size_t dest_row_stride, size_t dest_column_stride,
+                                             size_t thread_count = 0) {
+            if (src_row_stride == 0 || src_column_stride == 0) {
+                return ROLLING_MEDIAN_SOURCE_STRIDE;
+            }
+            if (dest_row_stride == 0 || dest_column_stride == 0) {
+                return ROLLING_MEDIAN_DESTINATION_STRIDE;
+            }
+            if (kernel == 0) {
+                return ROLLING_MEDIAN_WIN_LENGTH;
+            }
+            if (rows < kernel || columns < kernel) {
+                return ROLLING_MEDIAN_SUCCESS;
+            }
+            const size_t win_length = kernel * kernel;
+            if constexpr (std::is_integral<T>::value) {
+                T min_value = *src;
+                T max_value = *src;
+                for (size_t r = 0; r < rows; ++r) {
+                    for (size_t c = 0; c < columns; ++c) {
+                        const T &value = src[r * src_row_stride + c * src_column_stride];
+                        min_value = std::min(min_value, value);
+                        max_value = std::max(max_value, value);
+                    }
+                }
+                if (use_histogram_range(min_value, max_value, win_length)) {
+                    return _median_filter_2d_parallel(
+                            [&]() { return HistogramWindow<T>(min_value, max_value); },
+                            src, src_row_stride, src_column_stride, rows, columns, kernel,
+                            dest, dest_row_stride, dest_column_stride, thread_count);
+                }
+            }
+            if (use_sorted_window<T>(win_length)) {
+                return _median_filter_2d_parallel(
+                        [&]() { return SortedWindow<T>(win_length); },
+                        src, src_row_stride, src_column_stride, rows, columns, kernel,
+                        dest, dest_row_stride, dest_column_stride, thread_count);
+            }
+            return _median_filter_2d_parallel(
+                    []() { return SkipList::HeadNode<T>(std::less<T>(), false); },
+                    src, src_row_stride, src_column_stride, rows, columns, kernel,
+                    dest, dest_row_stride, dest_column_stride, thread_count);
+        }
+
+/**
+ * Rolling quantiles where any number of quantiles are computed for each window from a single Skip List.
+ * This is far cheaper than a separate rolling pass for each quantile as the insert() and remove() are done once per
+ * value and each quantile is just an O(log(win_length)) lookup.
+ *
+ * The results for each window are written to consecutive locations in dest so the result of quantile q for window i
+ * is at dest[i * dest_stride + q]. dest_stride must be at least quantile_count.
+ * It is up to the caller to ensure that there is enough space in dest for the results, use dest_size() for this.
+ *
+ * For QUANTILE_LINEAR and QUANTILE_MIDPOINT this requires T to be arithmetic.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param quantiles The quantiles, each must be in the range [0, 1], for example {0.5, 0.9, 0.99}.
+ * @param quantile_count The number of quantiles.
+ * @param dest The destination array.
+ * @param dest_stride The destination stride, this must be >= quantile_count.
+ * @param interpolation How to compute a quantile that lies between two values.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult rolling_quantile(const T *src, size_t src_stride,
+                                             size_t count, size_t win_length,
+                                             const double *quantiles, size_t quantile_count,
+                                             T *dest, size_t dest_stride,
+                                             QuantileInterpolation interpolation = QUANTILE_LINEAR) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+            if (dest_stride < quantile_count) {
+                return ROLLING_MEDIAN_DESTINATION_STRIDE;
+            }
+            // The window length is fixed so compute the index and fraction of each quantile once.
+            std::vector<size_t> indexes(quantile_count);
+            std::vector<double> fractions(quantile_count);
+            for (size_t q = 0; q < quantile_count; ++q) {
+                // Negated so that NaN is rejected.
+                if (! (quantiles[q] >= 0.0 && quantiles[q] <= 1.0)) {
+                    return ROLLING_MEDIAN_QUANTILE;
+                }
+                double position = quantiles[q] * (win_length - 1);
+                size_t lower = static_cast<size_t>(std::floor(position));
+                double fraction = position - lower;
+                if (lower >= win_length - 1) {
+                    lower = win_length - 1;
+                    fraction = 0.0;
+                }
+                switch (interpolation) {
+                    case QUANTILE_LINEAR:
+                        break;
+                    case QUANTILE_LOWER:
+                        fraction = 0.0;
+                        break;
+                    case QUANTILE_HIGHER:
+                        if (fraction > 0.0) {
+                            ++lower;
+                            fraction = 0.0;
+                        }
+                        break;
+                    case QUANTILE_NEAREST:
+                        if (fraction > 0.5 || (fraction == 0.5 && lower % 2 == 1)) {
+                            ++lower;
+                        }
+                        fraction = 0.0;
+                        break;
+                    case QUANTILE_MIDPOINT:
+                        if (fraction > 0.0) {
+                            fraction = 0.5;
+                        }
+                        break;
+                    default:
+                        return ROLLING_MEDIAN_QUANTILE;
+                }
+                indexes[q] = lower;
+                fractions[q] = fraction;
+            }
+
+            SkipList::HeadNode<T> sl(std::less<T>(), false);
+            std::vector<T> buffer;
+
+            const T *tail = src;
+            for (size_t i = 0; i < count; ++i) {
+                sl.insert(*src);
+                if (i + 1 >= win_length) {
+                    for (size_t q = 0; q < quantile_count; ++q) {
+                        if (fractions[q] == 0.0) {
+                            dest[q] = sl.at(indexes[q]);
+                        } else {
+                            sl.at(indexes[q], 2, buffer);
+                            assert(buffer.size() == 2);
+                            if (interpolation == QUANTILE_MIDPOINT) {
+                                dest[q] = buffer[0] / 2 + buffer[1] / 2;
+                            } else {
+                                dest[q] = buffer[0] + (buffer[1] - buffer[0]) * fractions[q];
+                            }
+                        }
+                    }
+                    dest += dest_stride;
+                    sl.remove(*tail);
+                    tail += src_stride;
+                }
+                src += src_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * Approximate rolling quantile for very long windows where an exact window would use too much memory.
+ * This uses a WindowedQuantileSketch whose memory is O(1 / epsilon^2) whatever the window length.
+ *
+ * Each result is one of the source values and its rank in the exact window is within epsilon * win_length of
+ * quantile * (win_length - 1). For example with epsilon = 0.01 and a window of 10^7 values the result for the median
+ * is between the exact 49th and 51st percentiles of the window.
+ *
+ * The results only change when a block of <tt>floor(epsilon * win_length / 4)</tt> values is completed so a result is
+ * repeated between times.
+ *
+ * For windows shorter than <tt>4 / epsilon^2</tt> the sketch would be no smaller than an exact window so this uses
+ * rolling_quantile() with QUANTILE_NEAREST instead, the results are then exact.
+ *
+ * The number of valid values in the result is count - win_length + 1, the same as even_odd_index().
+ * It is up to the caller to ensure that there is enough space in dest for the results, use dest_size() for this.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param dest The destination array.
+ * @param dest_stride The destination stride given a 2D array.
+ * @param epsilon The maximum rank error as a fraction of the window length, this must be in (0, 1).
+ * @param quantile The quantile, in the range [0, 1].
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult approximate_rolling_quantile(const T *src, size_t src_stride,
+                                                         size_t count, size_t win_length,
+                                                         T *dest, size_t dest_stride,
+                                                         double epsilon, double quantile) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+            // Negated so that NaN is rejected.
+            if (! (epsilon > 0.0 && epsilon < 1.0)) {
+                return ROLLING_MEDIAN_EPSILON;
+            }
+            if (! (quantile >= 0.0 && quantile <= 1.0)) {
+                return ROLLING_MEDIAN_QUANTILE;
+            }
+            if (win_length * epsilon * epsilon < 4.0) {
+                return rolling_quantile(src, src_stride, count, win_length, &quantile, 1, dest, dest_stride,
+                                        QUANTILE_NEAREST);
+            }
+            WindowedQuantileSketch<T> sketch(win_length, epsilon);
+            T result = T();
+            for (size_t i = 0; i < count; ++i) {
+                bool changed = sketch.push(*src);
+                if (i + 1 >= win_length) {
+                    if (changed || i + 1 == win_length) {
+                        result = sketch.quantile(quantile);
+                    }
+                    *dest = result;
+                    dest += dest_stride;
+                }
+                src += src_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * Approximate rolling median with the same arguments as even_odd_index() plus the maximum rank error, see
+ * approximate_rolling_quantile().
+ *
+ * Unlike even_odd_index() the result is always one of the source values so this does not need T / 2 to be meaningful.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param dest The destination array.
+ * @param dest_stride The destination stride given a 2D array.
+ * @param epsilon The maximum rank error as a fraction of the window length, this must be in (0, 1).
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult approximate_even_odd_index(const T *src, size_t src_stride,
+                                                       size_t count, size_t win_length,
+                                                       T *dest, size_t dest_stride,
+                                                       double epsilon) {
+            return approximate_rolling_quantile(src, src_stride, count, win_length, dest, dest_stride, epsilon, 0.5);
+        }
+
+/**
+ * Rolling median, mean and population variance computed together in one pass with a single Skip List whose widths are
+ * augmented with the sum and sum of squares of the values (see SkipList::SumSquaresAugment).
+ *
+ * The median is computed in the same way as even_odd_index() so requires T / 2 to be meaningful for even window
+ * lengths. The mean and variance are computed from compensated sums so do not drift however long the data is.
+ *
+ * It is up to the caller to ensure that there is enough space in each of the destinations for the results, use
+ * dest_size() for this.
+ *
+ * @tparam T Type of the value(s), this must be convertible to a double.
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param dest_median The destination array for the median.
+ * @param dest_mean The destination array for the mean.
+ * @param dest_variance The destination array for the population variance.
+ * @param dest_stride The destination stride given a 2D array, this is the same for all three destinations.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult median_mean_variance(const T *src, size_t src_stride,
+                                                 size_t count, size_t win_length,
+                                                 T *dest_median, double *dest_mean, double *dest_variance,
+                                                 size_t dest_stride) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+
+            SkipList::HeadNode<T, std::less<T>, SkipList::SumSquaresAugment<T>> sl(std::less<T>(), false);
+            std::vector<T> buffer;
+
+            const T *tail = src;
+            for (size_t i = 0; i < count; ++i) {
+                sl.insert(*src);
+                if (i + 1 >= win_length) {
+                    if (win_length % 2 == 1) {
+                        *dest_median = sl.at(win_length / 2);
+                    } else {
+                        sl.at((win_length - 1) / 2, 2, buffer);
+                        assert(buffer.size() == 2);
+                        *dest_median = buffer[0] / 2 + buffer[1] / 2;
+                    }
+                    SkipList::SumSquaresAugment<T> total = sl.total();
+                    *dest_mean = total.mean(win_length);
+                    *dest_variance = total.variance(win_length);
+                    dest_median += dest_stride;
+                    dest_mean += dest_stride;
+                    dest_variance += dest_stride;
+                    sl.remove(*tail);
+                    tail += src_stride;
+                }
+                src += src_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * The absolute difference between two values, this is safe for unsigned types.
+ */
+        template<typename T>
+        T _absolute_deviation(const T &value, const T &median) {
+            return value < median ? median - value : value - median;
+        }
+
+/**
+ * The k'th smallest (from 0) absolute deviation from the median of the values in a sorted engine of n values.
+ *
+ * The deviations of the values below the split point p = n / 2 are an ascending sequence A[j] = median - at(p - 1 - j)
+ * and the deviations of the rest are an ascending sequence B[j] = at(p + j) - median. The k'th smallest of the merged
+ * sequences is found by a binary search on the number, i, taken from A, so this needs O(log(n)) calls to at() rather
+ * than copying out the window.
+ */
+        template<typename T, typename Engine>
+        T _kth_absolute_deviation(Engine &engine, const T &median, size_t k) {
+            const size_t n = engine.size();
+            const size_t a = n / 2;
+            const size_t b = n - a;
+            assert(k < n);
+            auto A = [&](size_t j) { return _absolute_deviation(engine.at(a - 1 - j), median); };
+            auto B = [&](size_t j) { return _absolute_deviation(engine.at(a + j), median); };
+            size_t lo = k + 1 > b ? k + 1 - b : 0;
+            size_t hi = std::min(k + 1, a);
+            while (lo < hi) {
+                size_t i = lo + (hi - lo) / 2;
+                if (A(i) < B(k - i)) {
+                    lo = i + 1;
+                } else {
+                    hi = i;
+                }
+            }
+            // lo values come from A and k + 1 - lo from B, the k'th is the larger of the last of each.
+            if (lo == 0) {
+                return B(k);
+            }
+            if (lo == k + 1) {
+                return A(k);
+            }
+            return std::max(A(lo - 1), B(k - lo));
+        }
+
+/**
+ * The median absolute deviation (MAD) of the values in a sorted engine from their median. An even number of values
+ * uses the mean of the two central deviations in the same way as even_odd_index().
+ */
+        template<typename T, typename Engine>
+        T _median_absolute_deviation(Engine &engine, const T &median) {
+            const size_t n = engine.size();
+            if (n % 2 == 1) {
+                return _kth_absolute_deviation(engine, median, n / 2);
+            }
+            return _kth_absolute_deviation(engine, median, n / 2 - 1) / 2
+                   + _kth_absolute_deviation(engine, median, n / 2) / 2;
+        }
+
+/**
+ * Implementation of rolling_median_mad() with either a SkipList::HeadNode or a SortedWindow.
+ */
+        template<typename T, typename Engine>
+        RollingMedianResult _rolling_median_mad(Engine &sl,
+                                                const T *src, size_t src_stride,
+                                                size_t count, size_t win_length,
+                                                T *dest_median, T *dest_mad, size_t dest_stride) {
+            std::vector<T> buffer;
+            const T *tail = src;
+            for (size_t i = 0; i < count; ++i) {
+                sl.insert(*src);
+                if (i + 1 >= win_length) {
+                    *dest_median = _median_of_all(sl, buffer);
+                    *dest_mad = _median_absolute_deviation(sl, *dest_median);
+                    dest_median += dest_stride;
+                    dest_mad += dest_stride;
+                    sl.remove(*tail);
+                    tail += src_stride;
+                }
+                src += src_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * Rolling median and median absolute deviation (MAD) computed together in one pass.
+ *
+ * The MAD is the median of the absolute deviations of the window from its median. This does not copy out the window,
+ * the deviations either side of the median are two sorted sequences so the MAD is found by a binary search between
+ * them with O(log(win_length)) lookups of the ordered window. Each step is O(log(win_length)^2) with a Skip List.
+ *
+ * The median and MAD are computed in the same way as even_odd_index() so requires T / 2 to be meaningful for even
+ * window lengths. Small windows of trivially copyable types use a SortedWindow rather than a Skip List, the results
+ * are identical.
+ *
+ * It is up to the caller to ensure that there is enough space in each of the destinations for the results, use
+ * dest_size() for this.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param win_length Window length.
+ * @param dest_median The destination array for the median.
+ * @param dest_mad The destination array for the median absolute deviation.
+ * @param dest_stride The destination stride given a 2D array, this is the same for both destinations.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult rolling_median_mad(const T *src, size_t src_stride,
+                                               size_t count, size_t win_length,
+                                               T *dest_median, T *dest_mad, size_t dest_stride) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+            if (use_sorted_window<T>(win_length)) {
+                SortedWindow<T> sw(win_length);
+                return _rolling_median_mad(sw, src, src_stride, count, win_length, dest_median, dest_mad, dest_stride);
+            }
+            SkipList::HeadNode<T> sl(std::less<T>(), false);
+            return _rolling_median_mad(sl, src, src_stride, count, win_length, dest_median, dest_mad, dest_stride);
+        }
+
+/**
+ * The scale factor that makes the MAD a consistent estimator of the standard deviation of normally distributed data.
+ */
+        const double MAD_NORMAL_SCALE = 1.4826;
+
+/**
+ * Implementation of hampel_filter() with either a SkipList::HeadNode or a SortedWindow.
+ */
+        template<typename T, typename Engine>
+        RollingMedianResult _hampel_filter(Engine &sl,
+                                           const T *src, size_t src_stride,
+                                           size_t count, size_t half_width, double n_sigmas,
+                                           T *dest, size_t dest_stride,
+                                           std::vector<size_t> &outliers) {
+            const size_t win_length = 2 * half_width + 1;
+            std::vector<T> buffer;
+            outliers.clear();
+            for (size_t i = 0; i < count; ++i) {
+                sl.insert(src[i * src_stride]);
+                if (i + 1 >= win_length) {
+                    // The window is centred on this value.
+                    const size_t centre = i - half_width;
+                    const T &value = src[centre * src_stride];
+                    T median = _median_of_all(sl, buffer);
+                    T mad = _median_absolute_deviation(sl, median);
+                    if (static_cast<double>(_absolute_deviation(value, median))
+                        > n_sigmas * MAD_NORMAL_SCALE * static_cast<double>(mad)) {
+                        dest[centre * dest_stride] = median;
+                        outliers.push_back(centre);
+                    } else {
+                        dest[centre * dest_stride] = value;
+                    }
+                    sl.remove(src[(i + 1 - win_length) * src_stride]);
+                }
+            }
+            // The values at each end that do not have a full window are unchanged.
+            for (size_t i = 0; i < std::min(half_width, count); ++i) {
+                dest[i * dest_stride] = src[i * src_stride];
+                dest[(count - 1 - i) * dest_stride] = src[(count - 1 - i) * src_stride];
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * Hampel outlier filter. Each value is compared with the median and median absolute deviation (MAD) of the window of
+ * 2 * half_width + 1 values centred on it. If it differs from the median by more than n_sigmas * 1.4826 * MAD then it
+ * is an outlier, its index is added to outliers and it is replaced by the median in dest. Other values are copied to
+ * dest unchanged.
+ *
+ * The half_width values at each end do not have a full window so are copied unchanged.
+ *
+ * Each step is O(log(win_length)^2), see rolling_median_mad().
+ *
+ * Unlike the other rolling functions dest has count values, the same as src, so dest can be src to filter in place.
+ *
+ * @tparam T Type of the value(s), this must be convertible to a double.
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param half_width The number of values either side of each value in the window.
+ * @param n_sigmas The threshold in (scaled) MADs, this must not be negative, 3.0 is typical.
+ * @param dest The destination array of count values.
+ * @param dest_stride The destination stride given a 2D array.
+ * @param outliers Set to the indexes of the outliers in ascending order.
+ * @return The result of the filter as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult hampel_filter(const T *src, size_t src_stride,
+                                          size_t count, size_t half_width, double n_sigmas,
+                                          T *dest, size_t dest_stride,
+                                          std::vector<size_t> &outliers) {
+            if (src_stride == 0) {
+                return ROLLING_MEDIAN_SOURCE_STRIDE;
+            }
+            if (dest_stride == 0) {
+                return ROLLING_MEDIAN_DESTINATION_STRIDE;
+            }
+            if (! (n_sigmas >= 0.0)) {
+                return ROLLING_MEDIAN_THRESHOLD;
+            }
+            if (src == dest && src_stride == dest_stride) {
+                // Filtering in place would change values that are still in the window so work from a copy.
+                std::vector<T> copy;
+                for (size_t i = 0; i < count; ++i) {
+                    copy.push_back(src[i * src_stride]);
+                }
+                return hampel_filter(copy.data(), 1, count, half_width, n_sigmas, dest, dest_stride, outliers);
+            }
+            if (use_sorted_window<T>(2 * half_width + 1)) {
+                SortedWindow<T> sw(2 * half_width + 1);
+                return _hampel_filter(sw, src, src_stride, count, half_width, n_sigmas, dest, dest_stride, outliers);
+            }
+            SkipList::HeadNode<T> sl(std::less<T>(), false);
+            return _hampel_filter(sl, src, src_stride, count, half_width, n_sigmas, dest, dest_stride, outliers);
+        }
+
+/**
+ * Rolling weighted median where each value has a corresponding weight, for example a volume weighted median price.
+ *
+ * The weighted median is the first value in the window, in sorted order, where the cumulative weight reaches half the
+ * total weight of the window. With equal weights this is the same as odd_index() for odd window lengths and is the
+ * lower of the two central values for even window lengths.
+ *
+ * This uses a Skip List whose widths are augmented with the weights (see SkipList::WeightAugment) so each step is
+ * O(log(win_length)), the window is never sorted. See WeightedRollingMedian for the streaming form.
+ * The weights must be finite and non-negative otherwise ROLLING_MEDIAN_WEIGHT is returned.
+ *
+ * It is up to the caller to ensure that there is enough space in dest for the results, use dest_size() for this.
+ *
+ * @tparam T Type of the value(s).
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param weights Source array of weights.
+ * @param weight_stride Stride of the weights for 2D arrays.
+ * @param count Number of input values and weights.
+ * @param win_length Window length.
+ * @param dest The destination array.
+ * @param dest_stride The destination stride given a 2D array.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T>
+        RollingMedianResult weighted_median(const T *src, size_t src_stride,
+                                            const double *weights, size_t weight_stride,
+                                            size_t count, size_t win_length,
+                                            T *dest, size_t dest_stride) {
+            ROLLING_MEDIAN_ERROR_CHECK;
+            if (weight_stride == 0) {
+                return ROLLING_MEDIAN_SOURCE_STRIDE;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                // Negated so that NaN is rejected.
+                if (! (weights[i * weight_stride] >= 0.0 && std::isfinite(weights[i * weight_stride]))) {
+                    return ROLLING_MEDIAN_WEIGHT;
+                }
+            }
+            typedef SkipList::WeightedValue<T> tWeighted;
+            SkipList::HeadNode<tWeighted, std::less<tWeighted>, SkipList::WeightAugment<tWeighted>> sl(
+                std::less<tWeighted>(), false
+            );
+            // Remove before insert so that the insert reuses the Node.
+            sl.set_node_reuse(1);
+
+            const T *tail = src;
+            const double *tail_weights = weights;
+            for (size_t i = 0; i < count; ++i) {
+                if (i >= win_length) {
+                    sl.remove(tWeighted{*tail, *tail_weights});
+                    tail += src_stride;
+                    tail_weights += weight_stride;
+                }
+                sl.insert(tWeighted{*src, *weights});
+                if (i + 1 >= win_length) {
+                    *dest = sl.at_weight(sl.total().weight.value() / 2).value;
+                    dest += dest_stride;
+                }
+                src += src_stride;
+                weights += weight_stride;
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * When several values leave a time window at one step the removed Nodes are kept, up to this many, for the following
+ * inserts.
+ */
+        const size_t TIME_WINDOW_MAX_SPARE_NODES = 1024;
+
+/**
+ * Rolling median over a time window rather than a fixed number of values, for samples that arrive at irregular
+ * intervals. Each sample has a timestamp and the result for sample i is the median of the values of the samples j <= i
+ * where timestamps[j] > timestamps[i] - duration, so the window always includes sample i.
+ *
+ * The timestamps must not decrease and must compare equal to themselves, so not NaN. Several samples may leave the
+ * window at one step, they are each removed before the new value is inserted and the removed Nodes are reused by the
+ * Skip List for later inserts.
+ *
+ * When the number of values in the window is even this uses the mean of the two central values in the same way as
+ * even_index() so requires T / 2 to be meaningful.
+ *
+ * There is one result for each sample so dest must have space for count values at dest_stride.
+ *
+ * @tparam T Type of the value(s).
+ * @tparam TS Type of the timestamps, for example double seconds or int64_t nanoseconds.
+ * @param timestamps The array of timestamps, these must not decrease or be NaN.
+ * @param timestamp_stride Timestamp stride for 2D arrays.
+ * @param src Source array of values.
+ * @param src_stride Source stride for 2D arrays.
+ * @param count Number of input values.
+ * @param duration The duration of the window, this must be greater than zero.
+ * @param dest The destination array.
+ * @param dest_stride The destination stride given a 2D array.
+ * @return The result of the Rolling Median operation as a RollingMedianResult enum.
+ */
+        template<typename T, typename TS>
+        RollingMedianResult time_window_median(const TS *timestamps, size_t timestamp_stride,
+                                               const T *src, size_t src_stride,
+                                               size_t count, const TS &duration,
+                                               T *dest, size_t dest_stride) {
+            if (src_stride == 0 || timestamp_stride == 0) {
+                return ROLLING_MEDIAN_SOURCE_STRIDE;
+            }
+            if (dest_stride == 0) {
+                return ROLLING_MEDIAN_DESTINATION_STRIDE;
+            }
+            if (! (TS() < duration)) {
+                return ROLLING_MEDIAN_WIN_LENGTH;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                const TS &timestamp = timestamps[i * timestamp_stride];
+                // A NaN timestamp would pass the ordering test and then evict the whole window.
+                if (timestamp != timestamp || (i > 0 && timestamp < timestamps[(i - 1) * timestamp_stride])) {
+                    return ROLLING_MEDIAN_TIMESTAMP;
+                }
+            }
+            SkipList::HeadNode<T> sl(std::less<T>(), false);
+            sl.set_node_reuse(TIME_WINDOW_MAX_SPARE_NODES);
+            std::vector<T> buffer;
+            size_t tail = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const TS &now = timestamps[i * timestamp_stride];
+                // Remove the values that have left the window, first so that the insert can reuse a Node.
+                // The subtraction is this way round so that unsigned timestamps can not underflow.
+                while (tail < i && ! (now - timestamps[tail * timestamp_stride] < duration)) {
+                    sl.remove(src[tail * src_stride]);
+                    ++tail;
+                }
+                sl.insert(src[i * src_stride]);
+                dest[i * dest_stride] = _median_of_all(sl, buffer);
+            }
+            return ROLLING_MEDIAN_SUCCESS;
+        }
+
+/**
+ * @brief A stateful rolling median for live data where the values arrive one at a time.
+ *
+ * Each push() adds a value to the window and, once the window is full, evicts the oldest value. The current median is
+ * returned by push() and median().
+ * While the window is filling the median is that of the values seen so far.
+ *
+ * The pending evictions are held in a ring buffer of win_length values. All storage is allocated up front and the
+ * Skip List reuses the removed Node for the next insert so, once the Skip List Node heights have settled, push() does
+ * no memory allocation.
+ *
+ * Example:
+ *
+ * @code
+ *      OrderedStructs::RollingMedian::RollingMedian<double> rm(21);
+ *      while (feed.has_value()) {
+ *          double median = rm.push(feed.value());
+ *          // ...
+ *      }
+ * @endcode
+ *
+ * When the number of values in the window is even this uses the mean of the two central values in the same way as
+ * even_index() so requires T / 2 to be meaningful.
+ *
+ * This is not thread safe, the caller must synchronise access if it is shared between threads.
+ *
+ * @tparam T Type of the value(s).
+ */
+        template<typename T>
+        class RollingMedian {
+        public:
+            /**
+             * Create a rolling median with a window length.
+             * Will throw an OrderedStructs::SkipList::ValueError if win_length is zero.
+             *
+             * @param win_length Window length.
+             */
+            explicit RollingMedian(size_t win_length) : _win_length(win_length), _head(0), _sl(std::less<T>(), false) {
+                if (win_length == 0) {
+                    throw SkipList::ValueError("Window length must be greater than zero.");
+                }
+                _ring.reserve(win_length);
+                _buffer.reserve(2);
+                _sl.set_node_reuse(1);
+            }
+            /**
+             * Add a value to the window evicting the oldest value if the window is full.
+             * Will throw an OrderedStructs::SkipList::FailedComparison if the value does not compare equal to itself,
+             * for example NaN, in which case the window is unchanged.
+             *
+             * @param value The new value.
+             * @return The median of the window including the new value.
+             */
+            T push(const T &value) {
+                if (value != value) {
+                    throw SkipList::FailedComparison(
+                        "Can not work with something that does not compare equal to itself.");
+                }
+                if (_ring.size() < _win_length) {
+                    _ring.push_back(value);
+                } else {
+                    // Remove first so that the insert can reuse the Node.
+                    _sl.remove(_ring[_head]);
+                    _ring[_head] = value;
+                    if (++_head == _win_length) {
+                        _head = 0;
+                    }
+                }
+                _sl.insert(value);
+                return median();
+            }
+            /**
+             * The median of the current window.
+             * Will throw an OrderedStructs::SkipList::IndexError if no values have been pushed.
+             *
+             * @return The median.
+             */
+            T median() const {
+                size_t count = _sl.size();
+                if (count % 2 == 1) {
+                    return _sl.at(count / 2);
+                }
+                _sl.at((count - 1) / 2, 2, _buffer);
+                assert(_buffer.size() == 2);
+                return _buffer[0] / 2 + _buffer[1] / 2;
+            }
+            /// The number of values in the window, this is at most win_length().
+            size_t size() const {
+                return _sl.size();
+            }
+            /// The window length.
+            size_t win_length() const {
+                return _win_length;
+            }
+        private:
+            /// The window length.
+            size_t _win_length;
+            /// Ring buffer of values in arrival order, these are the pending evictions.
+            std::vector<T> _ring;
+            /// Index in _ring of the oldest value once the window is full.
+            size_t _head;
+            /// The values in the window in sorted order.
+            SkipList::HeadNode<T> _sl;
+            /// Working space for the two central values of an even window.
+            mutable std::vector<T> _buffer;
+        };
+
+/**
+ * @brief A stateful rolling weighted median for live data where each value has a weight, for example trade prices
+ * weighted by volume.
+ *
+ * Each push(value, weight) adds the weighted value to the window and, once the window is full, evicts the oldest one.
+ * The weighted median is the first value in the window, in sorted order, where the cumulative weight reaches half the
+ * total weight of the window, this is the streaming form of weighted_median().
+ *
+ * The window is held in a Skip List whose widths are augmented with the weights (see SkipList::WeightAugment) so each
+ * push() is O(log(win_length)) and the window is never sorted. The pending evictions are held in a ring buffer and
+ * the Skip List reuses the removed Node for the next insert.
+ *
+ * Example, the volume weighted median of the last 1000 trades:
+ *
+ * @code
+ *      OrderedStructs::RollingMedian::WeightedRollingMedian<double> rm(1000);
+ *      while (feed.has_value()) {
+ *          double median = rm.push(feed.price(), feed.volume());
+ *          // ...
+ *      }
+ * @endcode
+ *
+ * This is not thread safe, the caller must synchronise access if it is shared between threads.
+ *
+ * @tparam T Type of the value(s).
+ */
+        template<typename T>
+        class WeightedRollingMedian {
+        public:
+            /**
+             * Create a rolling weighted median with a window length.
+             * Will throw an OrderedStructs::SkipList::ValueError if win_length is zero.
+             *
+             * @param win_length Window length.
+             */
+            explicit WeightedRollingMedian(size_t win_length) : _win_length(win_length), _head(0),
+                                                                _sl(std::less<tWeighted>(), false) {
+                if (win_length == 0) {
+                    throw SkipList::ValueError("Window length must be greater than zero.");
+                }
+                _ring.reserve(win_length);
+                _sl.set_node_reuse(1);
+            }
+            /**
+             * Add a weighted value to the window evicting the oldest value if the window is full.
+             * Will throw an OrderedStructs::SkipList::FailedComparison if the value does not compare equal to itself,
+             * for example NaN, or an OrderedStructs::SkipList::ValueError if the weight is negative or not finite. In
+             * either case the window is unchanged.
+             *
+             * @param value The new value.
+             * @param weight The weight of the new value.
+             * @return The weighted median of the window including the new value.
+             */
+            T push(const T &value, double weight) {
+                if (value != value) {
+                    throw SkipList::FailedComparison(
+                        "Can not work with something that does not compare equal to itself.");
+                }
+                // Negated so that NaN is rejected.
+                if (! (weight >= 0.0 && std::isfinite(weight))) {
+                    throw SkipList::ValueError("Weight must be finite and non-negative.");
+                }
+                if (_ring.size() < _win_length) {
+                    _ring.push_back(tWeighted{value, weight});
+                } else {
+                    // Remove first so that the insert can reuse the Node.
+                    _sl.remove(_ring[_head]);
+                    _ring[_head] = tWeighted{value, weight};
+                    if (++_head == _win_length) {
+                        _head = 0;
+                    }
+                }
+                _sl.insert(tWeighted{value, weight});
+                return median();
+            }
+            /**
+             * The weighted median of the current window.
+             * Will throw an OrderedStructs::SkipList::IndexError if no values have been pushed.
+             *
+             * @return The weighted median.
+             */
+            T median() const {
+                if (_sl.size() == 0) {
+                    SkipList::_throw_exceeds_size(0);
+                }
+                return _sl.at_weight(total_weight() / 2).value;
+            }
+            /// The total weight of the window.
+            double total_weight() const {
+                return _sl.total().weight.value();
+            }
+            /// The number of values in the window, this is at most win_length().
+            size_t size() const {
+                return _sl.size();
+            }
+            /// The window length.
+            size_t win_length() const {
+                return _win_length;
+            }
+        private:
+            typedef SkipList::WeightedValue<T> tWeighted;
+            /// The window length.
+            size_t _win_length;
+            /// Ring buffer of weighted values in arrival order, these are the pending evictions.
+            std::vector<tWeighted> _ring;
+            /// Index in _ring of the oldest value once the window is full.
+            size_t _head;
+            /// The weighted values in the window in sorted order.
+            SkipList::HeadNode<tWeighted, std::less<tWeighted>, SkipList::WeightAugment<tWeighted>> _sl;
+        };
+
+/**
+ * @brief A stateful rolling median over a time window for live data that arrives at irregular intervals.
+ *
+ * Each push(timestamp, value) removes every value whose timestamp is duration or more before the new timestamp, one at
+ * a time, then adds the new value and returns the median of the window. This is the streaming form of
+ * time_window_median().
+ *
+ * Example, the median of the last 30 seconds:
+ *
+ * @code
+ *      OrderedStructs::RollingMedian::TimeWindowRollingMedian<double> rm(30.0);
+ *      while (feed.has_value()) {
+ *          double median = rm.push(feed.timestamp(), feed.value());
+ *          // ...
+ *      }
+ * @endcode
+ *
+ * When the number of values in the window is even this uses the mean of the two central values in the same way as
+ * even_index() so requires T / 2 to be meaningful.
+ *
+ * This is not thread safe, the caller must synchronise access if it is shared between threads.
+ *
+ * @tparam T Type of the value(s).
+ * @tparam TS Type of the timestamps, for example double seconds or int64_t nanoseconds.
+ */
+        template<typename T, typename TS=double>
+        class TimeWindowRollingMedian {
+        public:
+            /**
+             * Create a rolling median with a time window.
+             * Will throw an OrderedStructs::SkipList::ValueError if duration is not greater than zero.
+             *
+             * @param duration The duration of the window.
+             */
+            explicit TimeWindowRollingMedian(const TS &duration) : _duration(duration), _sl(std::less<T>(), false) {
+                if (! (TS() < duration)) {
+                    throw SkipList::ValueError("Duration must be greater than zero.");
+                }
+                _buffer.reserve(2);
+                _sl.set_node_reuse(TIME_WINDOW_MAX_SPARE_NODES);
+            }
+            /**
+             * Evict the values that have left the window then add the new value.
+             * Will throw an OrderedStructs::SkipList::FailedComparison if the value does not compare equal to itself,
+             * for example NaN, or an OrderedStructs::SkipList::ValueError if the timestamp is NaN or before the
+             * previous timestamp. In either case the window is unchanged.
+             *
+             * @param timestamp The timestamp of the new value.
+             * @param value The new value.
+             * @return The median of the window including the new value.
+             */
+            T push(const TS &timestamp, const T &value) {
+                if (value != value) {
+                    throw SkipList::FailedComparison(
+                        "Can not work with something that does not compare equal to itself.");
+                }
+                _check_timestamp(timestamp);
+                if (! _samples.empty() && timestamp < _samples.back().first) {
+                    throw SkipList::ValueError("Timestamps must not decrease.");
+                }
+                evict(timestamp);
+                _samples.emplace_back(timestamp, value);
+                _sl.insert(value);
+                return median();
+            }
+            /**
+             * Evict the values that have left the window at the given time, this is useful if there is a gap in the
+             * data. push() calls this.
+             * Will throw an OrderedStructs::SkipList::ValueError if the timestamp is NaN.
+             *
+             * @param timestamp The current time.
+             * @return The number of values evicted.
+             */
+            size_t evict(const TS &timestamp) {
+                _check_timestamp(timestamp);
+                size_t evicted = 0;
+                while (! _samples.empty() && ! (timestamp < _samples.front().first)
+                       && ! (timestamp - _samples.front().first < _duration)) {
+                    _sl.remove(_samples.front().second);
+                    _samples.pop_front();
+                    ++evicted;
+                }
+                return evicted;
+            }
+            /**
+             * The median of the current window.
+             * Will throw an OrderedStructs::SkipList::IndexError if the window is empty.
+             *
+             * @return The median.
+             */
+            T median() const {
+                return _median_of_all(_sl, _buffer);
+            }
+            /// The number of values in the window.
+            size_t size() const {
+                return _sl.size();
+            }
+            /// The duration of the window.
+            const TS &duration() const {
+                return _duration;
+            }
+        private:
+            /// Throw a ValueError if the timestamp does not compare equal to itself, for example NaN.
+            static void _check_timestamp(const TS &timestamp) {
+                if (timestamp != timestamp) {
+                    throw SkipList::ValueError("Timestamps must compare equal to themselves.");
+                }
+            }
+            /// The duration of the window.
+            TS _duration;
+            /// The timestamps and values in arrival order, these are the pending evictions.
+            std::deque<std::pair<TS, T>> _samples;
+            /// The values in the window in sorted order.
+            SkipList::HeadNode<T> _sl;
+            /// Working space for the two central values of an even window.
+            mutable std::vector<T> _buffer;
+        };
+
     } // namespace RollingMedian
 } // namespace OrderedStructs
 
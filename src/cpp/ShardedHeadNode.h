@@ -0,0 +1,419 @@
+//
+//  ShardedHeadNode.h
+//  SkipList
+//
+
+#ifndef SkipList_ShardedHeadNode_h
+#define SkipList_ShardedHeadNode_h
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/// A shard is rebalanced when it holds this many more values than the mean plus half the mean.
+        const size_t SHARDED_HEADNODE_REBALANCE_MIN = 1024;
+/// The skew is checked when the count of the modified shard is a multiple of this, to avoid reading every shard count.
+        const size_t SHARDED_HEADNODE_CHECK_INTERVAL = 64;
+
+/**
+ * @brief One logical ordered collection, that allows duplicates, partitioned into value ranges for many writers.
+ *
+ * Each of the S shards is a HeadNode with its own mutex that holds the values in the range
+ * <tt>[bounds[s - 1], bounds[s])</tt>. Inserts and removes lock only the shard that the value belongs to so writers
+ * into different shards do not contend. The HeadNodes do not use the global mutex.
+ *
+ * Global rank queries, at() and index(), lock every shard in order, sum the shard counts into a prefix count array to
+ * find the shard then ask that shard. This is O(S + log(n)) and, as every shard is locked at once, is linearizable.
+ *
+ * Initially there are no bounds and every value is in shard zero. When an insert or remove leaves a shard with more
+ * than one and a half times its share of the values (plus SHARDED_HEADNODE_REBALANCE_MIN) the bounds are recomputed
+ * from the quantiles of all the values. The values are redistributed by joining the shards and splitting them again at
+ * the new bounds, this is O(S log(n)) and is done by one thread whilst it holds every shard lock. Other threads wait on
+ * their shard lock then carry on with the new bounds.
+ * Equal values must share a shard so a heavily repeated value can keep one shard large whatever the bounds. The new
+ * bounds are found first, in O(S log(n)), and the values are only redistributed if that takes at least a half share
+ * off the largest shard.
+ *
+ * Values that do not compare equal to themselves, such as NaN, are rejected with a FailedComparison exception.
+ *
+ * @tparam T The type of the values, it must be copy constructible.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class ShardedHeadNode {
+        public:
+            explicit ShardedHeadNode(size_t shard_count, Compare cmp=Compare());
+            ShardedHeadNode(const ShardedHeadNode &) = delete;
+            ShardedHeadNode &operator=(const ShardedHeadNode &) = delete;
+
+            // Returns true if the value is present.
+            bool has(const T &value) const;
+            // Returns a copy of the value at the index.
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            T at(size_t index) const;
+            // Computes index of the first occurrence of a value.
+            // Will throw a ValueError if the value does not exist.
+            size_t index(const T &value) const;
+            // Number of values, this is exact when there are no concurrent writers.
+            size_t size() const;
+            // Insert a value.
+            void insert(const T &value);
+            // Remove a value and return it.
+            // Will throw a ValueError is value not present.
+            T remove(const T &value);
+            // Number of shards.
+            size_t shard_count() const {
+                return _shards.size();
+            }
+            // Number of values in one shard.
+            size_t shard_size(size_t shard) const {
+                return _shards.at(shard)->count.load(std::memory_order_relaxed);
+            }
+            // Recompute the bounds from the current values and redistribute them.
+            void rebalance();
+            // Check each shard and that every value is within the bounds of its shard.
+            IntegrityCheck lacksIntegrity() const;
+        protected:
+            /// A shard on its own cache line so that writers to different shards do not share one.
+            struct alignas(64) Shard {
+                Shard(Compare cmp) : list(new HeadNode<T, Compare>(cmp, false)), count(0) {}
+                mutable std::mutex mutex;
+                std::unique_ptr<HeadNode<T, Compare>> list;
+                /// Mirror of list->size() that can be read without the lock.
+                std::atomic<size_t> count;
+            };
+            // Lock the shard that the value belongs to, the bounds can change until the shard is locked.
+            std::unique_lock<std::mutex> _lock_shard(const T &value, size_t &shard) const;
+            // Returns true if the value is within the bounds of the shard, the shard must be locked.
+            bool _in_shard(const T &value, size_t shard) const {
+                return (shard == 0 || !_compare(value, _bounds[shard - 1])) &&
+                       (shard == _bounds.size() || _compare(value, _bounds[shard]));
+            }
+            // Lock every shard in order.
+            std::vector<std::unique_lock<std::mutex>> _lock_all() const;
+            // Find the bounds at the quantiles of the values and return the size of the largest shard with those bounds.
+            size_t _balanced_bounds(std::vector<T> &bounds) const;
+            // Redistribute the values with the new bounds, every shard must be locked.
+            void _rebalance_locked(std::vector<T> &bounds);
+            // Returns the size of the largest shard.
+            size_t _largest_shard_size() const;
+            // Returns true if the largest shard holds too many values.
+            bool _is_skewed() const;
+            // Rebalance if the shard count is a multiple of SHARDED_HEADNODE_CHECK_INTERVAL and it is skewed.
+            void _rebalance_if_skewed(size_t modified_count);
+            void _throwIfValueDoesNotCompare(const T &value) const {
+                if (value != value) {
+                    throw FailedComparison(
+                        "Can not work with something that does not compare equal to itself.");
+                }
+            }
+            /// The shards, this never changes size.
+            std::vector<std::unique_ptr<Shard>> _shards;
+            /// The bounds, empty or one less than the number of shards.
+            /// These only change whilst every shard is locked so the holder of a shard lock can read them.
+            std::vector<T> _bounds;
+            /// Guards the whole of _bounds when searching or changing it.
+            mutable std::shared_mutex _bounds_mutex;
+            /// Set whilst a thread is rebalancing.
+            std::atomic<bool> _rebalancing;
+            /// Comparison function.
+            Compare _compare;
+        };
+
+        template <typename T, typename Compare>
+        ShardedHeadNode<T, Compare>::ShardedHeadNode(size_t shard_count, Compare cmp) :
+                _shards(), _bounds(), _rebalancing(false), _compare(cmp) {
+            if (shard_count == 0) {
+                throw ValueError("ShardedHeadNode must have at least one shard.");
+            }
+            for (size_t s = 0; s < shard_count; ++s) {
+                _shards.emplace_back(new Shard(cmp));
+            }
+        }
+
+/**
+ * Lock the shard that the value belongs to.
+ * The shard is found from the bounds under the shared lock, then once the shard is locked its two bounds can not
+ * change so they are checked again. If a rebalance moved them in between this tries again.
+ *
+ * @param value The value.
+ * @param shard Set to the index of the locked shard.
+ * @return The lock on the shard.
+ */
+        template <typename T, typename Compare>
+        std::unique_lock<std::mutex> ShardedHeadNode<T, Compare>::_lock_shard(const T &value, size_t &shard) const {
+            while (true) {
+                {
+                    std::shared_lock<std::shared_mutex> bounds_lock(_bounds_mutex);
+                    shard = std::upper_bound(_bounds.begin(), _bounds.end(), value, _compare) - _bounds.begin();
+                }
+                std::unique_lock<std::mutex> lock(_shards[shard]->mutex);
+                if (_in_shard(value, shard)) {
+                    return lock;
+                }
+            }
+        }
+
+        template <typename T, typename Compare>
+        std::vector<std::unique_lock<std::mutex>> ShardedHeadNode<T, Compare>::_lock_all() const {
+            std::vector<std::unique_lock<std::mutex>> locks;
+            locks.reserve(_shards.size());
+            for (const auto &shard: _shards) {
+                locks.emplace_back(shard->mutex);
+            }
+            return locks;
+        }
+
+        template <typename T, typename Compare>
+        bool ShardedHeadNode<T, Compare>::has(const T &value) const {
+            _throwIfValueDoesNotCompare(value);
+            size_t shard;
+            std::unique_lock<std::mutex> lock = _lock_shard(value, shard);
+            return _shards[shard]->list->has(value);
+        }
+
+/**
+ * Returns a copy of the value at a particular index, a reference could be invalidated by a concurrent remove().
+ * Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+ *
+ * @param index The index.
+ * @return The value at that index.
+ */
+        template <typename T, typename Compare>
+        T ShardedHeadNode<T, Compare>::at(size_t index) const {
+            std::vector<std::unique_lock<std::mutex>> locks = _lock_all();
+            std::vector<size_t> prefix_counts(_shards.size());
+            size_t total = 0;
+            for (size_t s = 0; s < _shards.size(); ++s) {
+                total += _shards[s]->list->size();
+                prefix_counts[s] = total;
+            }
+            if (index >= total) {
+                _throw_exceeds_size(total);
+            }
+            size_t shard = std::upper_bound(prefix_counts.begin(), prefix_counts.end(), index) - prefix_counts.begin();
+            return _shards[shard]->list->at(index - (prefix_counts[shard] - _shards[shard]->list->size()));
+        }
+
+/**
+ * Finds the index of the first occurrence of a value.
+ * Will throw a OrderedStructs::SkipList::ValueError if the value does not exist.
+ *
+ * @param value The value to search for.
+ * @return The index.
+ */
+        template <typename T, typename Compare>
+        size_t ShardedHeadNode<T, Compare>::index(const T &value) const {
+            _throwIfValueDoesNotCompare(value);
+            std::vector<std::unique_lock<std::mutex>> locks = _lock_all();
+            // All values equal to a bound are in the shard above so the first occurrence is in this shard.
+            size_t shard = std::upper_bound(_bounds.begin(), _bounds.end(), value, _compare) - _bounds.begin();
+            size_t result = _shards[shard]->list->index(value);
+            for (size_t s = 0; s < shard; ++s) {
+                result += _shards[s]->list->size();
+            }
+            return result;
+        }
+
+        template <typename T, typename Compare>
+        size_t ShardedHeadNode<T, Compare>::size() const {
+            size_t result = 0;
+            for (const auto &shard: _shards) {
+                result += shard->count.load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        template <typename T, typename Compare>
+        void ShardedHeadNode<T, Compare>::insert(const T &value) {
+            _throwIfValueDoesNotCompare(value);
+            size_t shard;
+            std::unique_lock<std::mutex> lock = _lock_shard(value, shard);
+            _shards[shard]->list->insert(value);
+            size_t count = _shards[shard]->list->size();
+            _shards[shard]->count.store(count, std::memory_order_relaxed);
+            lock.unlock();
+            _rebalance_if_skewed(count);
+        }
+
+        template <typename T, typename Compare>
+        T ShardedHeadNode<T, Compare>::remove(const T &value) {
+            _throwIfValueDoesNotCompare(value);
+            size_t shard;
+            std::unique_lock<std::mutex> lock = _lock_shard(value, shard);
+            T result = _shards[shard]->list->remove(value);
+            size_t count = _shards[shard]->list->size();
+            _shards[shard]->count.store(count, std::memory_order_relaxed);
+            lock.unlock();
+            // Removes from one shard can leave another with more than its share.
+            _rebalance_if_skewed(count);
+            return result;
+        }
+
+        template <typename T, typename Compare>
+        size_t ShardedHeadNode<T, Compare>::_largest_shard_size() const {
+            size_t largest = 0;
+            for (const auto &shard: _shards) {
+                largest = std::max(largest, shard->count.load(std::memory_order_relaxed));
+            }
+            return largest;
+        }
+
+/**
+ * Returns true if the largest shard holds more than one and a half times the mean plus SHARDED_HEADNODE_REBALANCE_MIN.
+ */
+        template <typename T, typename Compare>
+        bool ShardedHeadNode<T, Compare>::_is_skewed() const {
+            size_t mean = size() / _shards.size();
+            return _largest_shard_size() > mean + mean / 2 + SHARDED_HEADNODE_REBALANCE_MIN;
+        }
+
+/**
+ * Rebalance if the shards are skewed. This is only checked when the count of the shard that has just been modified is
+ * a multiple of SHARDED_HEADNODE_CHECK_INTERVAL so that writers rarely read the counts of the other shards.
+ * If another thread is already rebalancing this does nothing.
+ * If the new bounds would not take at least half a share off the largest shard, because it is mostly equal values,
+ * the values are not redistributed.
+ *
+ * @param modified_count The count of the shard that has just been modified.
+ */
+        template <typename T, typename Compare>
+        void ShardedHeadNode<T, Compare>::_rebalance_if_skewed(size_t modified_count) {
+            if (_shards.size() == 1 || modified_count % SHARDED_HEADNODE_CHECK_INTERVAL || !_is_skewed()) {
+                return;
+            }
+            bool expected = false;
+            if (_rebalancing.compare_exchange_strong(expected, true)) {
+                std::vector<std::unique_lock<std::mutex>> locks = _lock_all();
+                // Check again now that no writer is running.
+                if (_is_skewed()) {
+                    std::vector<T> bounds;
+                    size_t largest = _balanced_bounds(bounds);
+                    if (largest + size() / _shards.size() / 2 <= _largest_shard_size()) {
+                        _rebalance_locked(bounds);
+                    }
+                }
+                _rebalancing = false;
+            }
+        }
+
+        template <typename T, typename Compare>
+        void ShardedHeadNode<T, Compare>::rebalance() {
+            std::vector<std::unique_lock<std::mutex>> locks = _lock_all();
+            std::vector<T> bounds;
+            _balanced_bounds(bounds);
+            _rebalance_locked(bounds);
+        }
+
+/**
+ * Make the bounds the 1/S, 2/S ... quantiles of the values and find the size of the largest shard with those bounds.
+ * Equal values must all be in the same shard so a bound equal to the previous one gives an empty shard.
+ * This is O(S log(n)), the values are not copied. Every shard must be locked.
+ *
+ * @param bounds Set to the new bounds, empty if there are no values.
+ * @return The size of the largest shard with the new bounds.
+ */
+        template <typename T, typename Compare>
+        size_t ShardedHeadNode<T, Compare>::_balanced_bounds(std::vector<T> &bounds) const {
+            std::vector<size_t> prefix_counts(_shards.size());
+            size_t total = 0;
+            for (size_t s = 0; s < _shards.size(); ++s) {
+                total += _shards[s]->list->size();
+                prefix_counts[s] = total;
+            }
+            bounds.clear();
+            if (total == 0) {
+                return 0;
+            }
+            bounds.reserve(_shards.size() - 1);
+            size_t largest = 0;
+            // The number of values less than the previous bound.
+            size_t previous_rank = 0;
+            for (size_t s = 1; s < _shards.size(); ++s) {
+                size_t index = s * total / _shards.size();
+                size_t shard = std::upper_bound(prefix_counts.begin(), prefix_counts.end(), index) - prefix_counts.begin();
+                const HeadNode<T, Compare> &list = *_shards[shard]->list;
+                size_t shard_begin = prefix_counts[shard] - list.size();
+                bounds.push_back(list.at(index - shard_begin));
+                // All the values equal to the bound are in this shard so this is the number of values less than it.
+                size_t rank = shard_begin + list.index(bounds.back());
+                largest = std::max(largest, rank - previous_rank);
+                previous_rank = rank;
+            }
+            return std::max(largest, total - previous_rank);
+        }
+
+/**
+ * Set the new bounds then join every shard into the first and split it again at the new bounds. Only the references
+ * along the joins and the splits are relinked so this is O(S log(n)), no value is copied or compared with another.
+ * Every shard must be locked.
+ *
+ * @param bounds The new bounds from _balanced_bounds(), this is moved from.
+ */
+        template <typename T, typename Compare>
+        void ShardedHeadNode<T, Compare>::_rebalance_locked(std::vector<T> &bounds) {
+            if (bounds.empty()) {
+                return;
+            }
+            for (size_t s = 1; s < _shards.size(); ++s) {
+                _shards[0]->list->join(*_shards[s]->list);
+            }
+            {
+                std::unique_lock<std::shared_mutex> bounds_lock(_bounds_mutex);
+                _bounds = std::move(bounds);
+            }
+            // From the top so that each split takes the values from a bound upwards.
+            for (size_t s = _shards.size(); s-- > 1;) {
+                _shards[s]->list = _shards[0]->list->split_at_value(_bounds[s - 1]);
+            }
+            for (const auto &shard: _shards) {
+                shard->count.store(shard->list->size(), std::memory_order_relaxed);
+            }
+        }
+
+/**
+ * Check the integrity of every shard, that the bounds are in order and that every value is in the right shard.
+ * There must be no concurrent operations.
+ *
+ * @return INTEGRITY_SUCCESS or an IntegrityCheck error code.
+ */
+        template <typename T, typename Compare>
+        IntegrityCheck ShardedHeadNode<T, Compare>::lacksIntegrity() const {
+            std::vector<std::unique_lock<std::mutex>> locks = _lock_all();
+            if (!_bounds.empty() && _bounds.size() + 1 != _shards.size()) {
+                return HEADNODE_COUNT_MISMATCH;
+            }
+            for (size_t s = 1; s < _bounds.size(); ++s) {
+                if (_compare(_bounds[s], _bounds[s - 1])) {
+                    return HEADNODE_DETECTS_OUT_OF_ORDER;
+                }
+            }
+            for (size_t s = 0; s < _shards.size(); ++s) {
+                const HeadNode<T, Compare> &list = *_shards[s]->list;
+                IntegrityCheck result = list.lacksIntegrity();
+                if (result) {
+                    return result;
+                }
+                if (list.size() != _shards[s]->count.load()) {
+                    return HEADNODE_COUNT_MISMATCH;
+                }
+                if (list.size() && (!_in_shard(list.at(0), s) || !_in_shard(list.at(list.size() - 1), s))) {
+                    return HEADNODE_DETECTS_OUT_OF_ORDER;
+                }
+            }
+            return INTEGRITY_SUCCESS;
+        }
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_ShardedHeadNode_h
@@ -6,6 +6,7 @@
 //  Copyright (c) 2017 Paul Ross. All rights reserved.
 //
 
+#include <cstdint>
 #include <cstdlib>
 #ifdef SKIPLIST_THREAD_SUPPORT
 #include <mutex>
@@ -67,6 +68,21 @@ void seedRand(unsigned seed) {
     srand(seed);
 }
 
+size_t randomHeight(size_t max_height) {
+    // xorshift64, seeded from the address of the thread local so each thread has its own sequence.
+    static thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    size_t height = 1;
+    uint64_t bits = state;
+    while ((bits & 1) && height < max_height) {
+        ++height;
+        bits >>= 1;
+    }
+    return height;
+}
+
 // This throws an IndexError when the index value >= size.
 // If possible the error will have an informative message.
 #ifdef INCLUDE_METHODS_THAT_USE_STREAMS
@@ -325,7 +325,10 @@
  *
  * Optimisation: Reuse removed nodes for insert()
  * ----------------------------------------------
- * @todo Reuse removed nodes for insert() ???
+ * HeadNode::set_node_reuse() keeps up to a given number of removed Nodes and insert() then reuses them, re-tossing
+ * the coin for their height. The Node's SwappableNodeRefStack keeps its storage so in the steady state of a rolling
+ * median (one remove() and one insert() per value) there is no memory allocation at all.
+ * This is off by default, RollingMedian::RollingMedian uses it with one spare Node.
  *
  * Reference Counting
  * ------------------
@@ -535,6 +538,12 @@ namespace OrderedStructs {
         /** Seed the random number generator for coin tosses. */
         void seedRand(unsigned seed);
 
+        /**
+         * A geometric random height with probability 1/2 of growing, capped at max_height.
+         * This uses a thread local generator so, unlike tossCoin(), it can be called concurrently without sharing state.
+         */
+        size_t randomHeight(size_t max_height);
+
 #ifdef SKIPLIST_THREAD_SUPPORT
         /**
          * Mutex used in a multi-threaded environment.
@@ -0,0 +1,385 @@
+//
+//  SnapshotList.h
+//  SkipList
+//
+
+#ifndef SkipList_SnapshotList_h
+#define SkipList_SnapshotList_h
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/// A block is split in two when it reaches this many values.
+        const size_t SNAPSHOT_LIST_MAX_BLOCK = 1024;
+
+/**
+ * @brief An ordered list, that allows duplicates, with the HeadNode interface plus snapshot() for consistent reads
+ * whilst writers carry on.
+ *
+ * A HeadNode can not give cheap snapshots, each node is linked from the towers of many predecessors so copying one node
+ * on write means copying all of them. Instead this holds the values in sorted blocks of up to SNAPSHOT_LIST_MAX_BLOCK
+ * values, referenced from a table with the prefix counts of the blocks. Both the table and the blocks are reference
+ * counted and copied on write:
+ *
+ * - snapshot() just takes a reference to the current table and advances a generation counter, this is O(1).
+ * - The table and each block record the generation they were created in. A write copies the table, O(n / B), and the
+ *   block it modifies, O(B), only if they are older than the latest snapshot. Otherwise it modifies them in place.
+ * - A snapshot is immutable so reading it needs no lock, at() and index() are O(log(n)) with the prefix counts.
+ * - When the last snapshot referencing a table or block is released it is freed.
+ *
+ * All the methods of the list itself lock a mutex that snapshot() holds only whilst it copies one pointer so readers of
+ * snapshots never block a writer. The list does not use the global mutex.
+ *
+ * Values that do not compare equal to themselves, such as NaN, are rejected with a FailedComparison exception.
+ *
+ * @tparam T The type of the values, it must be copy constructible.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class SnapshotList {
+        protected:
+            /// A sorted run of values.
+            typedef std::vector<T> Block;
+            /// One version of the list.
+            struct Table {
+                std::vector<std::shared_ptr<Block>> blocks;
+                /// prefix_counts[k] is the number of values in blocks [0, k].
+                std::vector<size_t> prefix_counts;
+                /// generations[k] is the generation that blocks[k] was created in.
+                std::vector<size_t> generations;
+            };
+        public:
+            /**
+             * @brief A read-only, point-in-time view of a SnapshotList.
+             *
+             * This can be read from any thread without a lock and is unaffected by later writes to the list.
+             */
+            class Snapshot {
+            public:
+                // Returns true if the value is present.
+                bool has(const T &value) const;
+                // Returns the value at the index.
+                // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+                const T &at(size_t index) const;
+                // Find the value at index and write count values to dest.
+                // Will throw an OrderedStructs::SkipList::IndexError if any index out of range.
+                void at(size_t index, size_t count, std::vector<T> &dest) const;
+                // Computes index of the first occurrence of a value.
+                // Will throw a ValueError if the value does not exist.
+                size_t index(const T &value) const;
+                // Number of values.
+                size_t size() const {
+                    return _table->prefix_counts.empty() ? 0 : _table->prefix_counts.back();
+                }
+            private:
+                friend class SnapshotList;
+                Snapshot(std::shared_ptr<const Table> table, Compare cmp) : _table(std::move(table)), _compare(cmp) {}
+                std::shared_ptr<const Table> _table;
+                Compare _compare;
+            };
+
+            explicit SnapshotList(Compare cmp=Compare()) : _table(std::make_shared<Table>()), _table_generation(0),
+                                                           _generation(0), _compare(cmp) {}
+            SnapshotList(const SnapshotList &) = delete;
+            SnapshotList &operator=(const SnapshotList &) = delete;
+
+            // Returns true if the value is present.
+            bool has(const T &value) const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _current().has(value);
+            }
+            // Returns a copy of the value at the index, a reference could be invalidated by a concurrent remove().
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            T at(size_t index) const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _current().at(index);
+            }
+            // Computes index of the first occurrence of a value.
+            // Will throw a ValueError if the value does not exist.
+            size_t index(const T &value) const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _current().index(value);
+            }
+            // Number of values.
+            size_t size() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _current().size();
+            }
+            // Insert a value after any equal values.
+            void insert(const T &value);
+            // Remove the first occurrence of a value and return it.
+            // Will throw a ValueError is value not present.
+            T remove(const T &value);
+            // A read-only view of the list as it is now.
+            Snapshot snapshot() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_generation;
+                return Snapshot(_table, _compare);
+            }
+            // Check the order of the values and the prefix counts.
+            IntegrityCheck lacksIntegrity() const;
+        protected:
+            // A view of the current table that must not outlive the lock on the mutex.
+            Snapshot _current() const {
+                return Snapshot(_table, _compare);
+            }
+            // Copy the table if a snapshot might hold it, the mutex must be held.
+            void _make_table_writable();
+            // Copy the block if a snapshot might hold it, the mutex must be held.
+            void _make_block_writable(size_t block);
+            // Add delta to the prefix counts from the block onwards.
+            void _adjust_prefix_counts(size_t block, long delta);
+            void _throwIfValueDoesNotCompare(const T &value) const {
+                if (value != value) {
+                    throw FailedComparison(
+                        "Can not work with something that does not compare equal to itself.");
+                }
+            }
+            /// The current version, only modified in place if no snapshot has been taken since it was created.
+            std::shared_ptr<Table> _table;
+            /// The generation that _table was created in.
+            size_t _table_generation;
+            /// Number of snapshots taken.
+            mutable size_t _generation;
+            /// Guards _table and the generations.
+            mutable std::mutex _mutex;
+            /// Comparison function.
+            Compare _compare;
+        };
+
+/**
+ * Returns true if the value is present.
+ *
+ * @param value The value to search for.
+ * @return true if present.
+ */
+        template <typename T, typename Compare>
+        bool SnapshotList<T, Compare>::Snapshot::has(const T &value) const {
+            const auto &blocks = _table->blocks;
+            // First block whose last value is not less than value.
+            auto iter = std::lower_bound(blocks.begin(), blocks.end(), value,
+                                         [this](const std::shared_ptr<Block> &block, const T &v) {
+                                             return _compare(block->back(), v);
+                                         });
+            if (iter == blocks.end()) {
+                return false;
+            }
+            auto pos = std::lower_bound((*iter)->begin(), (*iter)->end(), value, _compare);
+            return pos != (*iter)->end() && !_compare(value, *pos);
+        }
+
+/**
+ * Returns the value at a particular index.
+ * Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+ *
+ * @param index The index.
+ * @return The value at that index.
+ */
+        template <typename T, typename Compare>
+        const T &SnapshotList<T, Compare>::Snapshot::at(size_t index) const {
+            const auto &prefix_counts = _table->prefix_counts;
+            if (index >= size()) {
+                _throw_exceeds_size(size());
+            }
+            size_t block = std::upper_bound(prefix_counts.begin(), prefix_counts.end(), index) - prefix_counts.begin();
+            return (*_table->blocks[block])[index - (block ? prefix_counts[block - 1] : 0)];
+        }
+
+/**
+ * Find the value at index and write count values to dest.
+ * Will throw an OrderedStructs::SkipList::IndexError if any index out of range.
+ *
+ * @param index The index of the first value.
+ * @param count The number of values.
+ * @param dest The vector of values, this is cleared first.
+ */
+        template <typename T, typename Compare>
+        void SnapshotList<T, Compare>::Snapshot::at(size_t index, size_t count, std::vector<T> &dest) const {
+            dest.clear();
+            if (index + count > size()) {
+                _throw_exceeds_size(size());
+            }
+            dest.reserve(count);
+            const auto &prefix_counts = _table->prefix_counts;
+            size_t block = std::upper_bound(prefix_counts.begin(), prefix_counts.end(), index) - prefix_counts.begin();
+            size_t offset = index - (block ? prefix_counts[block - 1] : 0);
+            while (count) {
+                const Block &values = *_table->blocks[block];
+                size_t n = std::min(count, values.size() - offset);
+                dest.insert(dest.end(), values.begin() + offset, values.begin() + offset + n);
+                count -= n;
+                offset = 0;
+                ++block;
+            }
+        }
+
+/**
+ * Finds the index of the first occurrence of a value.
+ * Will throw a OrderedStructs::SkipList::ValueError if the value does not exist.
+ *
+ * @param value The value to search for.
+ * @return The index.
+ */
+        template <typename T, typename Compare>
+        size_t SnapshotList<T, Compare>::Snapshot::index(const T &value) const {
+            const auto &blocks = _table->blocks;
+            auto iter = std::lower_bound(blocks.begin(), blocks.end(), value,
+                                         [this](const std::shared_ptr<Block> &block, const T &v) {
+                                             return _compare(block->back(), v);
+                                         });
+            if (iter != blocks.end()) {
+                auto pos = std::lower_bound((*iter)->begin(), (*iter)->end(), value, _compare);
+                if (pos != (*iter)->end() && !_compare(value, *pos)) {
+                    size_t block = iter - blocks.begin();
+                    return (block ? _table->prefix_counts[block - 1] : 0) + (pos - (*iter)->begin());
+                }
+            }
+#ifdef INCLUDE_METHODS_THAT_USE_STREAMS
+            std::ostringstream oss;
+            oss << "Value " << value << " not found.";
+            std::string err_msg = oss.str();
+#else
+            std::string err_msg = "Value not found.";
+#endif
+            throw ValueError(err_msg);
+        }
+
+/**
+ * A table or block created since the latest snapshot can not be referenced by any snapshot so it can be modified in
+ * place. This does not use shared_ptr::use_count() as that gives no ordering with the release by a reader in another
+ * thread.
+ */
+        template <typename T, typename Compare>
+        void SnapshotList<T, Compare>::_make_table_writable() {
+            if (_table_generation != _generation) {
+                _table = std::make_shared<Table>(*_table);
+                _table_generation = _generation;
+            }
+        }
+
+        template <typename T, typename Compare>
+        void SnapshotList<T, Compare>::_make_block_writable(size_t block) {
+            if (_table->generations[block] != _generation) {
+                _table->blocks[block] = std::make_shared<Block>(*_table->blocks[block]);
+                _table->generations[block] = _generation;
+            }
+        }
+
+        template <typename T, typename Compare>
+        void SnapshotList<T, Compare>::_adjust_prefix_counts(size_t block, long delta) {
+            for (size_t k = block; k < _table->prefix_counts.size(); ++k) {
+                _table->prefix_counts[k] += delta;
+            }
+        }
+
+/**
+ * Insert a value after any equal values. If the block becomes full it is split in two.
+ *
+ * @param value The value to insert.
+ */
+        template <typename T, typename Compare>
+        void SnapshotList<T, Compare>::insert(const T &value) {
+            _throwIfValueDoesNotCompare(value);
+            std::lock_guard<std::mutex> lock(_mutex);
+            _make_table_writable();
+            auto &blocks = _table->blocks;
+            if (blocks.empty()) {
+                blocks.push_back(std::make_shared<Block>(1, value));
+                _table->prefix_counts.push_back(1);
+                _table->generations.push_back(_generation);
+                return;
+            }
+            // First block whose last value is greater than value, otherwise the last block.
+            size_t block = std::upper_bound(blocks.begin(), blocks.end(), value,
+                                            [this](const T &v, const std::shared_ptr<Block> &b) {
+                                                return _compare(v, b->back());
+                                            }) - blocks.begin();
+            block = std::min(block, blocks.size() - 1);
+            _make_block_writable(block);
+            Block &values = *blocks[block];
+            values.insert(std::upper_bound(values.begin(), values.end(), value, _compare), value);
+            _adjust_prefix_counts(block, 1);
+            if (values.size() >= SNAPSHOT_LIST_MAX_BLOCK) {
+                auto upper = std::make_shared<Block>(values.begin() + values.size() / 2, values.end());
+                values.erase(values.begin() + values.size() / 2, values.end());
+                blocks.insert(blocks.begin() + block + 1, upper);
+                _table->generations.insert(_table->generations.begin() + block + 1, _generation);
+                _table->prefix_counts.insert(_table->prefix_counts.begin() + block,
+                                             _table->prefix_counts[block] - upper->size());
+            }
+        }
+
+/**
+ * Remove the first occurrence of a value. If the block becomes empty it is removed.
+ * Will throw a OrderedStructs::SkipList::ValueError if the value does not exist.
+ *
+ * @param value The value to remove.
+ * @return The value removed.
+ */
+        template <typename T, typename Compare>
+        T SnapshotList<T, Compare>::remove(const T &value) {
+            _throwIfValueDoesNotCompare(value);
+            std::lock_guard<std::mutex> lock(_mutex);
+            // Find it in a snapshot of the current table, this throws if absent before anything is copied.
+            size_t index = _current().index(value);
+            _make_table_writable();
+            auto &prefix_counts = _table->prefix_counts;
+            size_t block = std::upper_bound(prefix_counts.begin(), prefix_counts.end(), index) - prefix_counts.begin();
+            _make_block_writable(block);
+            Block &values = *_table->blocks[block];
+            auto pos = values.begin() + (index - (block ? prefix_counts[block - 1] : 0));
+            T result = *pos;
+            values.erase(pos);
+            _adjust_prefix_counts(block, -1);
+            if (values.empty()) {
+                _table->blocks.erase(_table->blocks.begin() + block);
+                prefix_counts.erase(prefix_counts.begin() + block);
+                _table->generations.erase(_table->generations.begin() + block);
+            }
+            return result;
+        }
+
+/**
+ * Check that no block is empty, the values are in order across all blocks and the prefix counts are correct.
+ *
+ * @return INTEGRITY_SUCCESS or an IntegrityCheck error code.
+ */
+        template <typename T, typename Compare>
+        IntegrityCheck SnapshotList<T, Compare>::lacksIntegrity() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            const auto &blocks = _table->blocks;
+            if (blocks.size() != _table->prefix_counts.size() || blocks.size() != _table->generations.size()) {
+                return HEADNODE_COUNT_MISMATCH;
+            }
+            size_t total = 0;
+            const T *previous = nullptr;
+            for (size_t k = 0; k < blocks.size(); ++k) {
+                if (blocks[k]->empty()) {
+                    return HEADNODE_CONTAINS_NULL;
+                }
+                for (const T &value: *blocks[k]) {
+                    if (previous && _compare(value, *previous)) {
+                        return HEADNODE_DETECTS_OUT_OF_ORDER;
+                    }
+                    previous = &value;
+                }
+                total += blocks[k]->size();
+                if (_table->prefix_counts[k] != total) {
+                    return HEADNODE_LEVEL_WIDTHS_MISMATCH;
+                }
+            }
+            return INTEGRITY_SUCCESS;
+        }
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_SnapshotList_h
@@ -0,0 +1,140 @@
+//
+//  SortedWindow.h
+//  SkipList
+//
+
+#ifndef SkipList_SortedWindow_h
+#define SkipList_SortedWindow_h
+
+#include <algorithm>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace RollingMedian {
+
+/**
+ * @brief A sorted contiguous array with the same insert()/remove()/at() interface as a SkipList::HeadNode.
+ *
+ * For small windows this is faster than a Skip List as insert() and remove() are a binary search followed by a shift
+ * of the contiguous values which, for trivially copyable types, is a memmove(). This avoids the pointer chasing and
+ * node allocation of the Skip List but is O(n) so it is only used below a threshold window length, see
+ * SORTED_WINDOW_MAX_WIN_LENGTH.
+ *
+ * Duplicate values are inserted after the last same value, as the Skip List does, so the results are identical.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class SortedWindow {
+        public:
+            /**
+             * Constructor, the storage for capacity values is allocated up front.
+             *
+             * @param capacity The expected maximum number of values, typically the window length.
+             * @param cmp The comparison function for comparing values.
+             */
+            explicit SortedWindow(size_t capacity, Compare cmp=Compare()) : _compare(cmp) {
+                _values.reserve(capacity);
+            }
+            // Insert a value.
+            // Will throw an OrderedStructs::SkipList::FailedComparison if value != value, for example NaN.
+            void insert(const T &value);
+            // Remove a value and return it.
+            // Will throw an OrderedStructs::SkipList::ValueError if the value is not present.
+            T remove(const T &value);
+            // Returns the value at the index.
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            const T &at(size_t index) const;
+            // Find the value at index and write count values to dest.
+            // Will throw an OrderedStructs::SkipList::IndexError if any index out of range.
+            void at(size_t index, size_t count, std::vector<T> &dest) const;
+            // Number of values.
+            size_t size() const {
+                return _values.size();
+            }
+        protected:
+            /// The values in sorted order.
+            std::vector<T> _values;
+            /// Comparison function.
+            Compare _compare;
+        };
+
+/**
+ * Insert a value after any existing equal values.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @param value The value to insert.
+ */
+        template <typename T, typename Compare>
+        void SortedWindow<T, Compare>::insert(const T &value) {
+            if (value != value) {
+                throw SkipList::FailedComparison(
+                    "Can not work with something that does not compare equal to itself.");
+            }
+            _values.insert(std::upper_bound(_values.begin(), _values.end(), value, _compare), value);
+        }
+
+/**
+ * Remove a value.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @param value The value to remove.
+ * @return The value removed.
+ */
+        template <typename T, typename Compare>
+        T SortedWindow<T, Compare>::remove(const T &value) {
+            if (value != value) {
+                throw SkipList::FailedComparison(
+                    "Can not work with something that does not compare equal to itself.");
+            }
+            auto iter = std::lower_bound(_values.begin(), _values.end(), value, _compare);
+            if (iter == _values.end() || _compare(value, *iter)) {
+                throw SkipList::ValueError("Value not found.");
+            }
+            T ret_val = *iter;
+            _values.erase(iter);
+            return ret_val;
+        }
+
+/**
+ * Returns the value at a particular index.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @param index The index.
+ * @return The value at that index.
+ */
+        template <typename T, typename Compare>
+        const T &SortedWindow<T, Compare>::at(size_t index) const {
+            if (index >= _values.size()) {
+                SkipList::_throw_exceeds_size(_values.size());
+            }
+            return _values[index];
+        }
+
+/**
+ * Find the count number of values starting at index and write them to dest.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @param index The index.
+ * @param count The number of values to retrieve.
+ * @param dest The vector of values.
+ */
+        template <typename T, typename Compare>
+        void SortedWindow<T, Compare>::at(size_t index, size_t count, std::vector<T> &dest) const {
+            if (index + count > _values.size()) {
+                SkipList::_throw_exceeds_size(_values.size());
+            }
+            dest.assign(_values.begin() + index, _values.begin() + index + count);
+        }
+
+    } // namespace RollingMedian
+} // namespace OrderedStructs
+
+#endif // SkipList_SortedWindow_h
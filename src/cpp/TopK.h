@@ -0,0 +1,146 @@
+//
+//  TopK.h
+//  SkipList
+//
+
+#ifndef SkipList_TopK_h
+#define SkipList_TopK_h
+
+#include <functional>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace SkipList {
+
+/**
+ * @brief Keeps the capacity largest values, by the comparison function, of all the values pushed to it.
+ *
+ * The values are held in a HeadNode. The smallest value kept, the boundary, is the first Node of the HeadNode and a
+ * pointer to it is cached so, once full, a value that does not beat the boundary is rejected after one comparison
+ * without a descent. A value that does beat it evicts the boundary with HeadNode::pop_front() and is inserted, the
+ * evicted Node is reused for the insert.
+ *
+ * For the capacity smallest values use <tt>TopK<T, std::greater<T>></tt>.
+ *
+ * Once full a value equal to the boundary is rejected. Equal values are held in the order they were pushed, a new value
+ * goes after any equal values already kept, so when the boundary is evicted it is the earliest pushed of the values
+ * equal to it that goes first.
+ * Values that do not compare equal to themselves, such as NaN, are rejected with a FailedComparison exception.
+ *
+ * This is not thread safe and the HeadNode does not use the global mutex.
+ *
+ * @tparam T The type of the values, it must be copy constructible.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare=std::less<T>>
+        class TopK {
+        public:
+            TopK(size_t capacity, Compare cmp=Compare());
+            TopK(const TopK &) = delete;
+            TopK &operator=(const TopK &) = delete;
+
+            // Offer a value, returns true if it is kept.
+            bool push(const T &value);
+            // The maximum number of values kept.
+            size_t capacity() const { return _capacity; }
+            // The number of values kept.
+            size_t size() const { return _list.size(); }
+            // The smallest value kept, this is evicted next.
+            // Will throw an OrderedStructs::SkipList::IndexError if empty.
+            const T &boundary() const;
+            // Returns the value at the index, index 0 is the boundary and index size() - 1 the largest value.
+            // Will throw an OrderedStructs::SkipList::IndexError if index out of range.
+            const T &at(size_t index) const { return _list.at(index); }
+            // Find the value at index and write count values to dest.
+            // Will throw an OrderedStructs::SkipList::IndexError if any index out of range.
+            void at(size_t index, size_t count, std::vector<T> &dest) const { _list.at(index, count, dest); }
+            // Remove all values.
+            void clear();
+            // Check the integrity of the HeadNode.
+            IntegrityCheck lacksIntegrity() const { return _list.lacksIntegrity(); }
+        protected:
+            size_t _capacity;
+            HeadNode<T, Compare> _list;
+            /// The value of the first Node of _list, nullptr when empty.
+            const T *_pBoundary;
+            Compare _compare;
+        };
+
+/**
+ * Constructor.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @param capacity The number of values to keep, this must be at least one.
+ * @param cmp The comparison function.
+ */
+        template <typename T, typename Compare>
+        TopK<T, Compare>::TopK(size_t capacity, Compare cmp) : _capacity(capacity),
+                                                              _list(cmp, false),
+                                                              _pBoundary(nullptr),
+                                                              _compare(cmp) {
+            if (capacity == 0) {
+                throw ValueError("TopK capacity must be at least one.");
+            }
+            _list.set_node_reuse(1);
+        }
+
+/**
+ * Offer a value. If full and the value is not greater than the boundary it is rejected after one comparison.
+ * Otherwise it is inserted, evicting the boundary if full.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @param value The value.
+ * @return true if the value is kept.
+ */
+        template <typename T, typename Compare>
+        bool TopK<T, Compare>::push(const T &value) {
+            if (value != value) {
+                throw FailedComparison("Can not work with something that does not compare equal to itself.");
+            }
+            if (_list.size() == _capacity) {
+                if (! _compare(*_pBoundary, value)) {
+                    return false;
+                }
+                _list.pop_front();
+            }
+            _list.insert(value);
+            _pBoundary = &_list.front();
+            return true;
+        }
+
+/**
+ * The smallest value kept, the next to be evicted.
+ * Will throw an OrderedStructs::SkipList::IndexError if empty.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ * @return The boundary value.
+ */
+        template <typename T, typename Compare>
+        const T &TopK<T, Compare>::boundary() const {
+            if (! _pBoundary) {
+                _throw_exceeds_size(0);
+            }
+            return *_pBoundary;
+        }
+
+/**
+ * Remove all values.
+ *
+ * @tparam T The type of the values.
+ * @tparam Compare A comparison function for type T.
+ */
+        template <typename T, typename Compare>
+        void TopK<T, Compare>::clear() {
+            _list.remove_range(0, _list.size());
+            _pBoundary = nullptr;
+        }
+
+    } // namespace SkipList
+} // namespace OrderedStructs
+
+#endif // SkipList_TopK_h
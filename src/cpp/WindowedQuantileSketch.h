@@ -0,0 +1,374 @@
+//
+//  WindowedQuantileSketch.h
+//  SkipList
+//
+
+#ifndef SkipList_WindowedQuantileSketch_h
+#define SkipList_WindowedQuantileSketch_h
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+#include "SkipList.h"
+
+namespace OrderedStructs {
+    namespace RollingMedian {
+
+/**
+ * @brief An approximate quantile summary of the last win_length values of a stream where the memory used depends on
+ * the rank error and not on the window length.
+ *
+ * An exact rolling median keeps every value of the window in a Skip List, this costs about 86 bytes per value so a
+ * window of 10^7 values needs around 1GB. This sketch instead divides the stream into blocks of
+ * <tt>block_length() = floor(epsilon * win_length / 4)</tt> values:
+ *
+ * - The current block is summarised as it arrives by a compactor. Each level of the compactor holds values of weight
+ *   2^level, when a level is full it is sorted and every other value is promoted to the next level with twice the
+ *   weight. The levels are sized so that the rank error within the block is at most epsilon / 4 of the block.
+ * - When a block is complete its summary is reduced to <tt>ceil(2 / epsilon)</tt> values taken at the middle of equal
+ *   steps of cumulative weight, the rank error of this is at most half a step. These are merged into a sorted array of
+ *   SkipList::WeightedValue of all the completed blocks.
+ * - A block leaves the sorted array once more than half of it has left the window.
+ *
+ * A quantile is then a binary search of the cumulative weights of the sorted array. The rank of the result in the
+ * exact window is within <tt>epsilon * win_length</tt> of the exact rank. This allows for the values of the current
+ * block that are not yet in the summary, the part of the oldest block that is out of the window and the rank error of
+ * each block summary.
+ *
+ * The memory is about 8 / epsilon^2 weighted values whatever the window length, for example about 80,000 values
+ * (1.3MB for doubles) for epsilon = 0.01. For windows shorter than about 1 / epsilon^2 this is no smaller than an exact
+ * window.
+ *
+ * The summary only changes when a block completes or expires, push() returns true when that happens so that a caller
+ * can cache the quantiles between times. Each change is O(summary_size()) so the cost per value falls as the window
+ * length increases.
+ *
+ * This is not thread safe, the caller must synchronise access if it is shared between threads.
+ *
+ * @tparam T The type of the values, this must be copyable and ordered by <tt>operator<</tt>.
+ */
+        template <typename T>
+        class WindowedQuantileSketch {
+        public:
+            // Will throw an OrderedStructs::SkipList::ValueError if win_length is zero or epsilon is not in (0, 1).
+            WindowedQuantileSketch(size_t win_length, double epsilon);
+            // Add a value, returns true if the summary has changed.
+            // Will throw an OrderedStructs::SkipList::FailedComparison if value != value, for example NaN.
+            bool push(const T &value);
+            // The approximate quantile of the window, q must be in [0, 1].
+            // Will throw an OrderedStructs::SkipList::ValueError if q is out of range or an
+            // OrderedStructs::SkipList::IndexError if no block has been completed.
+            T quantile(double q) const;
+            /// Number of values in the window that is summarised.
+            size_t size() const {
+                return std::min(_count, _win_length);
+            }
+            /// The window length.
+            size_t win_length() const {
+                return _win_length;
+            }
+            /// The maximum rank error as a fraction of the window length.
+            double epsilon() const {
+                return _epsilon;
+            }
+            /// The number of values in each block.
+            size_t block_length() const {
+                return _block_length;
+            }
+            // Number of values held in the summary and the compactor.
+            size_t summary_size() const;
+            // Estimate of the number of bytes used.
+            size_t size_of() const;
+        protected:
+            typedef SkipList::WeightedValue<T> tWeighted;
+            /// The summary of a completed block.
+            struct Block {
+                /// The values merged into the summary, sorted.
+                std::vector<tWeighted> values;
+                /// The number of values pushed up to and including the last value of this block.
+                size_t end;
+            };
+            // Compact a full level of the compactor into the level above.
+            void _compact(size_t level);
+            // Summarise the compactor as a Block and merge it into the summary.
+            void _complete_block();
+            // Remove the oldest Block from the summary.
+            void _expire_block();
+            // Recompute the cumulative weights of the summary.
+            void _accumulate();
+            /// The window length.
+            size_t _win_length;
+            /// The maximum rank error as a fraction of the window length.
+            double _epsilon;
+            /// Number of values in each block.
+            size_t _block_length;
+            /// Maximum number of values in the summary of a completed block.
+            size_t _block_summary_length;
+            /// Capacity of each level of the compactor, this is even.
+            size_t _compactor_length;
+            /// Number of values pushed.
+            size_t _count;
+            /// Number of values pushed into the current block.
+            size_t _block_count;
+            /// Levels of the compactor for the current block, a value at level h has weight 2^h.
+            std::vector<std::vector<T>> _levels;
+            /// For each level whether the next compaction keeps the odd, rather than the even, values.
+            std::vector<bool> _odd;
+            /// The completed blocks, oldest first.
+            std::deque<Block> _blocks;
+            /// The weighted values of all the completed blocks, sorted.
+            std::vector<tWeighted> _summary;
+            /// The cumulative weight of _summary up to and including each value.
+            std::vector<double> _cumulative;
+            /// Working space for the compactor values and the merges.
+            std::vector<tWeighted> _buffer;
+        };
+
+/**
+ * Constructor.
+ *
+ * The rank error is split between: the current block that is not yet summarised and the part of the oldest block that
+ * is out of the window, up to 3/8 of epsilon * win_length together, then the compactors and the reductions of the
+ * completed blocks, up to 1/4 each. So each block summary may have a rank error of up to epsilon / 2 of the block.
+ *
+ * @tparam T The type of the values.
+ * @param win_length The window length.
+ * @param epsilon The maximum rank error as a fraction of the window length, this must be in (0, 1).
+ */
+        template <typename T>
+        WindowedQuantileSketch<T>::WindowedQuantileSketch(size_t win_length, double epsilon) :
+                _win_length(win_length), _epsilon(epsilon), _count(0), _block_count(0) {
+            if (win_length == 0) {
+                throw SkipList::ValueError("Window length must be greater than zero.");
+            }
+            // Negated so that NaN is rejected.
+            if (! (epsilon > 0.0 && epsilon < 1.0)) {
+                throw SkipList::ValueError("Epsilon must be in the range (0, 1).");
+            }
+            _block_length = std::max<size_t>(1, static_cast<size_t>(epsilon * win_length / 4));
+            _block_summary_length = static_cast<size_t>(std::ceil(2.0 / epsilon));
+            // Each compaction at level h has a rank error of at most 2^h and there are at most
+            // block_length / (compactor_length * 2^h) of them. With levels compacting the error within a block is
+            // levels * block_length / compactor_length.
+            size_t levels = 1;
+            while (true) {
+                _compactor_length = static_cast<size_t>(std::ceil(4.0 * levels / epsilon));
+                _compactor_length += _compactor_length % 2;
+                if ((_compactor_length << levels) > _block_length) {
+                    break;
+                }
+                ++levels;
+            }
+            _levels.resize(1);
+            _levels[0].reserve(_compactor_length);
+            _odd.resize(1);
+        }
+
+/**
+ * Add a value to the window.
+ *
+ * @tparam T The type of the values.
+ * @param value The value.
+ * @return true if a block has been completed or has expired so the quantiles may have changed.
+ */
+        template <typename T>
+        bool WindowedQuantileSketch<T>::push(const T &value) {
+            if (value != value) {
+                throw SkipList::FailedComparison(
+                    "Can not work with something that does not compare equal to itself.");
+            }
+            _levels[0].push_back(value);
+            if (_levels[0].size() >= _compactor_length) {
+                _compact(0);
+            }
+            ++_count;
+            ++_block_count;
+            bool changed = false;
+            if (_block_count == _block_length) {
+                _complete_block();
+                changed = true;
+            }
+            // Expire the oldest block once more than half of it is out of the window, that is when
+            // end - block_length / 2 <= count - win_length.
+            while (! _blocks.empty()
+                   && 2 * (_blocks.front().end + _win_length) <= 2 * _count + _block_length) {
+                _expire_block();
+                changed = true;
+            }
+            if (changed) {
+                _accumulate();
+            }
+            return changed;
+        }
+
+/**
+ * Sort a full level and promote every other value to the next level, alternating between the odd and even values so
+ * that the rank errors tend to cancel.
+ *
+ * @tparam T The type of the values.
+ * @param level The level to compact.
+ */
+        template <typename T>
+        void WindowedQuantileSketch<T>::_compact(size_t level) {
+            while (_levels[level].size() >= _compactor_length) {
+                if (level + 1 == _levels.size()) {
+                    _levels.emplace_back();
+                    _levels.back().reserve(_compactor_length);
+                    _odd.push_back(false);
+                }
+                std::vector<T> &values = _levels[level];
+                std::sort(values.begin(), values.end());
+                for (size_t i = _odd[level] ? 1 : 0; i < values.size(); i += 2) {
+                    _levels[level + 1].push_back(values[i]);
+                }
+                _odd[level] = ! _odd[level];
+                values.clear();
+                ++level;
+            }
+        }
+
+/**
+ * Reduce the compactor to at most _block_summary_length values of equal weight and merge them into the summary.
+ *
+ * @tparam T The type of the values.
+ */
+        template <typename T>
+        void WindowedQuantileSketch<T>::_complete_block() {
+            _buffer.clear();
+            double weight = 1.0;
+            for (size_t level = 0; level < _levels.size(); ++level) {
+                for (const T &value: _levels[level]) {
+                    _buffer.push_back(tWeighted{value, weight});
+                }
+                _levels[level].clear();
+                weight *= 2.0;
+            }
+            std::sort(_buffer.begin(), _buffer.end());
+            Block block;
+            block.end = _count;
+            if (_buffer.size() <= _block_summary_length) {
+                block.values = _buffer;
+            } else {
+                // The values at the middle of each of _block_summary_length equal steps of cumulative weight.
+                const double step = static_cast<double>(_block_length) / _block_summary_length;
+                double cumulative = 0.0;
+                size_t index = 0;
+                block.values.reserve(_block_summary_length);
+                for (size_t i = 0; i < _block_summary_length; ++i) {
+                    const double target = (i + 0.5) * step;
+                    while (index + 1 < _buffer.size() && cumulative + _buffer[index].weight < target) {
+                        cumulative += _buffer[index].weight;
+                        ++index;
+                    }
+                    block.values.push_back(tWeighted{_buffer[index].value, step});
+                }
+            }
+            _buffer.resize(_summary.size() + block.values.size());
+            std::merge(_summary.begin(), _summary.end(), block.values.begin(), block.values.end(), _buffer.begin());
+            _summary.swap(_buffer);
+            _blocks.push_back(std::move(block));
+            _block_count = 0;
+        }
+
+/**
+ * Remove the values of the oldest block from the summary, both are sorted so this is a single pass.
+ *
+ * @tparam T The type of the values.
+ */
+        template <typename T>
+        void WindowedQuantileSketch<T>::_expire_block() {
+            const std::vector<tWeighted> &values = _blocks.front().values;
+            _buffer.clear();
+            auto expired = values.begin();
+            for (const tWeighted &weighted: _summary) {
+                if (expired != values.end() && weighted == *expired) {
+                    ++expired;
+                } else {
+                    _buffer.push_back(weighted);
+                }
+            }
+            assert(expired == values.end());
+            _summary.swap(_buffer);
+            _blocks.pop_front();
+        }
+
+/**
+ * Recompute the cumulative weights after the summary has changed.
+ *
+ * @tparam T The type of the values.
+ */
+        template <typename T>
+        void WindowedQuantileSketch<T>::_accumulate() {
+            _cumulative.resize(_summary.size());
+            double cumulative = 0.0;
+            for (size_t i = 0; i < _summary.size(); ++i) {
+                cumulative += _summary[i].weight;
+                _cumulative[i] = cumulative;
+            }
+        }
+
+/**
+ * The approximate quantile of the window. The result is always one of the values that has been pushed and its rank
+ * in the exact window is within <tt>epsilon() * win_length()</tt> of <tt>q * (size() - 1)</tt>.
+ *
+ * @tparam T The type of the values.
+ * @param q The quantile, in the range [0, 1], for example 0.5 for the median.
+ * @return The value.
+ */
+        template <typename T>
+        T WindowedQuantileSketch<T>::quantile(double q) const {
+            // Negated so that NaN is rejected.
+            if (! (q >= 0.0 && q <= 1.0)) {
+                throw SkipList::ValueError("Quantile must be in the range [0, 1].");
+            }
+            if (_summary.empty()) {
+                SkipList::_throw_exceeds_size(0);
+            }
+            // The first value where the cumulative weight reaches q of the total.
+            const double target = q * _cumulative.back();
+            size_t index = std::lower_bound(_cumulative.begin(), _cumulative.end(), target) - _cumulative.begin();
+            return _summary[std::min(index, _summary.size() - 1)].value;
+        }
+
+/**
+ * The number of values held, this is bounded by about 8 / epsilon^2 whatever the window length.
+ *
+ * @tparam T The type of the values.
+ * @return The number of values in the summary and the compactor.
+ */
+        template <typename T>
+        size_t WindowedQuantileSketch<T>::summary_size() const {
+            size_t result = _summary.size();
+            for (const std::vector<T> &level: _levels) {
+                result += level.size();
+            }
+            return result;
+        }
+
+/**
+ * Estimate of the number of bytes used, this includes the summary, the block summaries and the compactor.
+ *
+ * @tparam T The type of the values.
+ * @return The number of bytes.
+ */
+        template <typename T>
+        size_t WindowedQuantileSketch<T>::size_of() const {
+            size_t result = sizeof(*this);
+            result += _summary.capacity() * sizeof(tWeighted) + _cumulative.capacity() * sizeof(double);
+            for (const Block &block: _blocks) {
+                result += sizeof(Block) + block.values.capacity() * sizeof(tWeighted);
+            }
+            for (const std::vector<T> &level: _levels) {
+                result += sizeof(level) + level.capacity() * sizeof(T);
+            }
+            result += _buffer.capacity() * sizeof(tWeighted);
+            return result;
+        }
+
+    } // namespace RollingMedian
+} // namespace OrderedStructs
+
+#endif // SkipList_WindowedQuantileSketch_h
@@ -34,10 +34,18 @@
  * @endcode
  */
 
+#include <atomic>
 #include <iomanip>
+#include <limits>
+#include <set>
 #include <thread>
 
 #include "SkipList.h"
+#include "LockFreeSkipList.h"
+#include "ConcurrentHeadNode.h"
+#include "FlatCombiningHeadNode.h"
+#include "ShardedHeadNode.h"
+#include "SnapshotList.h"
 #include "TestFramework.h"
 #include "test_print.h"
 #include "test_concurrent.h"
@@ -98,13 +106,14 @@ insert_has_remove_count(OrderedStructs::SkipList::HeadNode<T> *psl,
  * Insert a value into a Skip List @c count times, check it is there then remove it @c count times.
  *
  * @tparam T Type of values in the Skip List.
+ * @tparam SL The Skip List type, a HeadNode or a FlatCombiningHeadNode.
  * @param psl Pointer to the Skip List.
  * @param value Value to insert.
  * @param count Number of times to repeat the insert/remove.
  */
-template<typename T>
+template<typename T, typename SL=OrderedStructs::SkipList::HeadNode<T>>
 static void
-insert_count_has_remove_count(OrderedStructs::SkipList::HeadNode<T> *psl,
+insert_count_has_remove_count(SL *psl,
                               const T &value,
                               const size_t &count) {
     for (size_t i = 0; i < count; ++i) {
@@ -188,6 +197,9 @@ const size_t SKIPLIST_MAX_THREADS = 128 * 2;
  *
  * This then reports the total time taken in us and the rate which is <tt>thread_count * count / total time</tt>
  *
+ * Then this repeats that with a @c OrderedStructs::SkipList::FlatCombiningHeadNode<double> and reports its rate and the
+ * ratio of the two rates.
+ *
  * Example output where the count is fixed at @ref SKIPLIST_FIXED_LENGTH :
  *
  * @code
@@ -224,17 +236,31 @@ static int _test_perf_insert_count_has_remove_count_multi_threads(
     OrderedStructs::SkipList::HeadNode<double> sl;
     std::vector<std::thread> threads;
 
-    time_t start = clock();
+    // Wall time, clock() would add up the CPU time of all the threads.
+    ExecClock exec_clock;
     for (size_t i = 0; i < thread_count; ++i) {
         threads.push_back(std::thread(insert_count_has_remove_count<double>, &sl, i, count));
     }
     for (auto &t: threads) {
         t.join();
     }
-    double exec = 1e6 * (clock() - start) / (double) CLOCKS_PER_SEC;
+    double exec = 1e6 * exec_clock.seconds();
     uint32_t exec_us = exec + 0.5;
     result |= sl.lacksIntegrity();
     result |= sl.size() != 0;
+
+    OrderedStructs::SkipList::FlatCombiningHeadNode<double> fc_sl;
+    threads.clear();
+    ExecClock fc_exec_clock;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.push_back(std::thread(insert_count_has_remove_count<double, decltype(fc_sl)>, &fc_sl, i, count));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    double fc_exec = 1e6 * fc_exec_clock.seconds();
+    result |= fc_sl.lacksIntegrity();
+    result |= fc_sl.size() != 0;
     std::cout << std::setw(FUNCTION_WIDTH) << caller_name << "():";
     std::cout << " threads: " << std::setw(4) << thread_count;
     std::cout << " SkiplistSize: " << std::setw(8) << count;
@@ -243,6 +269,9 @@ static int _test_perf_insert_count_has_remove_count_multi_threads(
     std::cout << " (us)";
     std::cout << " rate " << std::setw(12);
     std::cout << thread_count * count / (exec / 1e6) << " /s";
+    std::cout << " flat combining rate " << std::setw(12);
+    std::cout << thread_count * count / (fc_exec / 1e6) << " /s";
+    std::cout << " ratio " << std::setw(6) << exec / fc_exec;
     std::cout << std::endl;
     return result;
 #endif // SKIPLIST_THREAD_SUPPORT
@@ -549,6 +578,1132 @@ static int test_perf_sim_rolling_median_multi_thread_multi(
 
 #endif
 
+/***************** Lock-free Skip List Tests ************************/
+
+/**
+ * A small xorshift generator so that each test thread has its own random sequence without sharing rand().
+ */
+class XorShift {
+public:
+    explicit XorShift(uint64_t seed) : _state(seed * 0x9E3779B97F4A7C15ULL | 1) {}
+    uint64_t operator()() {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return _state;
+    }
+private:
+    uint64_t _state;
+};
+
+/**
+ * Functional test of a LockFreeSkipList in a single thread.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_lock_free_single_thread() {
+    int result = 0;
+    OrderedStructs::SkipList::LockFreeSkipList<double> sl;
+
+    result |= sl.size() != 0;
+    result |= sl.has(1.0);
+    result |= sl.remove(1.0);
+    for (int i = 0; i < 1000; ++i) {
+        result |= !sl.insert((i * 7) % 1000);
+    }
+    result |= sl.insert(500.0);
+    result |= sl.size() != 1000;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    for (int i = 0; i < 1000; i += 2) {
+        result |= !sl.remove(i);
+    }
+    result |= sl.remove(0.0);
+    result |= sl.size() != 500;
+    for (int i = 0; i < 1000; ++i) {
+        result |= sl.has(i) != (i % 2 == 1);
+    }
+    result |= sl.has(1000.0);
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    try {
+        sl.insert(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    result |= sl.size() != 500;
+    return result;
+}
+
+/**
+ * Each thread inserts its own values, checks them then removes them.
+ *
+ * @param psl Pointer to the Skip List.
+ * @param thread_index Index of this thread.
+ * @param thread_count Number of threads, thread i owns the values congruent to i modulo thread_count.
+ * @param count Number of values for this thread.
+ * @param remove If true remove the values after inserting them.
+ * @param failures Incremented on any unexpected result.
+ */
+static void
+lock_free_insert_has_remove_disjoint(OrderedStructs::SkipList::LockFreeSkipList<long> *psl, size_t thread_index,
+                                     size_t thread_count, size_t count, bool remove,
+                                     std::atomic<size_t> *failures) {
+    size_t fail = 0;
+    for (size_t i = 0; i < count; ++i) {
+        fail += !psl->insert(i * thread_count + thread_index);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fail += !psl->has(i * thread_count + thread_index);
+    }
+    if (remove) {
+        for (size_t i = 0; i < count; i += 2) {
+            fail += !psl->remove(i * thread_count + thread_index);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            fail += psl->has(i * thread_count + thread_index) != (i % 2 == 1);
+        }
+    }
+    *failures += fail;
+}
+
+/**
+ * Functional test of a LockFreeSkipList with several threads inserting and removing interleaved values.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_lock_free_multi_thread_disjoint() {
+    int result = 0;
+    const size_t thread_count = 8;
+    const size_t count = 1024 * 8;
+    OrderedStructs::SkipList::LockFreeSkipList<long> sl;
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(lock_free_insert_has_remove_disjoint, &sl, t, thread_count, count, true,
+                                      &failures));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    result |= failures != 0;
+    result |= sl.size() != thread_count * count / 2;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    for (size_t i = 0; i < thread_count * count; ++i) {
+        result |= sl.has(i) != ((i / thread_count) % 2 == 1);
+    }
+    return result;
+}
+
+/**
+ * Randomly insert and remove a small range of values counting, per value, the successful inserts less the
+ * successful removes.
+ *
+ * @param psl Pointer to the Skip List.
+ * @param seed Random seed.
+ * @param count Number of operations.
+ * @param net The net count per value, this is a per thread vector.
+ */
+static void
+lock_free_random_insert_remove(OrderedStructs::SkipList::LockFreeSkipList<long> *psl, uint64_t seed, size_t count,
+                               std::vector<long> *net) {
+    XorShift rng(seed);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t r = rng();
+        long value = static_cast<long>((r >> 8) % net->size());
+        if (r & 1) {
+            (*net)[value] += psl->insert(value);
+        } else {
+            (*net)[value] -= psl->remove(value);
+        }
+        psl->has(value);
+    }
+}
+
+/**
+ * Functional test of a LockFreeSkipList where many threads contend for the same few values.
+ * Every successful insert of a value must be matched by a successful remove unless the value is present at the end.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_lock_free_multi_thread_contended() {
+    int result = 0;
+    const size_t thread_count = 8;
+    const size_t value_count = 64;
+    OrderedStructs::SkipList::LockFreeSkipList<long> sl;
+    std::vector<std::vector<long>> nets(thread_count, std::vector<long>(value_count, 0));
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(lock_free_random_insert_remove, &sl, t + 1, 1024 * 64, &nets[t]));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    size_t present = 0;
+    for (size_t v = 0; v < value_count; ++v) {
+        long net = 0;
+        for (const auto &thread_net: nets) {
+            net += thread_net[v];
+        }
+        result |= net != sl.has(v);
+        present += sl.has(v);
+    }
+    result |= sl.size() != present;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
+/// Maximum number of threads for the lock-free scaling benchmark, the increment is x2.
+const size_t LOCK_FREE_MAX_THREADS = 64;
+/// Total number of insert/has/remove cycles for the lock-free scaling benchmark, divided between the threads.
+const size_t LOCK_FREE_TOTAL_COUNT = 1024 * 256;
+/// Number of values loaded into the set before the lock-free scaling benchmark.
+const size_t LOCK_FREE_PRELOAD = 1024 * 64;
+
+/**
+ * An order book like workload, each thread repeatedly inserts a random value of its own, probes it, its preloaded
+ * neighbour and a value that is not present, then removes it.
+ *
+ * @tparam SL The Skip List type, either a HeadNode or a LockFreeSkipList.
+ * @param psl Pointer to the Skip List.
+ * @param thread_index Index of this thread.
+ * @param thread_count Number of threads.
+ * @param count Number of insert/has/remove cycles.
+ */
+template<typename SL>
+static void
+order_book_insert_has_remove(SL *psl, size_t thread_index, size_t thread_count, size_t count) {
+    XorShift rng(thread_index + 1);
+    for (size_t i = 0; i < count; ++i) {
+        // Preloaded values are multiples of (thread_count + 1), so these are distinct from them and from each other.
+        double value = static_cast<double>(rng() % LOCK_FREE_PRELOAD) * (thread_count + 1) + thread_index + 1;
+        psl->insert(value);
+        psl->has(value);
+        psl->has(value - thread_index - 1);
+        // Only whole numbers are inserted so this is absent.
+        psl->has(value + 0.5);
+        psl->remove(value);
+    }
+}
+
+/**
+ * Run the order book workload on a preloaded Skip List with the given number of threads.
+ *
+ * @tparam SL The Skip List type, either a HeadNode or a LockFreeSkipList.
+ * @param sl The Skip List.
+ * @param thread_count Number of threads.
+ * @return Wall clock time in seconds.
+ */
+template<typename SL>
+static double _time_order_book(SL &sl, size_t thread_count) {
+    for (size_t i = 0; i < LOCK_FREE_PRELOAD; ++i) {
+        sl.insert(static_cast<double>(i) * (thread_count + 1));
+    }
+    std::vector<std::thread> threads;
+    ExecClock exec_clock;
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(order_book_insert_has_remove<SL>, &sl, t, thread_count,
+                                      LOCK_FREE_TOTAL_COUNT / thread_count));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    return exec_clock.seconds();
+}
+
+#ifndef DEBUG
+
+/**
+ * Compare the throughput of the mutex guarded HeadNode with the LockFreeSkipList from 1 to LOCK_FREE_MAX_THREADS
+ * threads. The total work is constant so ideal scaling halves the time for every doubling of the threads, up to the
+ * number of cores.
+ *
+ * Each cycle is an insert, two has() and a remove on a set preloaded with LOCK_FREE_PRELOAD values.
+ *
+ * @return -1 if compiled without thread support. Otherwise 0 on success, non-zero on failure.
+ */
+static int test_perf_lock_free_vs_head_node_multi_threads() {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    int result = 0;
+    for (size_t thread_count = 1; thread_count <= LOCK_FREE_MAX_THREADS; thread_count *= 2) {
+        double head_node_time;
+        double lock_free_time;
+        {
+            OrderedStructs::SkipList::HeadNode<double> sl;
+            head_node_time = _time_order_book(sl, thread_count);
+            result |= sl.size() != LOCK_FREE_PRELOAD;
+        }
+        {
+            OrderedStructs::SkipList::LockFreeSkipList<double> sl;
+            lock_free_time = _time_order_book(sl, thread_count);
+            result |= sl.size() != LOCK_FREE_PRELOAD;
+            result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+        }
+        std::cout << std::setw(FUNCTION_WIDTH) << __FUNCTION__ << "():";
+        std::cout << " threads: " << std::setw(4) << thread_count;
+        std::cout << " HeadNode: " << std::setw(10) << LOCK_FREE_TOTAL_COUNT / head_node_time << " /s";
+        std::cout << " LockFreeSkipList: " << std::setw(10) << LOCK_FREE_TOTAL_COUNT / lock_free_time << " /s";
+        std::cout << " ratio: " << std::setw(6) << head_node_time / lock_free_time;
+        std::cout << std::endl;
+    }
+    return result;
+#endif // SKIPLIST_THREAD_SUPPORT
+    return -1; // N/A
+}
+
+#endif
+
+/***************** Concurrent HeadNode Tests ************************/
+
+/**
+ * Functional test of a ConcurrentHeadNode in a single thread, comparing every result with a std::multiset.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_concurrent_head_node_single_thread() {
+    int result = 0;
+    OrderedStructs::SkipList::ConcurrentHeadNode<long> csl;
+    std::multiset<long> expected;
+    XorShift rng(1);
+
+    result |= csl.size() != 0;
+    result |= csl.has(1);
+    try {
+        csl.at(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    // Duplicates are likely.
+    for (int i = 0; i < 2000; ++i) {
+        long value = static_cast<long>(rng() % 500);
+        csl.insert(value);
+        expected.insert(value);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        long value = static_cast<long>(rng() % 500);
+        auto iter = expected.find(value);
+        if (iter != expected.end()) {
+            expected.erase(iter);
+            result |= csl.remove(value) != value;
+        } else {
+            try {
+                csl.remove(value);
+                result |= 1;
+            } catch (OrderedStructs::SkipList::ValueError &err) {}
+        }
+    }
+    result |= csl.size() != expected.size();
+    result |= csl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    size_t i = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++i) {
+        result |= csl.at(i) != *iter;
+        result |= csl.index(*iter) != static_cast<size_t>(std::distance(expected.begin(), expected.find(*iter)));
+    }
+    for (long value = 0; value < 500; ++value) {
+        result |= csl.has(value) != (expected.count(value) > 0);
+    }
+    try {
+        csl.at(expected.size());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        csl.index(500);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    try {
+        OrderedStructs::SkipList::ConcurrentHeadNode<double> dsl;
+        dsl.insert(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * Each thread inserts its own values, checks them then removes half of them.
+ *
+ * @tparam SL The Skip List type, a ConcurrentHeadNode, ShardedHeadNode or FlatCombiningHeadNode.
+ * @param psl Pointer to the Skip List.
+ * @param thread_index Index of this thread.
+ * @param thread_count Number of threads, thread i owns the values congruent to i modulo thread_count.
+ * @param count Number of values for this thread.
+ * @param failures Incremented on any unexpected result.
+ */
+template<typename SL>
+static void
+indexed_insert_has_remove(SL *psl, size_t thread_index, size_t thread_count, size_t count,
+                          std::atomic<size_t> *failures) {
+    size_t fail = 0;
+    for (size_t i = 0; i < count; ++i) {
+        psl->insert(i * thread_count + thread_index);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fail += !psl->has(i * thread_count + thread_index);
+    }
+    for (size_t i = 0; i < count; i += 2) {
+        fail += psl->remove(i * thread_count + thread_index) != static_cast<long>(i * thread_count + thread_index);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fail += psl->has(i * thread_count + thread_index) != (i % 2 == 1);
+    }
+    *failures += fail;
+}
+
+/**
+ * Functional test of a ConcurrentHeadNode with several threads inserting and removing interleaved values.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_concurrent_head_node_multi_thread() {
+    int result = 0;
+    const size_t thread_count = 8;
+    const size_t count = 1024 * 4;
+    OrderedStructs::SkipList::ConcurrentHeadNode<long> sl;
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(indexed_insert_has_remove<OrderedStructs::SkipList::ConcurrentHeadNode<long>>,
+                                      &sl, t, thread_count, count, &failures));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    result |= failures != 0;
+    result |= sl.size() != thread_count * count / 2;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    for (size_t i = 0; i < sl.size(); ++i) {
+        // The survivors are the values v where (v / thread_count) is odd.
+        long expected = static_cast<long>((2 * (i / thread_count) + 1) * thread_count + i % thread_count);
+        result |= sl.at(i) != expected;
+        result |= sl.index(expected) != i;
+    }
+    return result;
+}
+
+/**
+ * Repeatedly insert then remove a random odd value.
+ *
+ * @param psl Pointer to the Skip List.
+ * @param seed Random seed.
+ * @param limit Values are below this.
+ * @param stop Set when the readers have finished.
+ */
+static void
+concurrent_head_node_insert_remove_odd(OrderedStructs::SkipList::ConcurrentHeadNode<long> *psl, uint64_t seed,
+                                       long limit, std::atomic<bool> *stop) {
+    XorShift rng(seed);
+    while (!stop->load()) {
+        long value = static_cast<long>(rng() % (limit / 2)) * 2 + 1;
+        psl->insert(value);
+        psl->remove(value);
+    }
+}
+
+/**
+ * Readers check at() and index() whilst writers insert and remove odd values among preloaded even values.
+ * Each writer has at most one odd value present so if the even value 2k is at index i then k <= i <= k + writers.
+ * An at() or index() that saw a width change without the matching link change would be out by much more than this.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_concurrent_head_node_at_index_linearizable() {
+    int result = 0;
+    const size_t writer_count = 4;
+    const size_t reader_count = 4;
+    const long even_count = 1024 * 4;
+    OrderedStructs::SkipList::ConcurrentHeadNode<long> sl;
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> writers;
+    std::vector<std::thread> readers;
+
+    for (long i = 0; i < even_count; ++i) {
+        sl.insert(2 * i);
+    }
+    for (size_t t = 0; t < writer_count; ++t) {
+        writers.push_back(std::thread(concurrent_head_node_insert_remove_odd, &sl, t + 1, 2 * even_count, &stop));
+    }
+    for (size_t t = 0; t < reader_count; ++t) {
+        readers.push_back(std::thread([&sl, &failures, t]() {
+            XorShift rng(t + 100);
+            size_t fail = 0;
+            for (size_t i = 0; i < 1024 * 16; ++i) {
+                long k = static_cast<long>(rng() % even_count);
+                size_t index = sl.index(2 * k);
+                fail += index < static_cast<size_t>(k) || index > static_cast<size_t>(k) + writer_count;
+                long value = sl.at(static_cast<size_t>(k));
+                // At index k there are at most writer_count odd values at or before it.
+                fail += value > 2 * k || value < 2 * (k - static_cast<long>(writer_count));
+            }
+            failures += fail;
+        }));
+    }
+    for (auto &t: readers) {
+        t.join();
+    }
+    stop = true;
+    for (auto &t: writers) {
+        t.join();
+    }
+    result |= failures != 0;
+    result |= sl.size() != static_cast<size_t>(even_count);
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
+/// Number of values loaded into the Skip List before the concurrent HeadNode contention benchmark.
+const size_t CONCURRENT_HEAD_NODE_PRELOAD = 1024 * 64;
+
+/**
+ * Each thread repeatedly inserts a value then reads it back with index() and at() then removes it.
+ * With spread keys the values of every thread are drawn from the whole range of the preloaded values. With clustered
+ * keys each thread has its own narrow slice of the range.
+ *
+ * @tparam SL The Skip List type, either a HeadNode or a ConcurrentHeadNode.
+ * @param psl Pointer to the Skip List.
+ * @param thread_index Index of this thread.
+ * @param thread_count Number of threads.
+ * @param count Number of cycles.
+ * @param clustered Use clustered rather than spread keys.
+ */
+template<typename SL>
+static void
+contention_insert_index_at_remove(SL *psl, size_t thread_index, size_t thread_count, size_t count, bool clustered) {
+    XorShift rng(thread_index + 1);
+    const size_t slice = CONCURRENT_HEAD_NODE_PRELOAD / thread_count;
+    for (size_t i = 0; i < count; ++i) {
+        size_t key = clustered ? thread_index * slice + rng() % slice : rng() % CONCURRENT_HEAD_NODE_PRELOAD;
+        // Preloaded values are even, these are odd.
+        double value = 2.0 * key + 1.0;
+        psl->insert(value);
+        psl->at(psl->index(value));
+        psl->remove(value);
+    }
+}
+
+/**
+ * Run the contention workload on a preloaded Skip List with the given number of threads.
+ *
+ * @tparam SL The Skip List type, either a HeadNode or a ConcurrentHeadNode.
+ * @param sl The Skip List.
+ * @param thread_count Number of threads.
+ * @param clustered Use clustered rather than spread keys.
+ * @return Wall clock time in seconds.
+ */
+template<typename SL>
+static double _time_contention(SL &sl, size_t thread_count, bool clustered) {
+    for (size_t i = 0; i < CONCURRENT_HEAD_NODE_PRELOAD; ++i) {
+        sl.insert(2.0 * i);
+    }
+    std::vector<std::thread> threads;
+    ExecClock exec_clock;
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(contention_insert_index_at_remove<SL>, &sl, t, thread_count,
+                                      LOCK_FREE_TOTAL_COUNT / thread_count, clustered));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    return exec_clock.seconds();
+}
+
+#ifndef DEBUG
+
+/**
+ * Compare the throughput of the mutex guarded HeadNode with the ConcurrentHeadNode from 1 to LOCK_FREE_MAX_THREADS
+ * threads with keys spread across, and clustered in, the key space. The total work is constant.
+ *
+ * Each cycle is an insert, index(), at() and remove on a Skip List preloaded with CONCURRENT_HEAD_NODE_PRELOAD values.
+ *
+ * @return -1 if compiled without thread support. Otherwise 0 on success, non-zero on failure.
+ */
+static int test_perf_concurrent_head_node_spread_clustered() {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    int result = 0;
+    for (bool clustered: {false, true}) {
+        for (size_t thread_count = 1; thread_count <= LOCK_FREE_MAX_THREADS; thread_count *= 2) {
+            double head_node_time;
+            double concurrent_time;
+            {
+                OrderedStructs::SkipList::HeadNode<double> sl;
+                head_node_time = _time_contention(sl, thread_count, clustered);
+                result |= sl.size() != CONCURRENT_HEAD_NODE_PRELOAD;
+            }
+            {
+                OrderedStructs::SkipList::ConcurrentHeadNode<double> sl;
+                concurrent_time = _time_contention(sl, thread_count, clustered);
+                result |= sl.size() != CONCURRENT_HEAD_NODE_PRELOAD;
+                result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+            }
+            std::cout << std::setw(FUNCTION_WIDTH) << __FUNCTION__ << "():";
+            std::cout << (clustered ? " clustered" : "    spread");
+            std::cout << " threads: " << std::setw(4) << thread_count;
+            std::cout << " HeadNode: " << std::setw(10) << LOCK_FREE_TOTAL_COUNT / head_node_time << " /s";
+            std::cout << " ConcurrentHeadNode: " << std::setw(10) << LOCK_FREE_TOTAL_COUNT / concurrent_time << " /s";
+            std::cout << " ratio: " << std::setw(6) << head_node_time / concurrent_time;
+            std::cout << std::endl;
+        }
+    }
+    return result;
+#endif // SKIPLIST_THREAD_SUPPORT
+    return -1; // N/A
+}
+
+#endif
+
+/***************** Sharded HeadNode Tests ************************/
+
+/**
+ * Functional test of a ShardedHeadNode in a single thread, comparing every result with a std::multiset.
+ * Increasing values all go into the last shard so this also checks the automatic rebalancing.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_sharded_head_node_single_thread() {
+    int result = 0;
+    const size_t shard_count = 8;
+    OrderedStructs::SkipList::ShardedHeadNode<long> sl(shard_count);
+    std::multiset<long> expected;
+    XorShift rng(1);
+
+    result |= sl.size() != 0;
+    try {
+        sl.at(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    for (long i = 0; i < 1024 * 32; ++i) {
+        long value = i / 4;
+        sl.insert(value);
+        expected.insert(value);
+    }
+    result |= sl.size() != expected.size();
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    // Rebalancing keeps every shard near its share.
+    for (size_t s = 0; s < shard_count; ++s) {
+        result |= sl.shard_size(s) > sl.size() / shard_count * 2 + OrderedStructs::SkipList::SHARDED_HEADNODE_REBALANCE_MIN;
+    }
+    for (int i = 0; i < 1024 * 4; ++i) {
+        long value = static_cast<long>(rng() % (1024 * 8));
+        auto iter = expected.find(value);
+        if (iter != expected.end()) {
+            expected.erase(iter);
+            result |= sl.remove(value) != value;
+        }
+    }
+    sl.rebalance();
+    result |= sl.size() != expected.size();
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    size_t i = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++i) {
+        result |= sl.at(i) != *iter;
+    }
+    for (auto iter = expected.begin(); iter != expected.end(); iter = expected.upper_bound(*iter)) {
+        result |= sl.index(*iter) != static_cast<size_t>(std::distance(expected.begin(), iter));
+        result |= !sl.has(*iter);
+    }
+    try {
+        sl.at(expected.size());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        OrderedStructs::SkipList::ShardedHeadNode<double> dsl(4);
+        dsl.insert(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    try {
+        OrderedStructs::SkipList::ShardedHeadNode<double> dsl(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    return result;
+}
+
+/**
+ * Functional test of a ShardedHeadNode where most of the values are equal. Equal values must share a shard so that
+ * shard stays large whatever the bounds and the values must not be redistributed again and again.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_sharded_head_node_duplicates() {
+    int result = 0;
+    const size_t shard_count = 8;
+    const long duplicate = 1024 * 4;
+    OrderedStructs::SkipList::ShardedHeadNode<long> sl(shard_count);
+    std::multiset<long> expected;
+    XorShift rng(1);
+
+    for (int i = 0; i < 1024 * 256; ++i) {
+        long value = i % 10 ? duplicate : static_cast<long>(rng() % (1024 * 8));
+        sl.insert(value);
+        expected.insert(value);
+    }
+    result |= sl.size() != expected.size();
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= sl.index(duplicate) != static_cast<size_t>(std::distance(expected.begin(), expected.find(duplicate)));
+    size_t i = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++i) {
+        if (i % 1024 == 0) {
+            result |= sl.at(i) != *iter;
+        }
+    }
+    // Once the duplicates are gone the values can be balanced.
+    while (sl.has(duplicate)) {
+        sl.remove(duplicate);
+    }
+    expected.erase(duplicate);
+    sl.rebalance();
+    result |= sl.size() != expected.size();
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    for (size_t s = 0; s < shard_count; ++s) {
+        result |= sl.shard_size(s) > sl.size() / shard_count * 2 + OrderedStructs::SkipList::SHARDED_HEADNODE_REBALANCE_MIN;
+    }
+    i = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++i) {
+        result |= sl.at(i) != *iter;
+    }
+    return result;
+}
+
+/**
+ * Functional test of a ShardedHeadNode with several threads inserting and removing interleaved values whilst the
+ * shards are rebalanced.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_sharded_head_node_multi_thread() {
+    int result = 0;
+    const size_t thread_count = 8;
+    const size_t count = 1024 * 4;
+    OrderedStructs::SkipList::ShardedHeadNode<long> sl(16);
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(indexed_insert_has_remove<OrderedStructs::SkipList::ShardedHeadNode<long>>,
+                                      &sl, t, thread_count, count, &failures));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    result |= failures != 0;
+    result |= sl.size() != thread_count * count / 2;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    for (size_t i = 0; i < sl.size(); ++i) {
+        // The survivors are the values v where (v / thread_count) is odd.
+        long expected = static_cast<long>((2 * (i / thread_count) + 1) * thread_count + i % thread_count);
+        result |= sl.at(i) != expected;
+        result |= sl.index(expected) != i;
+    }
+    return result;
+}
+
+/// Number of shards for the sharded ingest benchmark.
+const size_t SHARDED_HEAD_NODE_SHARDS = 16;
+
+/**
+ * Each thread inserts random values from the whole key space.
+ *
+ * @tparam SL The Skip List type, either a HeadNode or a ShardedHeadNode.
+ * @param psl Pointer to the Skip List.
+ * @param thread_index Index of this thread.
+ * @param count Number of values to insert.
+ */
+template<typename SL>
+static void
+ingest_values(SL *psl, size_t thread_index, size_t count) {
+    XorShift rng(thread_index + 1);
+    for (size_t i = 0; i < count; ++i) {
+        psl->insert(static_cast<double>(rng() % (1024 * 1024)));
+    }
+}
+
+/**
+ * Time the ingest of LOCK_FREE_TOTAL_COUNT values divided between the threads.
+ *
+ * @tparam SL The Skip List type, either a HeadNode or a ShardedHeadNode.
+ * @param sl The Skip List.
+ * @param thread_count Number of threads.
+ * @return Wall clock time in seconds.
+ */
+template<typename SL>
+static double _time_ingest(SL &sl, size_t thread_count) {
+    std::vector<std::thread> threads;
+    ExecClock exec_clock;
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(ingest_values<SL>, &sl, t, LOCK_FREE_TOTAL_COUNT / thread_count));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    return exec_clock.seconds();
+}
+
+#ifndef DEBUG
+
+/**
+ * Compare multi-writer ingest into a mutex guarded HeadNode with a ShardedHeadNode of SHARDED_HEAD_NODE_SHARDS shards
+ * from 1 to LOCK_FREE_MAX_THREADS threads. The ShardedHeadNode starts empty so this includes the rebalancing.
+ *
+ * @return -1 if compiled without thread support. Otherwise 0 on success, non-zero on failure.
+ */
+static int test_perf_sharded_head_node_ingest_multi_threads() {
+#ifdef SKIPLIST_THREAD_SUPPORT
+    int result = 0;
+    for (size_t thread_count = 1; thread_count <= LOCK_FREE_MAX_THREADS; thread_count *= 2) {
+        double head_node_time;
+        double sharded_time;
+        {
+            OrderedStructs::SkipList::HeadNode<double> sl;
+            head_node_time = _time_ingest(sl, thread_count);
+            result |= sl.size() != LOCK_FREE_TOTAL_COUNT;
+        }
+        {
+            OrderedStructs::SkipList::ShardedHeadNode<double> sl(SHARDED_HEAD_NODE_SHARDS);
+            sharded_time = _time_ingest(sl, thread_count);
+            result |= sl.size() != LOCK_FREE_TOTAL_COUNT;
+            result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+        }
+        std::cout << std::setw(FUNCTION_WIDTH) << __FUNCTION__ << "():";
+        std::cout << " threads: " << std::setw(4) << thread_count;
+        std::cout << " HeadNode: " << std::setw(10) << LOCK_FREE_TOTAL_COUNT / head_node_time << " /s";
+        std::cout << " ShardedHeadNode: " << std::setw(10) << LOCK_FREE_TOTAL_COUNT / sharded_time << " /s";
+        std::cout << " ratio: " << std::setw(6) << head_node_time / sharded_time;
+        std::cout << std::endl;
+    }
+    return result;
+#endif // SKIPLIST_THREAD_SUPPORT
+    return -1; // N/A
+}
+
+#endif
+
+/***************** Flat Combining HeadNode Tests ************************/
+
+/**
+ * Functional test of a FlatCombiningHeadNode in a single thread, comparing every result with a std::multiset.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_flat_combining_single_thread() {
+    int result = 0;
+    OrderedStructs::SkipList::FlatCombiningHeadNode<long> sl;
+    std::multiset<long> expected;
+    XorShift rng(1);
+
+    result |= sl.size() != 0;
+    result |= sl.has(1);
+    try {
+        sl.at(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sl.remove(1);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    for (int i = 0; i < 2000; ++i) {
+        long value = static_cast<long>(rng() % 500);
+        sl.insert(value);
+        expected.insert(value);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        long value = static_cast<long>(rng() % 500);
+        auto iter = expected.find(value);
+        if (iter != expected.end()) {
+            expected.erase(iter);
+            result |= sl.remove(value) != value;
+        }
+    }
+    result |= sl.size() != expected.size();
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    size_t i = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++i) {
+        result |= sl.at(i) != *iter;
+    }
+    for (long value = 0; value < 500; ++value) {
+        auto iter = expected.find(value);
+        result |= sl.has(value) != (iter != expected.end());
+        if (iter != expected.end()) {
+            result |= sl.index(value) != static_cast<size_t>(std::distance(expected.begin(), iter));
+        }
+    }
+    try {
+        OrderedStructs::SkipList::FlatCombiningHeadNode<double> dsl;
+        dsl.insert(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * Functional test of a FlatCombiningHeadNode with several threads inserting and removing interleaved values.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_flat_combining_multi_thread() {
+    int result = 0;
+    const size_t thread_count = 8;
+    const size_t count = 1024 * 4;
+    OrderedStructs::SkipList::FlatCombiningHeadNode<long> sl;
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread(indexed_insert_has_remove<OrderedStructs::SkipList::FlatCombiningHeadNode<long>>,
+                                      &sl, t, thread_count, count, &failures));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    result |= failures != 0;
+    result |= sl.size() != thread_count * count / 2;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    for (size_t i = 0; i < sl.size(); ++i) {
+        // The survivors are the values v where (v / thread_count) is odd.
+        long expected = static_cast<long>((2 * (i / thread_count) + 1) * thread_count + i % thread_count);
+        result |= sl.at(i) != expected;
+        result |= sl.index(expected) != i;
+    }
+    return result;
+}
+
+/***************** Snapshot List Tests ************************/
+
+/**
+ * Functional test of a SnapshotList in a single thread, comparing every result with a std::multiset.
+ * A snapshot taken part way through must be unaffected by the later writes.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_snapshot_list_single_thread() {
+    int result = 0;
+    OrderedStructs::SkipList::SnapshotList<long> sl;
+    std::multiset<long> expected;
+    XorShift rng(1);
+
+    result |= sl.size() != 0;
+    result |= sl.has(1);
+    try {
+        sl.at(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sl.remove(1);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    // Enough values to split blocks, with many duplicates.
+    for (int i = 0; i < 1024 * 8; ++i) {
+        long value = static_cast<long>(rng() % 2000);
+        sl.insert(value);
+        expected.insert(value);
+    }
+    OrderedStructs::SkipList::SnapshotList<long>::Snapshot snapshot = sl.snapshot();
+    std::vector<long> before(expected.begin(), expected.end());
+    for (int i = 0; i < 1024 * 4; ++i) {
+        long value = static_cast<long>(rng() % 2000);
+        auto iter = expected.find(value);
+        if (iter != expected.end()) {
+            expected.erase(iter);
+            result |= sl.remove(value) != value;
+        }
+        sl.insert(value + 2000);
+        expected.insert(value + 2000);
+    }
+    result |= sl.size() != expected.size();
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    size_t i = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++i) {
+        result |= sl.at(i) != *iter;
+    }
+    for (long value = 0; value < 4000; ++value) {
+        auto iter = expected.find(value);
+        result |= sl.has(value) != (iter != expected.end());
+        if (iter != expected.end()) {
+            result |= sl.index(value) != static_cast<size_t>(std::distance(expected.begin(), iter));
+        }
+    }
+    // The snapshot still sees the list as it was.
+    result |= snapshot.size() != before.size();
+    std::vector<long> dest;
+    snapshot.at(0, snapshot.size(), dest);
+    result |= dest != before;
+    for (size_t j = 0; j < before.size(); j += 97) {
+        result |= snapshot.at(j) != before[j];
+        result |= snapshot.index(before[j]) !=
+                  static_cast<size_t>(std::lower_bound(before.begin(), before.end(), before[j]) - before.begin());
+    }
+    result |= snapshot.has(3999);
+    try {
+        snapshot.at(before.size());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        OrderedStructs::SkipList::SnapshotList<double> dsl;
+        dsl.insert(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * A value that counts the live instances so that the test can check that old versions are freed.
+ */
+class CountedValue {
+public:
+    CountedValue(long value) : _value(value) { ++live; }
+    CountedValue(const CountedValue &other) : _value(other._value) { ++live; }
+    CountedValue &operator=(const CountedValue &other) = default;
+    ~CountedValue() { --live; }
+    bool operator<(const CountedValue &other) const { return _value < other._value; }
+    bool operator==(const CountedValue &other) const { return _value == other._value; }
+    bool operator!=(const CountedValue &other) const { return _value != other._value; }
+    friend std::ostream &operator<<(std::ostream &os, const CountedValue &value) { return os << value._value; }
+    static std::atomic<long> live;
+private:
+    long _value;
+};
+
+std::atomic<long> CountedValue::live(0);
+
+/**
+ * Old versions of the blocks are shared with snapshots and are freed when the last snapshot is released.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_snapshot_list_reclaims() {
+    int result = 0;
+    {
+        OrderedStructs::SkipList::SnapshotList<CountedValue> sl;
+        for (long i = 0; i < 1024 * 4; ++i) {
+            sl.insert(CountedValue(i));
+        }
+        result |= CountedValue::live != 1024 * 4;
+        {
+            auto first = sl.snapshot();
+            auto second = sl.snapshot();
+            // Every block is modified so is copied.
+            for (long i = 0; i < 1024 * 4; i += 64) {
+                sl.remove(CountedValue(i));
+            }
+            result |= CountedValue::live <= 1024 * 4;
+            result |= first.size() != 1024 * 4 || second.size() != 1024 * 4;
+        }
+        result |= CountedValue::live != static_cast<long>(sl.size());
+    }
+    result |= CountedValue::live != 0;
+    return result;
+}
+
+/**
+ * A writer keeps the values a contiguous range by inserting at the top and removing from the bottom whilst readers
+ * check that every snapshot is a contiguous range.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_snapshot_list_multi_thread() {
+    int result = 0;
+    const size_t reader_count = 4;
+    const long length = 1024 * 4;
+    OrderedStructs::SkipList::SnapshotList<long> sl;
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> failures(0);
+    std::atomic<size_t> snapshots(0);
+
+    for (long i = 0; i < length; ++i) {
+        sl.insert(i);
+    }
+    std::thread writer([&sl, &stop]() {
+        long low = 0;
+        long high = length;
+        while (!stop) {
+            sl.insert(high++);
+            sl.remove(low++);
+        }
+    });
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < reader_count; ++t) {
+        readers.push_back(std::thread([&sl, &failures, &snapshots]() {
+            std::vector<long> dest;
+            for (int i = 0; i < 64; ++i) {
+                auto snapshot = sl.snapshot();
+                size_t fail = snapshot.size() < static_cast<size_t>(length) ||
+                              snapshot.size() > static_cast<size_t>(length) + 1;
+                snapshot.at(0, snapshot.size(), dest);
+                for (size_t j = 0; j < dest.size(); ++j) {
+                    fail += dest[j] != dest[0] + static_cast<long>(j);
+                }
+                fail += snapshot.index(dest.back()) != dest.size() - 1;
+                failures += fail;
+                ++snapshots;
+            }
+        }));
+    }
+    for (auto &t: readers) {
+        t.join();
+    }
+    stop = true;
+    writer.join();
+    result |= failures != 0;
+    result |= snapshots != reader_count * 64;
+    result |= sl.size() != static_cast<size_t>(length);
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
+#ifndef DEBUG
+
+/**
+ * Measure the rate of a writer that inserts and removes values in a SnapshotList of 1m values, first alone then whilst
+ * reader threads repeatedly take a snapshot and compute the 99 percentiles from it.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int test_perf_snapshot_list_writer_with_readers() {
+    int result = 0;
+    const long length = 1024 * 1024;
+    const size_t write_count = 1024 * 256;
+    for (size_t reader_count: {0, 1, 4}) {
+        OrderedStructs::SkipList::SnapshotList<double> sl;
+        for (long i = 0; i < length; ++i) {
+            sl.insert(static_cast<double>(i));
+        }
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> snapshots(0);
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < reader_count; ++t) {
+            readers.push_back(std::thread([&sl, &stop, &snapshots]() {
+                double sum = 0.0;
+                while (!stop) {
+                    auto snapshot = sl.snapshot();
+                    for (size_t q = 1; q < 100; ++q) {
+                        sum += snapshot.at(snapshot.size() * q / 100);
+                    }
+                    ++snapshots;
+                }
+                // Use the sum so that the reads are not optimised away.
+                snapshots += sum < 0.0;
+            }));
+        }
+        XorShift rng(1);
+        ExecClock exec_clock;
+        for (size_t i = 0; i < write_count; ++i) {
+            double value = static_cast<double>(rng() % length) + 0.5;
+            sl.insert(value);
+            sl.remove(value);
+        }
+        double exec = exec_clock.seconds();
+        stop = true;
+        for (auto &t: readers) {
+            t.join();
+        }
+        result |= sl.size() != static_cast<size_t>(length);
+        std::cout << std::setw(FUNCTION_WIDTH) << __FUNCTION__ << "():";
+        std::cout << " readers: " << std::setw(2) << reader_count;
+        std::cout << " writes: " << std::setw(10) << 2 * write_count / exec << " /s";
+        std::cout << " snapshots: " << std::setw(10) << snapshots / exec << " /s";
+        std::cout << std::endl;
+    }
+    return result;
+}
+
+#endif
+
 /***************** END: Concurrency Tests ************************/
 
 /**
@@ -565,6 +1720,34 @@ int test_concurrent_all() {
                            test_two_thread_insert_has_remove());
     result |= print_result("test_two_thread_insert_count_has_remove_count",
                            test_two_thread_insert_count_has_remove_count());
+    result |= print_result("test_lock_free_single_thread",
+                           test_lock_free_single_thread());
+    result |= print_result("test_lock_free_multi_thread_disjoint",
+                           test_lock_free_multi_thread_disjoint());
+    result |= print_result("test_lock_free_multi_thread_contended",
+                           test_lock_free_multi_thread_contended());
+    result |= print_result("test_concurrent_head_node_single_thread",
+                           test_concurrent_head_node_single_thread());
+    result |= print_result("test_concurrent_head_node_multi_thread",
+                           test_concurrent_head_node_multi_thread());
+    result |= print_result("test_concurrent_head_node_at_index_linearizable",
+                           test_concurrent_head_node_at_index_linearizable());
+    result |= print_result("test_sharded_head_node_single_thread",
+                           test_sharded_head_node_single_thread());
+    result |= print_result("test_sharded_head_node_duplicates",
+                           test_sharded_head_node_duplicates());
+    result |= print_result("test_sharded_head_node_multi_thread",
+                           test_sharded_head_node_multi_thread());
+    result |= print_result("test_flat_combining_single_thread",
+                           test_flat_combining_single_thread());
+    result |= print_result("test_flat_combining_multi_thread",
+                           test_flat_combining_multi_thread());
+    result |= print_result("test_snapshot_list_single_thread",
+                           test_snapshot_list_single_thread());
+    result |= print_result("test_snapshot_list_reclaims",
+                           test_snapshot_list_reclaims());
+    result |= print_result("test_snapshot_list_multi_thread",
+                           test_snapshot_list_multi_thread());
 #endif
     // Performance tests are very slow if DEBUG as checking
     // integrity is very expensive for large data sets.
@@ -580,6 +1763,14 @@ int test_concurrent_all() {
                            test_perf_sim_rolling_median_single_thread());
     result |= print_result("test_perf_sim_rolling_median_multi_thread",
                            test_perf_sim_rolling_median_multi_thread());
+    result |= print_result("test_perf_lock_free_vs_head_node_multi_threads",
+                           test_perf_lock_free_vs_head_node_multi_threads());
+    result |= print_result("test_perf_concurrent_head_node_spread_clustered",
+                           test_perf_concurrent_head_node_spread_clustered());
+    result |= print_result("test_perf_sharded_head_node_ingest_multi_threads",
+                           test_perf_sharded_head_node_ingest_multi_threads());
+    result |= print_result("test_perf_snapshot_list_writer_with_readers",
+                           test_perf_snapshot_list_writer_with_readers());
 #endif
 #endif // DEBUG
 #ifndef DEBUG
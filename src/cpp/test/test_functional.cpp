@@ -36,9 +36,13 @@
 #include "test_print.h"
 #include "test_functional.h"
 
+#include <algorithm>
+#include <cmath>
 #include <functional> // For comparison function
+#include <stdexcept>
 
 #include "../SkipList.h"
+#include "../TopK.h"
 
 /******************* Functional Tests **************************/
 
@@ -669,6 +673,32 @@ int test_index_large() {
     return result;
 }
 
+/**
+ * @brief Tests \c .index() throws a \c OrderedStructs::SkipList::ValueError with non-existent values that lie between
+ * existing values.
+ *
+ * This was once exponentially slow in the size of the Skip List.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_index_not_present_large() {
+    size_t NUM = 1024 * 16;
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<size_t> sl;
+
+    for (size_t i = 0; i < NUM; ++i) {
+        sl.insert(2 * i);
+    }
+    for (size_t i = 0; i < NUM; ++i) {
+        try {
+            sl.index(2 * i + 1);
+            result |= 1;
+        } catch (OrderedStructs::SkipList::ValueError &err) {}
+    }
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
 /******* Functional Tests with compare() specified **************/
 
 /** @brief Creates a comparison function that return the inverse of \c std::less to create a decreasing Skip List. */
@@ -704,6 +734,1056 @@ int test_reversed_simple_insert() {
 
 /******* END: Functional Tests with compare() specified **********/
 
+/******* Functional Tests with augmented widths **************/
+
+/** @brief A Skip List of doubles with the widths augmented by the sum and sum of squares. */
+typedef OrderedStructs::SkipList::HeadNode<
+    double,
+    std::less<double>,
+    OrderedStructs::SkipList::SumSquaresAugment<double>
+> tSkipListSumSquares;
+
+/**
+ * @brief Check the prefix and range sums of an augmented Skip List against sums computed by brute force.
+ *
+ * The values are integers so the sums are exact.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int _check_sum_augment(const tSkipListSumSquares &sl) {
+    int result = 0;
+    std::vector<double> values;
+    for (size_t i = 0; i < sl.size(); ++i) {
+        values.push_back(sl.at(i));
+    }
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    for (size_t i = 0; i <= values.size(); ++i) {
+        OrderedStructs::SkipList::SumSquaresAugment<double> aug = sl.prefix(i);
+        result |= aug.sum.value() != sum;
+        result |= aug.sum_squares.value() != sum_squares;
+        if (i < values.size()) {
+            // prefix_value() excludes all values equal to the given value.
+            if (i == 0 || values[i - 1] != values[i]) {
+                result |= sl.prefix_value(values[i]).sum.value() != sum;
+            }
+            sum += values[i];
+            sum_squares += values[i] * values[i];
+        }
+    }
+    result |= sl.total().sum.value() != sum;
+    result |= sl.total().sum_squares.value() != sum_squares;
+    for (size_t i = 0; i < values.size(); i += 7) {
+        for (size_t count = 0; i + count <= values.size(); count += 5) {
+            double expected = 0.0;
+            for (size_t j = i; j < i + count; ++j) {
+                expected += values[j];
+            }
+            result |= sl.range(i, count).sum.value() != expected;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Tests prefix and range sums of a Skip List with augmented widths during random inserts and removes.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_sum_augment_ins_rem_rand() {
+    int result = 0;
+    const size_t NUM = 256;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        double value = rand() % 64 - 16;
+        values.push_back(value);
+        sl.insert(value);
+        result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    }
+    result |= _check_sum_augment(sl);
+    // Remove half in a random order
+    for (size_t i = 0; i < NUM / 2; ++i) {
+        size_t index = rand() % values.size();
+        result |= sl.remove(values[index]) != values[index];
+        values.erase(values.begin() + index);
+        result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    }
+    result |= _check_sum_augment(sl);
+    // Remove the rest
+    for (size_t i = 0; i < values.size(); ++i) {
+        sl.remove(values[i]);
+    }
+    result |= sl.size() != 0;
+    result |= sl.total().sum.value() != 0.0;
+    return result;
+}
+
+/**
+ * @brief Insert and remove random values with removed Nodes being reused checking the integrity and the
+ * augmentation throughout. This includes changing the number of spare Nodes.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_node_reuse_ins_rem_rand() {
+    int result = 0;
+    const size_t NUM = 256;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    sl.set_node_reuse(4);
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        double value = rand() % 64 - 16;
+        values.push_back(value);
+        sl.insert(value);
+    }
+    // Steady state of remove() and insert() as a rolling window
+    for (size_t i = 0; i < 4 * NUM; ++i) {
+        if (i == 2 * NUM) {
+            sl.set_node_reuse(1);
+        }
+        size_t index = rand() % values.size();
+        result |= sl.remove(values[index]) != values[index];
+        values[index] = rand() % 64 - 16;
+        sl.insert(values[index]);
+        result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    }
+    result |= _check_sum_augment(sl);
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); ++i) {
+        result |= sl.at(i) != values[i];
+    }
+    // Remove all, the Nodes that are not kept are deleted.
+    for (size_t i = 0; i < values.size(); ++i) {
+        sl.remove(values[i]);
+    }
+    result |= sl.size() != 0;
+    sl.set_node_reuse(0);
+    return result;
+}
+
+/**
+ * @brief A value that counts the live instances so that a test can detect a leaked Node.
+ * An incomparable value makes PartiallyComparableCompare throw, in the same way as a Python object that does not
+ * support ordering.
+ */
+class PartiallyComparableValue {
+public:
+    PartiallyComparableValue(long value, bool comparable=true) : _value(value), _comparable(comparable) { ++live; }
+    PartiallyComparableValue(const PartiallyComparableValue &other) : _value(other._value),
+                                                                      _comparable(other._comparable) { ++live; }
+    PartiallyComparableValue &operator=(const PartiallyComparableValue &other) = default;
+    ~PartiallyComparableValue() { --live; }
+    bool operator==(const PartiallyComparableValue &other) const { return _value == other._value; }
+    bool operator!=(const PartiallyComparableValue &other) const { return _value != other._value; }
+    friend std::ostream &operator<<(std::ostream &os, const PartiallyComparableValue &value) {
+        return os << value._value;
+    }
+    long value() const { return _value; }
+    bool comparable() const { return _comparable; }
+    static long live;
+private:
+    long _value;
+    bool _comparable;
+};
+
+long PartiallyComparableValue::live = 0;
+
+/** @brief Compares PartiallyComparableValue and throws if either can not be compared. */
+struct PartiallyComparableCompare {
+    bool operator()(const PartiallyComparableValue &a, const PartiallyComparableValue &b) const {
+        if (! a.comparable() || ! b.comparable()) {
+            throw std::invalid_argument("Can not compare.");
+        }
+        return a.value() < b.value();
+    }
+};
+
+/**
+ * @brief Tests that an \c .insert() where the comparison throws part way through the search does not leak the new Node,
+ * with and without Node reuse.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_insert_comparison_throws_no_leak() {
+    int result = 0;
+    {
+        OrderedStructs::SkipList::HeadNode<PartiallyComparableValue, PartiallyComparableCompare> sl;
+        for (int i = 0; i < 64; ++i) {
+            sl.insert(PartiallyComparableValue(i));
+        }
+        for (size_t max_spare_nodes : {0, 4}) {
+            sl.set_node_reuse(max_spare_nodes);
+            // Create some spare Nodes.
+            for (int i = 0; i < 8; ++i) {
+                sl.insert(PartiallyComparableValue(100 + i));
+            }
+            for (int i = 0; i < 8; ++i) {
+                sl.remove(PartiallyComparableValue(100 + i));
+            }
+            for (int i = 0; i < 1000; ++i) {
+                try {
+                    sl.insert(PartiallyComparableValue(i % 64, false));
+                    result |= 1;
+                } catch (std::invalid_argument &err) {}
+            }
+            // Delete any spare Nodes, then only the values in the Skip List are alive.
+            sl.set_node_reuse(0);
+            result |= PartiallyComparableValue::live != static_cast<long>(sl.size());
+            result |= sl.size() != 64;
+            result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+        }
+    }
+    result |= PartiallyComparableValue::live != 0;
+    return result;
+}
+
+/**
+ * @brief Tests that \c .prefix() and \c .range() throw an \c OrderedStructs::SkipList::IndexError when out of range.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_sum_augment_prefix_fails() {
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<
+        double, std::less<double>, OrderedStructs::SkipList::SumAugment<double>
+    > sl;
+
+    srand(1);
+    sl.insert(42.0);
+    result |= sl.prefix(1).sum.value() != 42.0;
+    try {
+        sl.prefix(2);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sl.range(1, 1);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    return result;
+}
+
+/**
+ * @brief Tests the mean and variance of a trimmed range of a large Skip List with augmented widths.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_sum_augment_trimmed_mean_variance() {
+    int result = 0;
+    const size_t NUM = 1024 * 8;
+    const size_t TRIM = NUM / 10;
+    tSkipListSumSquares sl;
+
+    srand(1);
+    // Insert 0 to NUM - 1 in a scrambled order
+    for (size_t i = 0; i < NUM; ++i) {
+        sl.insert(static_cast<double>((i * 4099) % NUM));
+    }
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    size_t count = NUM - 2 * TRIM;
+    OrderedStructs::SkipList::SumSquaresAugment<double> aug = sl.range(TRIM, count);
+    // Values TRIM to NUM - TRIM - 1, mean is the mid-point, variance is (count**2 - 1) / 12
+    double mean = (TRIM + NUM - TRIM - 1) / 2.0;
+    double variance = (1.0 * count * count - 1.0) / 12.0;
+    result |= aug.mean(count) != mean;
+    result |= std::abs(aug.variance(count) - variance) > 1e-9 * variance;
+    return result;
+}
+
+/**
+ * @brief Tests \c .at_weight() on a Skip List with weighted values against a brute force cumulative weight.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_weight_augment_at_weight() {
+    int result = 0;
+    const size_t NUM = 512;
+    typedef OrderedStructs::SkipList::WeightedValue<double> tWeighted;
+    OrderedStructs::SkipList::HeadNode<
+        tWeighted, std::less<tWeighted>, OrderedStructs::SkipList::WeightAugment<tWeighted>
+    > sl;
+    std::vector<tWeighted> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        tWeighted value = {static_cast<double>(rand() % 100), static_cast<double>(rand() % 8)};
+        values.push_back(value);
+        sl.insert(value);
+    }
+    // Remove a quarter of them, including duplicates.
+    for (size_t i = 0; i < NUM / 4; ++i) {
+        size_t index = rand() % values.size();
+        sl.remove(values[index]);
+        values.erase(values.begin() + index);
+    }
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    std::sort(values.begin(), values.end());
+    double cumulative = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i].weight > 0.0) {
+            // Just over the previous cumulative weight and exactly at this one.
+            result |= sl.at_weight(cumulative + 0.5) != values[i];
+            cumulative += values[i].weight;
+            result |= sl.at_weight(cumulative) != values[i];
+        }
+    }
+    result |= sl.total().weight.value() != cumulative;
+    try {
+        sl.at_weight(cumulative + 1.0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    return result;
+}
+
+/******* END: Functional Tests with augmented widths **********/
+
+/************** Functional Tests of clone() ********************/
+
+/**
+ * @brief Tests that an empty Skip List can be cloned and the clone used.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_clone_empty() {
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<double> sl;
+
+    std::unique_ptr<OrderedStructs::SkipList::HeadNode<double>> copy = sl.clone();
+    result |= copy->size() != 0;
+    result |= copy->height() != 0;
+    result |= copy->lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    copy->insert(42.0);
+    result |= copy->at(0) != 42.0;
+    result |= sl.size() != 0;
+    return result;
+}
+
+/**
+ * @brief Tests that a clone of a Skip List with augmented widths after random inserts and removes has the same
+ * structure, values and augmentation and is independent of the original.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_clone_ins_rem_rand() {
+    int result = 0;
+    const size_t NUM = 256;
+    tSkipListSumSquares *pSl = new tSkipListSumSquares;
+    std::vector<double> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        double value = rand() % 64 - 16;
+        values.push_back(value);
+        pSl->insert(value);
+    }
+    for (size_t i = 0; i < NUM / 4; ++i) {
+        size_t index = rand() % values.size();
+        pSl->remove(values[index]);
+        values.erase(values.begin() + index);
+    }
+    std::unique_ptr<tSkipListSumSquares> copy = pSl->clone();
+    result |= copy->lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= copy->size() != pSl->size();
+    result |= copy->height() != pSl->height();
+    for (size_t i = 0; i < pSl->size(); ++i) {
+        result |= copy->at(i) != pSl->at(i);
+        result |= copy->height(i) != pSl->height(i);
+        for (size_t level = 0; level < pSl->height(i); ++level) {
+            result |= copy->width(i, level) != pSl->width(i, level);
+        }
+    }
+    result |= _check_sum_augment(*copy);
+    // Modifying the copy does not change the original.
+    copy->insert(1000.0);
+    copy->remove(values[0]);
+    result |= copy->lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= pSl->lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= pSl->size() != values.size();
+    result |= pSl->has(1000.0);
+    // The copy outlives the original.
+    delete pSl;
+    result |= copy->remove(1000.0) != 1000.0;
+    values.erase(values.begin());
+    std::sort(values.begin(), values.end());
+    result |= copy->size() != values.size();
+    for (size_t i = 0; i < values.size(); ++i) {
+        result |= copy->at(i) != values[i];
+    }
+    result |= _check_sum_augment(*copy);
+    return result;
+}
+
+/************** END: Functional Tests of clone() ***************/
+
+/************ Functional Tests of split and join ***************/
+
+/**
+ * @brief Check the integrity, values and augmentation of a Skip List against the expected sorted values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+static int _check_values(const tSkipListSumSquares &sl, std::vector<double>::const_iterator begin,
+                         std::vector<double>::const_iterator end) {
+    int result = 0;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= sl.size() != static_cast<size_t>(end - begin);
+    for (size_t i = 0; begin + i < end && i < sl.size(); ++i) {
+        result |= sl.at(i) != *(begin + i);
+    }
+    result |= _check_sum_augment(sl);
+    return result;
+}
+
+/**
+ * @brief Split a Skip List with augmented widths and duplicate values at every index then join the two parts again.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_split_at_index_join() {
+    int result = 0;
+    const size_t NUM = 64;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(rand() % 16);
+        sl.insert(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (size_t index = 0; index <= NUM; ++index) {
+        std::unique_ptr<tSkipListSumSquares> head = sl.clone();
+        std::unique_ptr<tSkipListSumSquares> tail = head->split_at_index(index);
+        result |= _check_values(*head, values.begin(), values.begin() + index);
+        result |= _check_values(*tail, values.begin() + index, values.end());
+        // Both parts can be modified.
+        head->insert(-1.0);
+        tail->insert(100.0);
+        result |= head->remove(-1.0) != -1.0;
+        result |= tail->remove(100.0) != 100.0;
+        head->join(*tail);
+        result |= _check_values(*head, values.begin(), values.end());
+        result |= _check_values(*tail, values.end(), values.end());
+    }
+    return result;
+}
+
+/**
+ * @brief Split a Skip List with augmented widths and duplicate values at values below, between, equal to and above the
+ * values then join the two parts again.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_split_at_value_join() {
+    int result = 0;
+    const size_t NUM = 64;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(2 * (rand() % 16));
+        sl.insert(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (double value = -1.0; value <= 33.0; value += 1.0) {
+        std::unique_ptr<tSkipListSumSquares> head = sl.clone();
+        std::unique_ptr<tSkipListSumSquares> tail = head->split_at_value(value);
+        auto split = std::lower_bound(values.begin(), values.end(), value);
+        result |= _check_values(*head, values.begin(), split);
+        result |= _check_values(*tail, split, values.end());
+        head->join(*tail);
+        result |= _check_values(*head, values.begin(), values.end());
+    }
+    return result;
+}
+
+/**
+ * @brief Tests that \c .split_at_index() throws an \c IndexError and \c .join() throws a \c ValueError on bad arguments
+ * and that joining with empty Skip Lists works.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_split_join_fails() {
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<double> sl;
+    OrderedStructs::SkipList::HeadNode<double> other;
+
+    sl.insert(1.0);
+    sl.insert(5.0);
+    try {
+        sl.split_at_index(3);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    other.insert(3.0);
+    try {
+        sl.join(other);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    result |= sl.size() != 2;
+    result |= other.size() != 1;
+    try {
+        sl.join(sl);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    // Equal values at the boundary are allowed.
+    other.remove(3.0);
+    other.insert(5.0);
+    sl.join(other);
+    result |= sl.size() != 3;
+    result |= other.size() != 0;
+    // Joining an empty Skip List, and to an empty Skip List.
+    sl.join(other);
+    result |= sl.size() != 3;
+    other.join(sl);
+    result |= other.size() != 3;
+    result |= sl.size() != 0;
+    result |= other.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
+/************ END: Functional Tests of split and join **********/
+
+/**************** Functional Tests of merge() *****************/
+
+/**
+ * @brief Merge Skip Lists with augmented widths and overlapping, duplicate values of different lengths, including
+ * empty ones, and check the values, integrity and augmentation.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_merge_overlapping() {
+    int result = 0;
+
+    srand(1);
+    for (size_t this_count : {0, 1, 7, 64, 200}) {
+        for (size_t other_count : {0, 1, 9, 64, 300}) {
+            tSkipListSumSquares sl;
+            tSkipListSumSquares other;
+            std::vector<double> values;
+            for (size_t i = 0; i < this_count; ++i) {
+                values.push_back(rand() % 32);
+                sl.insert(values.back());
+            }
+            for (size_t i = 0; i < other_count; ++i) {
+                values.push_back(rand() % 48 - 8);
+                other.insert(values.back());
+            }
+            sl.merge(other);
+            std::sort(values.begin(), values.end());
+            result |= _check_values(sl, values.begin(), values.end());
+            result |= _check_values(other, values.end(), values.end());
+            // The merged Skip List can be modified.
+            sl.insert(16.5);
+            result |= sl.remove(16.5) != 16.5;
+            result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Compare only the first of a pair so that pairs with equal first values can be told apart.
+ */
+struct CompareFirst {
+    bool operator()(const std::pair<int, int> &a, const std::pair<int, int> &b) const {
+        return a.first < b.first;
+    }
+};
+
+/**
+ * @brief Tests that \c .merge() puts the values of the other Skip List after equal values, as \c .insert() would, and
+ * that merging a Skip List with itself throws a \c ValueError.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_merge_equal_values_order() {
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<std::pair<int, int>, CompareFirst> sl;
+    OrderedStructs::SkipList::HeadNode<std::pair<int, int>, CompareFirst> other;
+
+    for (int i = 0; i < 32; ++i) {
+        sl.insert(std::make_pair(i % 4, 0));
+        other.insert(std::make_pair(i % 5, 1));
+    }
+    std::unique_ptr<OrderedStructs::SkipList::HeadNode<std::pair<int, int>, CompareFirst>> expected = sl.clone();
+    for (size_t i = 0; i < other.size(); ++i) {
+        expected->insert(other.at(i));
+    }
+    sl.merge(other);
+    result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    result |= sl.size() != expected->size();
+    result |= other.size() != 0;
+    for (size_t i = 0; i < sl.size(); ++i) {
+        result |= sl.at(i) != expected->at(i);
+    }
+    try {
+        sl.merge(sl);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    return result;
+}
+
+/**************** END: Functional Tests of merge() *************/
+
+/************ Functional Tests of removal by index ***************/
+
+/**
+ * @brief Remove each index of a Skip List with augmented widths and duplicate values with \c .remove_at() .
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_remove_at() {
+    int result = 0;
+    const size_t NUM = 64;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(rand() % 16);
+        sl.insert(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (size_t index = 0; index < NUM; ++index) {
+        std::unique_ptr<tSkipListSumSquares> copy = sl.clone();
+        std::vector<double> expected(values);
+        result |= copy->remove_at(index) != expected[index];
+        expected.erase(expected.begin() + index);
+        result |= _check_values(*copy, expected.begin(), expected.end());
+    }
+    try {
+        sl.remove_at(NUM);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    result |= _check_values(sl, values.begin(), values.end());
+    return result;
+}
+
+/**
+ * @brief Tests that \c .remove_at() removes exactly the value at the index when there are equal values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_remove_at_equal_values() {
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<std::pair<int, int>, CompareFirst> sl;
+
+    for (int i = 0; i < 32; ++i) {
+        sl.insert(std::make_pair(i % 4, i));
+    }
+    // Equal values are in insertion order.
+    for (size_t index = 0; sl.size(); index = sl.size() ? (index + 5) % sl.size() : 0) {
+        std::pair<int, int> expected = sl.at(index);
+        result |= sl.remove_at(index).second != expected.second;
+        result |= sl.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    }
+    return result;
+}
+
+/**
+ * @brief Empty a Skip List with augmented widths, and that reuses Nodes, by alternating \c .pop_front() and
+ * \c .pop_back() then refill it, checking \c .front() throughout. \c .front() or popping an empty Skip List throws
+ * an \c IndexError.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_pop_front_back() {
+    int result = 0;
+    const size_t NUM = 64;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    sl.set_node_reuse(8);
+    srand(1);
+    for (size_t repeat = 0; repeat < 2; ++repeat) {
+        for (size_t i = 0; i < NUM; ++i) {
+            values.push_back(rand() % 16);
+            sl.insert(values.back());
+        }
+        std::sort(values.begin(), values.end());
+        while (! values.empty()) {
+            result |= sl.front() != values.front();
+            if (values.size() % 2) {
+                result |= sl.pop_front() != values.front();
+                values.erase(values.begin());
+            } else {
+                result |= sl.pop_back() != values.back();
+                values.pop_back();
+            }
+            result |= _check_values(sl, values.begin(), values.end());
+        }
+        result |= sl.height() != 0;
+    }
+    try {
+        sl.front();
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sl.pop_front();
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sl.pop_back();
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    return result;
+}
+
+/**
+ * @brief Tests that emptying a Skip List with augmented widths with \c .pop_front() leaves a total of exactly zero
+ * regardless of any rounding error in removing the values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_pop_front_total_zero() {
+    int result = 0;
+    const size_t NUM = 256;
+    tSkipListSumSquares sl;
+
+    srand(1);
+    // Values over a wide range of magnitudes so that removing them one by one leaves a rounding residue.
+    for (size_t i = 0; i < NUM; ++i) {
+        sl.insert(std::ldexp(1.0 + rand() / (RAND_MAX + 1.0), rand() % 128 - 64));
+    }
+    while (sl.size()) {
+        sl.pop_front();
+    }
+    result |= sl.total().sum.value() != 0.0;
+    result |= sl.total().sum_squares.value() != 0.0;
+    return result;
+}
+
+/**
+ * @brief Remove every range of a Skip List with augmented widths and duplicate values with \c .remove_range() .
+ * Invalid ranges throw an \c IndexError.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_remove_range() {
+    int result = 0;
+    const size_t NUM = 48;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(rand() % 16);
+        sl.insert(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (size_t begin = 0; begin <= NUM; ++begin) {
+        for (size_t end = begin; end <= NUM; ++end) {
+            std::unique_ptr<tSkipListSumSquares> copy = sl.clone();
+            std::vector<double> expected(values);
+            copy->remove_range(begin, end);
+            expected.erase(expected.begin() + begin, expected.begin() + end);
+            result |= _check_values(*copy, expected.begin(), expected.end());
+        }
+    }
+    try {
+        sl.remove_range(1, 0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sl.remove_range(0, NUM + 1);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    result |= _check_values(sl, values.begin(), values.end());
+    return result;
+}
+
+/************ END: Functional Tests of removal by index ***************/
+
+/**
+ * @brief Tests that \c .insert_with_rank() returns the index where the value landed, after any equal values, for a
+ * Skip List with augmented widths that reuses Nodes.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_insert_with_rank() {
+    int result = 0;
+    const size_t NUM = 256;
+    tSkipListSumSquares sl;
+    std::vector<double> values;
+
+    sl.set_node_reuse(4);
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        double value = rand() % 32;
+        size_t expected = std::upper_bound(values.begin(), values.end(), value) - values.begin();
+        values.insert(values.begin() + expected, value);
+        result |= sl.insert_with_rank(value) != expected;
+        if (i % 3 == 0) {
+            size_t index = rand() % values.size();
+            result |= sl.remove_at(index) != values[index];
+            values.erase(values.begin() + index);
+        }
+    }
+    result |= _check_values(sl, values.begin(), values.end());
+    return result;
+}
+
+/******************** Functional Tests of TopK *******************/
+
+/**
+ * @brief Push random values with duplicates to a \c TopK and check that it has the largest values against a sorted
+ * vector of all the values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_top_k() {
+    int result = 0;
+    const size_t NUM = 1024;
+    const size_t K = 32;
+    OrderedStructs::SkipList::TopK<int> top_k(K);
+    std::vector<int> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        int value = rand() % 256;
+        // Kept if not full or greater than the smallest of the largest K.
+        bool expected = values.size() < K || value > values[values.size() - K];
+        values.insert(std::upper_bound(values.begin(), values.end(), value), value);
+        result |= top_k.push(value) != expected;
+        result |= top_k.size() != std::min(values.size(), K);
+        result |= top_k.boundary() != values[values.size() - top_k.size()];
+    }
+    result |= top_k.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    std::vector<int> kept;
+    top_k.at(0, K, kept);
+    result |= kept != std::vector<int>(values.end() - K, values.end());
+    result |= top_k.at(K - 1) != values.back();
+    top_k.clear();
+    result |= top_k.size() != 0;
+    result |= ! top_k.push(0);
+    result |= top_k.boundary() != 0;
+    return result;
+}
+
+/**
+ * @brief A \c TopK with \c std::greater keeps the smallest values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_bottom_k() {
+    int result = 0;
+    const size_t K = 4;
+    OrderedStructs::SkipList::TopK<double, std::greater<double>> bottom_k(K);
+
+    for (double value : {5.0, 3.0, 8.0, 1.0, 9.0, 3.0, 7.0, 0.0, 2.0}) {
+        bottom_k.push(value);
+    }
+    result |= bottom_k.size() != K;
+    std::vector<double> kept;
+    bottom_k.at(0, K, kept);
+    result |= kept != std::vector<double>({3.0, 2.0, 1.0, 0.0});
+    // Equal to the boundary is rejected.
+    result |= bottom_k.push(3.0);
+    result |= bottom_k.boundary() != 3.0;
+    result |= ! bottom_k.push(-1.0);
+    result |= bottom_k.boundary() != 2.0;
+    result |= bottom_k.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
+/** @brief A key that is compared by KeyLess with a payload that is not. */
+struct KeyPayload {
+    int key;
+    char payload;
+    bool operator==(const KeyPayload &other) const { return key == other.key && payload == other.payload; }
+    bool operator!=(const KeyPayload &other) const { return ! (*this == other); }
+    friend std::ostream &operator<<(std::ostream &os, const KeyPayload &value) {
+        return os << value.key << value.payload;
+    }
+};
+
+/** @brief Compares KeyPayload by key only. */
+struct KeyLess {
+    bool operator()(const KeyPayload &a, const KeyPayload &b) const { return a.key < b.key; }
+};
+
+/**
+ * @brief A \c TopK with equal keys keeps them in the order pushed, rejects a value equal to the boundary when full and
+ * evicts the earliest pushed of the values equal to the boundary first.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_top_k_equal_values() {
+    int result = 0;
+    OrderedStructs::SkipList::TopK<KeyPayload, KeyLess> top_k(3);
+    std::vector<KeyPayload> kept;
+
+    for (const KeyPayload &value : {KeyPayload{1, 'a'}, KeyPayload{1, 'b'}, KeyPayload{2, 'c'}}) {
+        result |= ! top_k.push(value);
+    }
+    result |= top_k.push(KeyPayload{1, 'd'});
+    top_k.at(0, 3, kept);
+    result |= kept != std::vector<KeyPayload>({{1, 'a'}, {1, 'b'}, {2, 'c'}});
+    result |= ! top_k.push(KeyPayload{3, 'e'});
+    top_k.at(0, 3, kept);
+    result |= kept != std::vector<KeyPayload>({{1, 'b'}, {2, 'c'}, {3, 'e'}});
+    result |= ! top_k.push(KeyPayload{2, 'f'});
+    top_k.at(0, 3, kept);
+    result |= kept != std::vector<KeyPayload>({{2, 'c'}, {2, 'f'}, {3, 'e'}});
+    result |= ! top_k.push(KeyPayload{4, 'g'});
+    top_k.at(0, 3, kept);
+    result |= kept != std::vector<KeyPayload>({{2, 'f'}, {3, 'e'}, {4, 'g'}});
+    result |= top_k.boundary() != KeyPayload{2, 'f'};
+    result |= top_k.lacksIntegrity() != OrderedStructs::SkipList::INTEGRITY_SUCCESS;
+    return result;
+}
+
+/**
+ * @brief A \c TopK fails with a capacity of zero, a NaN or the boundary of an empty \c TopK .
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_top_k_fails() {
+    int result = 0;
+
+    try {
+        OrderedStructs::SkipList::TopK<double> top_k(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    OrderedStructs::SkipList::TopK<double> top_k(2);
+    try {
+        top_k.boundary();
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    top_k.push(1.0);
+    top_k.push(2.0);
+    try {
+        top_k.push(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    result |= top_k.size() != 2;
+    return result;
+}
+
+/****************** END: Functional Tests of TopK *****************/
+
+/************ Functional Tests of floor, ceiling and nearest ***************/
+
+/**
+ * @brief Check \c .floor() , \c .ceiling() and \c .nearest() of a Skip List with duplicate values against a search
+ * of the sorted values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_floor_ceiling_nearest() {
+    int result = 0;
+    const size_t NUM = 64;
+    OrderedStructs::SkipList::HeadNode<double> sl;
+    std::vector<double> values;
+
+    result |= sl.floor(1.0).has_value();
+    result |= sl.ceiling(1.0).has_value();
+    result |= sl.nearest(1.0).has_value();
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(rand() % 64);
+        sl.insert(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (double value = -2.0; value < 66.0; value += 0.25) {
+        std::vector<double>::const_iterator upper = std::upper_bound(values.begin(), values.end(), value);
+        std::vector<double>::const_iterator lower = std::lower_bound(values.begin(), values.end(), value);
+        std::optional<double> floor = sl.floor(value);
+        std::optional<double> ceiling = sl.ceiling(value);
+        std::optional<double> nearest = sl.nearest(value);
+        result |= floor.has_value() != (upper != values.begin());
+        result |= floor.has_value() && *floor != *(upper - 1);
+        result |= ceiling.has_value() != (lower != values.end());
+        result |= ceiling.has_value() && *ceiling != *lower;
+        double expected;
+        if (! floor.has_value()) {
+            expected = *ceiling;
+        } else if (! ceiling.has_value()) {
+            expected = *floor;
+        } else {
+            expected = *ceiling - value < value - *floor ? *ceiling : *floor;
+        }
+        result |= ! nearest.has_value() || *nearest != expected;
+    }
+    return result;
+}
+
+/**
+ * @brief Tests that \c .nearest() does not overflow for integers at the limits, that equally close values give the
+ * smaller and that a reversed comparison function reverses floor and ceiling.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_nearest_limits_reversed() {
+    int result = 0;
+    OrderedStructs::SkipList::HeadNode<long long> sl;
+
+    sl.insert(std::numeric_limits<long long>::min());
+    sl.insert(std::numeric_limits<long long>::max());
+    result |= sl.nearest(0) != std::numeric_limits<long long>::max();
+    result |= sl.nearest(-1) != std::numeric_limits<long long>::min();
+    result |= sl.floor(0) != std::numeric_limits<long long>::min();
+    result |= sl.ceiling(0) != std::numeric_limits<long long>::max();
+    sl.insert(10);
+    sl.insert(20);
+    result |= sl.nearest(15) != 10;
+    result |= sl.nearest(16) != 20;
+
+    OrderedStructs::SkipList::HeadNode<int, std::greater<int>> reversed;
+    for (int value : {10, 20, 30}) {
+        reversed.insert(value);
+    }
+    result |= reversed.floor(25) != 30;
+    result |= reversed.ceiling(25) != 20;
+    result |= reversed.floor(35).has_value();
+    result |= reversed.ceiling(5).has_value();
+    // Equally close, the first by the comparison function.
+    result |= reversed.nearest(25) != 30;
+    try {
+        OrderedStructs::SkipList::HeadNode<double>().floor(std::numeric_limits<double>::quiet_NaN());
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * @brief Tests \c .index() of values that are present, with duplicates, and absent on a large Skip List. Searching for
+ * an absent value used to retry every level below each node and took minutes.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_index_present_absent_large() {
+    int result = 0;
+    const size_t NUM = 1 << 14;
+    OrderedStructs::SkipList::HeadNode<long long> sl;
+    std::vector<long long> values;
+
+    srand(1);
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(2 * (rand() % (NUM / 2)));
+        sl.insert(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    for (long long value = -1; value <= static_cast<long long>(NUM) + 1; ++value) {
+        std::vector<long long>::const_iterator lower = std::lower_bound(values.begin(), values.end(), value);
+        try {
+            size_t index = sl.index(value);
+            result |= lower == values.end() || *lower != value;
+            result |= index != static_cast<size_t>(lower - values.begin());
+        } catch (OrderedStructs::SkipList::ValueError &err) {
+            result |= lower != values.end() && *lower == value;
+        }
+    }
+    return result;
+}
+
+/********* END: Functional Tests of floor, ceiling and nearest ************/
+
 /***************** END: Functional Tests ************************/
 
 /**
@@ -745,7 +1825,41 @@ int test_functional_all() {
                            test_index_basic_7_node());
     result |= print_result("test_index_throws", test_index_throws());
     result |= print_result("test_index_large", test_index_large());
+    result |= print_result("test_index_not_present_large", test_index_not_present_large());
     // Tests of reversed skiplists
     result |= print_result("test_reversed_simple_insert", test_reversed_simple_insert());
+    // Tests of augmented widths
+    result |= print_result("test_sum_augment_ins_rem_rand", test_sum_augment_ins_rem_rand());
+    result |= print_result("test_node_reuse_ins_rem_rand", test_node_reuse_ins_rem_rand());
+    result |= print_result("test_insert_comparison_throws_no_leak", test_insert_comparison_throws_no_leak());
+    result |= print_result("test_sum_augment_prefix_fails", test_sum_augment_prefix_fails());
+    result |= print_result("test_sum_augment_trimmed_mean_variance", test_sum_augment_trimmed_mean_variance());
+    result |= print_result("test_weight_augment_at_weight", test_weight_augment_at_weight());
+    // Tests of clone()
+    result |= print_result("test_clone_empty", test_clone_empty());
+    result |= print_result("test_clone_ins_rem_rand", test_clone_ins_rem_rand());
+    // Tests of split and join
+    result |= print_result("test_split_at_index_join", test_split_at_index_join());
+    result |= print_result("test_split_at_value_join", test_split_at_value_join());
+    result |= print_result("test_split_join_fails", test_split_join_fails());
+    // Tests of merge()
+    result |= print_result("test_merge_overlapping", test_merge_overlapping());
+    result |= print_result("test_merge_equal_values_order", test_merge_equal_values_order());
+    // Tests of removal by index
+    result |= print_result("test_remove_at", test_remove_at());
+    result |= print_result("test_remove_at_equal_values", test_remove_at_equal_values());
+    result |= print_result("test_pop_front_back", test_pop_front_back());
+    result |= print_result("test_pop_front_total_zero", test_pop_front_total_zero());
+    result |= print_result("test_remove_range", test_remove_range());
+    result |= print_result("test_insert_with_rank", test_insert_with_rank());
+    // Tests of TopK
+    result |= print_result("test_top_k", test_top_k());
+    result |= print_result("test_bottom_k", test_bottom_k());
+    result |= print_result("test_top_k_equal_values", test_top_k_equal_values());
+    result |= print_result("test_top_k_fails", test_top_k_fails());
+    // Tests of floor(), ceiling() and nearest()
+    result |= print_result("test_floor_ceiling_nearest", test_floor_ceiling_nearest());
+    result |= print_result("test_nearest_limits_reversed", test_nearest_limits_reversed());
+    result |= print_result("test_index_present_absent_large", test_index_present_absent_large());
     return result;
 }
@@ -39,8 +39,10 @@
  * @endcode
  */
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <thread>
 
 #include "RollingMedian.h"
 #include "TestFramework.h"
@@ -48,6 +50,7 @@
 #include "test_print.h"
 
 #include "../SkipList.h"
+#include "../TopK.h"
 
 /** @brief The number of times to repeat a test to get an accurate performance figure. */
 static int GLOBAL_REPEAT_COUNT = 1000 * 1000;
@@ -983,6 +986,310 @@ int perf_test_node_height_growth(size_t repeat, TestResultS &test_results) {
     return result;
 }
 
+/**
+ * @brief Compare copying a Skip List with clone() with rebuilding it by inserting every value into a new Skip List
+ * for different lengths.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_clone_vs_insert(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+
+    for (size_t sl_length = 1 << 10; sl_length <= 1 << 20; sl_length *= 8) {
+        OrderedStructs::SkipList::HeadNode<double> sl;
+        for (size_t i = 0; i < sl_length; ++i) {
+            sl.insert(rand());
+        }
+        std::vector<double> values;
+        sl.at(0, sl_length, values);
+        for (const char *method : {"clone", "insert"}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << method << "][" << sl_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                ExecClock exec_clock;
+                if (method == std::string("clone")) {
+                    std::unique_ptr<OrderedStructs::SkipList::HeadNode<double>> copy = sl.clone();
+                    result |= copy->size() != sl_length;
+                } else {
+                    OrderedStructs::SkipList::HeadNode<double> copy;
+                    for (const double &value : values) {
+                        copy.insert(value);
+                    }
+                    result |= copy.size() != sl_length;
+                }
+                double exec_time = exec_clock.seconds();
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, sl_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Time split_at_index() at the middle then join() for different lengths, these should be O(log(n)).
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_split_join(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t SPLIT_JOIN_COUNT = 1000;
+
+    for (size_t sl_length = 1 << 10; sl_length <= 1 << 20; sl_length *= 8) {
+        OrderedStructs::SkipList::HeadNode<double> sl;
+        for (size_t i = 0; i < sl_length; ++i) {
+            sl.insert(rand());
+        }
+        std::ostringstream title;
+        title << __FUNCTION__ << "[" << sl_length << "]";
+        TestResult test_result(title.str());
+        for (size_t r = 0; r < repeat; ++r) {
+            ExecClock exec_clock;
+            for (size_t i = 0; i < SPLIT_JOIN_COUNT; ++i) {
+                std::unique_ptr<OrderedStructs::SkipList::HeadNode<double>> tail = sl.split_at_index(
+                        rand() % sl_length);
+                sl.join(*tail);
+            }
+            double exec_time = exec_clock.seconds();
+            result |= sl.size() != sl_length;
+            if (r == 0) {
+                std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+            }
+            test_result.execTimeAdd(0, exec_time, SPLIT_JOIN_COUNT, sl_length);
+        }
+        test_results.push_back(test_result);
+    }
+    return result;
+}
+
+/**
+ * @brief Compare merging two Skip Lists of random values, each of half the length, with merge() and with inserting the
+ * values of one into the other for different lengths.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_merge_vs_insert(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+
+    for (size_t sl_length = 1 << 10; sl_length <= 1 << 20; sl_length *= 8) {
+        for (const char *method : {"merge", "insert"}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << method << "][" << sl_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                OrderedStructs::SkipList::HeadNode<double> sl;
+                OrderedStructs::SkipList::HeadNode<double> other;
+                for (size_t i = 0; i < sl_length / 2; ++i) {
+                    sl.insert(rand());
+                    other.insert(rand());
+                }
+                ExecClock exec_clock;
+                if (method == std::string("merge")) {
+                    sl.merge(other);
+                } else {
+                    for (size_t i = 0; i < other.size(); ++i) {
+                        sl.insert(other.at(i));
+                    }
+                }
+                double exec_time = exec_clock.seconds();
+                result |= sl.size() != sl_length;
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, sl_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+// Empty a Skip List of random doubles by remove_at() and by at() then remove() at random indexes, by pop_front() and
+// by remove_range().
+int perf_remove_at_vs_remove(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+
+    for (size_t sl_length = 1 << 10; sl_length <= 1 << 20; sl_length *= 8) {
+        for (const char *method : {"remove_at", "at_remove", "pop_front", "remove_range"}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << method << "][" << sl_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                OrderedStructs::SkipList::HeadNode<double> sl;
+                std::vector<size_t> indexes;
+                for (size_t i = 0; i < sl_length; ++i) {
+                    sl.insert(rand());
+                    indexes.push_back(rand() % (sl_length - i));
+                }
+                ExecClock exec_clock;
+                if (method == std::string("remove_at")) {
+                    for (size_t i = 0; i < sl_length; ++i) {
+                        sl.remove_at(indexes[i]);
+                    }
+                } else if (method == std::string("at_remove")) {
+                    for (size_t i = 0; i < sl_length; ++i) {
+                        sl.remove(sl.at(indexes[i]));
+                    }
+                } else if (method == std::string("pop_front")) {
+                    for (size_t i = 0; i < sl_length; ++i) {
+                        sl.pop_front();
+                    }
+                } else {
+                    sl.remove_range(0, sl_length);
+                }
+                double exec_time = exec_clock.seconds();
+                result |= sl.size() != 0;
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, sl_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+// Insert random doubles into a Skip List and find their index by insert_with_rank() and by insert() then index().
+int perf_insert_with_rank(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+
+    for (size_t sl_length = 1 << 10; sl_length <= 1 << 20; sl_length *= 8) {
+        for (const char *method : {"insert_with_rank", "insert_index"}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << method << "][" << sl_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                OrderedStructs::SkipList::HeadNode<double> sl;
+                std::vector<double> values;
+                for (size_t i = 0; i < sl_length; ++i) {
+                    values.push_back(rand());
+                }
+                size_t total = 0;
+                ExecClock exec_clock;
+                if (method == std::string("insert_with_rank")) {
+                    for (double value : values) {
+                        total += sl.insert_with_rank(value);
+                    }
+                } else {
+                    for (double value : values) {
+                        sl.insert(value);
+                        total += sl.index(value);
+                    }
+                }
+                double exec_time = exec_clock.seconds();
+                result |= sl.size() != sl_length || total == 0;
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, sl_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+// Keep the largest K of 1m random doubles with a TopK and with a HeadNode that has every value inserted then the
+// smallest removed.
+int perf_top_k(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t NUM = 1 << 20;
+    std::vector<double> values;
+    for (size_t i = 0; i < NUM; ++i) {
+        values.push_back(rand());
+    }
+    for (size_t k = 16; k <= 1 << 16; k *= 64) {
+        for (const char *method : {"TopK", "insert_pop_front"}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << method << "][" << k << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                double largest = 0;
+                ExecClock exec_clock;
+                if (method == std::string("TopK")) {
+                    OrderedStructs::SkipList::TopK<double> top_k(k);
+                    for (double value : values) {
+                        top_k.push(value);
+                    }
+                    largest = top_k.at(k - 1);
+                } else {
+                    OrderedStructs::SkipList::HeadNode<double> sl(std::less<double>(), false);
+                    for (double value : values) {
+                        sl.insert(value);
+                        if (sl.size() > k) {
+                            sl.pop_front();
+                        }
+                    }
+                    largest = sl.at(k - 1);
+                }
+                double exec_time = exec_clock.seconds();
+                result |= largest != *std::max_element(values.begin(), values.end());
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, NUM);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+// Query a Skip List of the even integers with random integers, half are present, by floor(), nearest() and by the
+// emulation of index() and at() that throws a ValueError for the values that are not present.
+int perf_floor_nearest_vs_index(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t NUM_QUERIES = 1 << 16;
+
+    for (size_t sl_length = 1 << 10; sl_length <= 1 << 20; sl_length *= 8) {
+        OrderedStructs::SkipList::HeadNode<long long> sl;
+        for (size_t i = 0; i < sl_length; ++i) {
+            sl.insert(2 * static_cast<long long>(i));
+        }
+        std::vector<long long> queries;
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            queries.push_back(rand() % (2 * sl_length));
+        }
+        for (const char *method : {"floor", "nearest", "index_at"}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << method << "][" << sl_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                long long total = 0;
+                ExecClock exec_clock;
+                if (method == std::string("floor")) {
+                    for (long long query : queries) {
+                        total += sl.floor(query).value_or(0);
+                    }
+                } else if (method == std::string("nearest")) {
+                    for (long long query : queries) {
+                        total += *sl.nearest(query);
+                    }
+                } else {
+                    for (long long query : queries) {
+                        try {
+                            total += sl.at(sl.index(query));
+                        } catch (OrderedStructs::SkipList::ValueError &err) {}
+                    }
+                }
+                double exec_time = exec_clock.seconds();
+                result |= total == 0;
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, NUM_QUERIES, sl_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
 // Tests evaluating a rolling median on 1m doubles with different window lengths.
 int perf_roll_med_by_win_size(size_t repeat, TestResultS &test_results) {
     int result = 0;
@@ -1019,6 +1326,438 @@ int perf_roll_med_by_win_size(size_t repeat, TestResultS &test_results) {
     return result;
 }
 
+/**
+ * @brief Compare the performance of the rolling median on 1m doubles with a SortedWindow and with a Skip List by
+ * window length. This shows the crossover that is used for RollingMedian::SORTED_WINDOW_MAX_WIN_LENGTH.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_med_engine_crossover(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 20;
+    double *src = new double[ARRAY_SIZE];
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        src[i] = rand();
+    }
+    double *dest = new double[ARRAY_SIZE];
+    for (size_t win_length : {3, 9, 33, 101, 257, 1025, 2049, 4097, 8193, 16385}) {
+        for (bool sorted_window : {true, false}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << (sorted_window ? "SortedWindow" : "HeadNode") << "][" << win_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                ExecClock exec_clock;
+                if (sorted_window) {
+                    OrderedStructs::RollingMedian::SortedWindow<double> sw(win_length);
+                    result |= OrderedStructs::RollingMedian::_odd_index(sw, src, 1, ARRAY_SIZE, win_length, dest, 1);
+                } else {
+                    OrderedStructs::SkipList::HeadNode<double> sl(std::less<double>(), false);
+                    result |= OrderedStructs::RollingMedian::_odd_index(sl, src, 1, ARRAY_SIZE, win_length, dest, 1);
+                }
+                double exec_time = exec_clock.seconds();
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, win_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    delete[] dest;
+    delete[] src;
+    return result;
+}
+
+/**
+ * @brief Compare the performance of the rolling median on 1m uint16_t values with a HistogramWindow, a SortedWindow,
+ * a Skip List and odd_index(), which chooses the engine, by range of values and window length.
+ * This shows the crossover that is used for RollingMedian::HISTOGRAM_WINDOW_MAX_BINS_PER_VALUE.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_med_histogram(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 20;
+    uint16_t *src = new uint16_t[ARRAY_SIZE];
+    uint16_t *dest = new uint16_t[ARRAY_SIZE];
+    for (size_t value_range : {256, 4096, 65536}) {
+        for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+            src[i] = rand() % value_range;
+        }
+        for (size_t win_length : {3, 9, 33, 101, 257, 1025, 4097}) {
+            for (const char *engine : {"HistogramWindow", "SortedWindow", "HeadNode", "odd_index"}) {
+                std::ostringstream title;
+                title << __FUNCTION__ << "[" << engine << "][" << value_range << "][" << win_length << "]";
+                TestResult test_result(title.str());
+                for (size_t r = 0; r < repeat; ++r) {
+                    ExecClock exec_clock;
+                    if (engine == std::string("HistogramWindow")) {
+                        OrderedStructs::RollingMedian::HistogramWindow<uint16_t> hw(0, value_range - 1);
+                        result |= OrderedStructs::RollingMedian::_odd_index(hw, src, 1, ARRAY_SIZE, win_length,
+                                                                             dest, 1);
+                    } else if (engine == std::string("SortedWindow")) {
+                        OrderedStructs::RollingMedian::SortedWindow<uint16_t> sw(win_length);
+                        result |= OrderedStructs::RollingMedian::_odd_index(sw, src, 1, ARRAY_SIZE, win_length,
+                                                                             dest, 1);
+                    } else if (engine == std::string("HeadNode")) {
+                        OrderedStructs::SkipList::HeadNode<uint16_t> sl(std::less<uint16_t>(), false);
+                        result |= OrderedStructs::RollingMedian::_odd_index(sl, src, 1, ARRAY_SIZE, win_length,
+                                                                             dest, 1);
+                    } else {
+                        result |= OrderedStructs::RollingMedian::odd_index(src, 1, ARRAY_SIZE, win_length, dest, 1);
+                    }
+                    double exec_time = exec_clock.seconds();
+                    if (r == 0) {
+                        std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                    }
+                    test_result.execTimeAdd(0, exec_time, 1, win_length);
+                }
+                test_results.push_back(test_result);
+            }
+        }
+    }
+    delete[] dest;
+    delete[] src;
+    return result;
+}
+
+/**
+ * @brief Performance of the 2D median filter of a 1024 x 1024 image by type and kernel size.
+ * uint8_t and uint16_t use a HistogramWindow, double uses a SortedWindow.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+template<typename T>
+static int _perf_median_filter_2d(const char *type_name, size_t value_range, size_t repeat,
+                                  TestResultS &test_results) {
+    int result = 0;
+    const size_t SIZE = 1024;
+    std::vector<T> src(SIZE * SIZE);
+    std::vector<T> dest(SIZE * SIZE);
+    for (auto &value: src) {
+        value = static_cast<T>(rand() % value_range);
+    }
+    for (size_t kernel : {3, 5, 9, 15}) {
+        std::ostringstream title;
+        title << "perf_median_filter_2d" << "[" << type_name << "][" << kernel << "]";
+        TestResult test_result(title.str());
+        for (size_t r = 0; r < repeat; ++r) {
+            ExecClock exec_clock;
+            result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), SIZE, 1, SIZE, SIZE, kernel,
+                                                                      dest.data(), SIZE - kernel + 1, 1);
+            double exec_time = exec_clock.seconds();
+            if (r == 0) {
+                std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+            }
+            test_result.execTimeAdd(0, exec_time, 1, kernel);
+        }
+        test_results.push_back(test_result);
+    }
+    return result;
+}
+
+int perf_median_filter_2d(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    result |= _perf_median_filter_2d<uint8_t>("uint8_t", 256, repeat, test_results);
+    result |= _perf_median_filter_2d<uint16_t>("uint16_t", 4096, repeat, test_results);
+    result |= _perf_median_filter_2d<double>("double", 1 << 30, repeat, test_results);
+    return result;
+}
+
+/**
+ * @brief Performance of the time window rolling median of 1m doubles with an average of 1000 values in the window for
+ * different arrival patterns compared with a fixed window of 1001 values.
+ * "regular" has one sample per tick, "random" has random intervals, "bursty" has bursts of up to 1000 samples at the
+ * same time separated by gaps so that many samples are evicted in each batch.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_med_time_window(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 20;
+    const int64_t DURATION = 1000;
+    std::vector<double> src(ARRAY_SIZE);
+    std::vector<double> dest(ARRAY_SIZE);
+    std::vector<int64_t> timestamps(ARRAY_SIZE);
+    for (auto &value: src) {
+        value = rand();
+    }
+    for (const char *pattern : {"fixed", "regular", "random", "bursty"}) {
+        int64_t now = 0;
+        size_t burst = 0;
+        for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+            if (pattern == std::string("random")) {
+                now += rand() % 3;
+            } else if (pattern == std::string("bursty")) {
+                if (burst == 0) {
+                    burst = rand() % 1000;
+                    now += burst;
+                } else {
+                    --burst;
+                }
+            } else {
+                ++now;
+            }
+            timestamps[i] = now;
+        }
+        std::ostringstream title;
+        title << __FUNCTION__ << "[" << pattern << "]";
+        TestResult test_result(title.str());
+        for (size_t r = 0; r < repeat; ++r) {
+            ExecClock exec_clock;
+            if (pattern == std::string("fixed")) {
+                OrderedStructs::SkipList::HeadNode<double> sl(std::less<double>(), false);
+                result |= OrderedStructs::RollingMedian::_odd_index(sl, src.data(), 1, ARRAY_SIZE, DURATION + 1,
+                                                                     dest.data(), 1);
+            } else {
+                result |= OrderedStructs::RollingMedian::time_window_median(timestamps.data(), 1, src.data(), 1,
+                                                                            ARRAY_SIZE, DURATION, dest.data(), 1);
+            }
+            double exec_time = exec_clock.seconds();
+            if (r == 0) {
+                std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+            }
+            test_result.execTimeAdd(0, exec_time, 1, ARRAY_SIZE);
+        }
+        test_results.push_back(test_result);
+    }
+    return result;
+}
+
+/**
+ * @brief Naive rolling MAD that copies out the window on every step with at(0, win_length, vec) and finds the median
+ * of the deviations with std::nth_element().
+ */
+static void _rolling_mad_copy_out(const double *src, size_t count, size_t win_length, double *dest_median,
+                                  double *dest_mad) {
+    OrderedStructs::SkipList::HeadNode<double> sl(std::less<double>(), false);
+    std::vector<double> window;
+    for (size_t i = 0; i < count; ++i) {
+        sl.insert(src[i]);
+        if (i + 1 >= win_length) {
+            sl.at(0, win_length, window);
+            double median = window[win_length / 2];
+            for (auto &value: window) {
+                value = std::abs(value - median);
+            }
+            std::nth_element(window.begin(), window.begin() + win_length / 2, window.end());
+            *dest_median++ = median;
+            *dest_mad++ = window[win_length / 2];
+            sl.remove(src[i + 1 - win_length]);
+        }
+    }
+}
+
+/**
+ * @brief Compare the performance of the rolling median and MAD on 256k doubles with the naive copy out approach by
+ * window length.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_med_mad(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 18;
+    std::vector<double> src(ARRAY_SIZE);
+    std::vector<double> dest_median(ARRAY_SIZE);
+    std::vector<double> dest_mad(ARRAY_SIZE);
+    for (auto &value: src) {
+        value = rand();
+    }
+    for (size_t win_length : {11, 101, 1001}) {
+        for (bool copy_out : {true, false}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << (copy_out ? "copy_out" : "rolling_median_mad") << "][" << win_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                ExecClock exec_clock;
+                if (copy_out) {
+                    _rolling_mad_copy_out(src.data(), ARRAY_SIZE, win_length, dest_median.data(), dest_mad.data());
+                } else {
+                    result |= OrderedStructs::RollingMedian::rolling_median_mad(src.data(), 1, ARRAY_SIZE,
+                                                                                win_length, dest_median.data(),
+                                                                                dest_mad.data(), 1);
+                }
+                double exec_time = exec_clock.seconds();
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, win_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Accuracy and memory of the approximate rolling median against the exact Skip List for long windows of a
+ * series of 2m doubles.
+ *
+ * For each window length and rank error this reports the time, the bytes used at the end and the worst rank error of
+ * a sample of the results as a fraction of the window length. The exact Skip List has a rank error of zero.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_med_approximate(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 21;
+    std::vector<double> src(ARRAY_SIZE);
+    std::vector<double> dest(ARRAY_SIZE);
+    for (auto &value: src) {
+        value = rand();
+    }
+    for (size_t win_length : {1 << 16, 1 << 18, 1 << 20}) {
+        for (double epsilon : {0.0, 0.1, 0.03, 0.01}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << win_length << "][";
+            if (epsilon == 0.0) {
+                title << "exact";
+            } else {
+                title << epsilon;
+            }
+            title << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                ExecClock exec_clock;
+                if (epsilon == 0.0) {
+                    result |= OrderedStructs::RollingMedian::even_odd_index(src.data(), 1, ARRAY_SIZE, win_length,
+                                                                            dest.data(), 1);
+                } else {
+                    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(src.data(), 1, ARRAY_SIZE,
+                                                                                       win_length, dest.data(), 1,
+                                                                                       epsilon);
+                }
+                double exec_time = exec_clock.seconds();
+                if (r == 0) {
+                    // Memory of a full window.
+                    size_t size_of;
+                    if (epsilon == 0.0) {
+                        OrderedStructs::SkipList::HeadNode<double> sl(std::less<double>(), false);
+                        for (size_t i = 0; i < win_length; ++i) {
+                            sl.insert(src[i]);
+                        }
+                        size_of = sl.size_of();
+                    } else {
+                        OrderedStructs::RollingMedian::WindowedQuantileSketch<double> sketch(win_length, epsilon);
+                        for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+                            sketch.push(src[i]);
+                        }
+                        size_of = sketch.size_of();
+                    }
+                    // Worst rank error of a sample of the windows.
+                    double worst = 0.0;
+                    const size_t dest_count = ARRAY_SIZE - win_length + 1;
+                    for (size_t i = 0; i < dest_count; i += dest_count / 16) {
+                        std::vector<double> window(src.begin() + i, src.begin() + i + win_length);
+                        std::sort(window.begin(), window.end());
+                        double lower = std::lower_bound(window.begin(), window.end(), dest[i]) - window.begin();
+                        double upper = std::upper_bound(window.begin(), window.end(), dest[i]) - window.begin();
+                        double target = (win_length - 1) / 2.0;
+                        if (target < lower) {
+                            worst = std::max(worst, (lower - target) / win_length);
+                        } else if (target > upper) {
+                            worst = std::max(worst, (target - upper) / win_length);
+                        }
+                    }
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)";
+                    std::cout << " bytes = " << size_of << " rank error = " << worst << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, win_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Performance of the chunked parallel rolling median of one series of 4m doubles by window length and
+ * number of threads.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_med_parallel_by_win_size(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 22;
+    const size_t hardware_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    double *src = new double[ARRAY_SIZE];
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        src[i] = rand();
+    }
+    double *dest = new double[ARRAY_SIZE];
+    for (size_t win_length = 1; win_length <= 1 << 12; win_length *= 8) {
+        for (size_t thread_count = 1; thread_count <= hardware_threads; thread_count *= 2) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << win_length << "][" << thread_count << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                ExecClock exec_clock;
+                result |= OrderedStructs::RollingMedian::even_odd_index_parallel(src, 1, ARRAY_SIZE, win_length,
+                                                                                 dest, 1, thread_count);
+                double exec_time = exec_clock.seconds();
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, win_length);
+            }
+            test_results.push_back(test_result);
+        }
+    }
+    delete[] dest;
+    delete[] src;
+    return result;
+}
+
+/**
+ * @brief Compare the performance of rolling p50/p90/p99/p99.9 computed together from one Skip List with a separate
+ * rolling pass for each quantile. 1m doubles with different window lengths.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int perf_roll_quantile_single_vs_multi_pass(size_t repeat, TestResultS &test_results) {
+    int result = 0;
+    const size_t ARRAY_SIZE = 1 << 20;
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    const size_t QUANTILE_COUNT = sizeof(quantiles) / sizeof(quantiles[0]);
+    double *src = new double[ARRAY_SIZE];
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        src[i] = rand();
+    }
+    for (size_t win_length = 16; win_length <= 1 << 12; win_length *= 16) {
+        size_t dest_size = OrderedStructs::RollingMedian::dest_size(ARRAY_SIZE, win_length, QUANTILE_COUNT);
+        double *dest = new double[dest_size];
+        for (bool single_pass : {true, false}) {
+            std::ostringstream title;
+            title << __FUNCTION__ << "[" << (single_pass ? "single" : "multi") << "][" << win_length << "]";
+            TestResult test_result(title.str());
+            for (size_t r = 0; r < repeat; ++r) {
+                ExecClock exec_clock;
+                if (single_pass) {
+                    result |= OrderedStructs::RollingMedian::rolling_quantile(
+                        src, 1, ARRAY_SIZE, win_length, quantiles, QUANTILE_COUNT, dest, QUANTILE_COUNT
+                    );
+                } else {
+                    // Writes each quantile into its column of the same destination.
+                    for (size_t q = 0; q < QUANTILE_COUNT; ++q) {
+                        result |= OrderedStructs::RollingMedian::rolling_quantile(
+                            src, 1, ARRAY_SIZE, win_length, quantiles + q, 1, dest + q, QUANTILE_COUNT
+                        );
+                    }
+                }
+                double exec_time = exec_clock.seconds();
+                if (r == 0) {
+                    std::cout << title.str() << " Sample time = " << exec_time << "(s)" << std::endl;
+                }
+                test_result.execTimeAdd(0, exec_time, 1, win_length);
+            }
+            test_results.push_back(test_result);
+        }
+        delete[] dest;
+    }
+    delete[] src;
+    return result;
+}
+
 /**
  * @brief Test the performance of a simple rolling median into a dynamic array of doubles given by
  * \c OrderedStructs::RollingMedian::dest_size. Odd length window.
@@ -1275,11 +2014,26 @@ int perf_skiplist() {
     result |= perf_test_double_has_1m_all(10, 5, perf_test_results);
     result |= perf_test_double_index_1m_all(10, 5, perf_test_results);
     result |= perf_test_node_height_growth(20, perf_test_results);
+    result |= perf_clone_vs_insert(5, perf_test_results);
+    result |= perf_split_join(5, perf_test_results);
+    result |= perf_merge_vs_insert(5, perf_test_results);
+    result |= perf_remove_at_vs_remove(5, perf_test_results);
+    result |= perf_insert_with_rank(5, perf_test_results);
+    result |= perf_top_k(5, perf_test_results);
+    result |= perf_floor_nearest_vs_index(5, perf_test_results);
 #endif
 #if 1
     // Rolling median tests
     result |= perf_roll_med_by_win_size(10, perf_test_results);
     result |= perf_roll_med_odd_index_wins(5, perf_test_results);
+    result |= perf_roll_quantile_single_vs_multi_pass(3, perf_test_results);
+    result |= perf_roll_med_parallel_by_win_size(3, perf_test_results);
+    result |= perf_roll_med_engine_crossover(3, perf_test_results);
+    result |= perf_roll_med_histogram(3, perf_test_results);
+    result |= perf_median_filter_2d(3, perf_test_results);
+    result |= perf_roll_med_time_window(3, perf_test_results);
+    result |= perf_roll_med_mad(3, perf_test_results);
+    result |= perf_roll_med_approximate(3, perf_test_results);
     result |= perf_roll_med_vector_style_even_win_length(5, perf_test_results);
     result |= perf_roll_med_vector_style_odd_win_length(5, perf_test_results);
     result |= perf_roll_med_vector_style_even_win_length_string(5, perf_test_results);
@@ -5,6 +5,8 @@
 //  Created by Paul Ross on 13/07/2016.
 //  Copyright (c) 2016 Paul Ross. All rights reserved.
 //
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 
@@ -115,6 +117,1061 @@ int test_roll_med_even_mean() {
     return result;
 }
 
+/**
+ * @brief Test the rolling median, mean and variance computed together against even_odd_index() and by brute force.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_mean_variance() {
+    const size_t COUNT = 1000;
+    const size_t DEST_STRIDE = 1;
+    std::vector<double> src;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < COUNT; ++i) {
+        // Large offset to stress the accuracy of the variance.
+        src.push_back(1e6 + rand() % 1000);
+    }
+    for (size_t win_length : {1, 2, 7, 32}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<double> median(dest_count);
+        std::vector<double> mean(dest_count);
+        std::vector<double> variance(dest_count);
+        std::vector<double> expected_median(dest_count);
+        result |= OrderedStructs::RollingMedian::median_mean_variance(
+            src.data(), 1, COUNT, win_length, median.data(), mean.data(), variance.data(), DEST_STRIDE
+        );
+        result |= OrderedStructs::RollingMedian::even_odd_index(
+            src.data(), 1, COUNT, win_length, expected_median.data(), DEST_STRIDE
+        );
+        for (size_t i = 0; i < dest_count; ++i) {
+            double sum = 0.0;
+            for (size_t j = i; j < i + win_length; ++j) {
+                sum += src[j];
+            }
+            double expected_mean = sum / win_length;
+            double sum_squares = 0.0;
+            for (size_t j = i; j < i + win_length; ++j) {
+                sum_squares += (src[j] - expected_mean) * (src[j] - expected_mean);
+            }
+            double expected_variance = sum_squares / win_length;
+            result |= median[i] != expected_median[i];
+            result |= std::abs(mean[i] - expected_mean) > 1e-9;
+            result |= std::abs(variance[i] - expected_variance) > 1e-3;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Test the rolling weighted median against a brute force weighted median of each window.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_weighted() {
+    const size_t COUNT = 500;
+    std::vector<double> src;
+    std::vector<double> weights;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < COUNT; ++i) {
+        src.push_back(rand() % 50);
+        weights.push_back(rand() % 10);
+    }
+    for (size_t win_length : {1, 2, 5, 16}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<double> dest(dest_count);
+        result |= OrderedStructs::RollingMedian::weighted_median(
+            src.data(), 1, weights.data(), 1, COUNT, win_length, dest.data(), 1
+        );
+        for (size_t i = 0; i < dest_count; ++i) {
+            std::vector<std::pair<double, double>> window;
+            double total = 0.0;
+            for (size_t j = i; j < i + win_length; ++j) {
+                window.push_back(std::make_pair(src[j], weights[j]));
+                total += weights[j];
+            }
+            std::sort(window.begin(), window.end());
+            double cumulative = 0.0;
+            size_t k = 0;
+            while (k < window.size() - 1 && cumulative + window[k].second < total / 2) {
+                cumulative += window[k].second;
+                ++k;
+            }
+            result |= dest[i] != window[k].first;
+        }
+    }
+    // Equal weights is the same as the lower median.
+    std::vector<double> unit_weights(COUNT, 1.0);
+    size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, 7);
+    std::vector<double> dest(dest_count);
+    std::vector<double> expected(dest_count);
+    result |= OrderedStructs::RollingMedian::weighted_median(
+        src.data(), 1, unit_weights.data(), 1, COUNT, 7, dest.data(), 1
+    );
+    result |= OrderedStructs::RollingMedian::odd_index(src.data(), 1, COUNT, 7, expected.data(), 1);
+    result |= dest != expected;
+    return result;
+}
+
+/**
+ * @brief Test the streaming WeightedRollingMedian against weighted_median() and the errors.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_weighted_streaming() {
+    const size_t COUNT = 500;
+    std::vector<double> src;
+    std::vector<double> weights;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < COUNT; ++i) {
+        src.push_back(rand() % 50);
+        weights.push_back((rand() % 100) / 10.0);
+    }
+    for (size_t win_length : {1, 2, 5, 16, 101}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<double> expected(dest_count);
+        result |= OrderedStructs::RollingMedian::weighted_median(
+            src.data(), 1, weights.data(), 1, COUNT, win_length, expected.data(), 1
+        );
+        OrderedStructs::RollingMedian::WeightedRollingMedian<double> rm(win_length);
+        for (size_t i = 0; i < COUNT; ++i) {
+            double median = rm.push(src[i], weights[i]);
+            if (i + 1 < win_length) {
+                // Filling, the same as the weighted median of all the values so far.
+                std::vector<double> filling(1);
+                result |= OrderedStructs::RollingMedian::weighted_median(
+                    src.data(), 1, weights.data(), 1, i + 1, i + 1, filling.data(), 1
+                );
+                result |= median != filling[0];
+                result |= rm.size() != i + 1;
+            } else {
+                result |= median != expected[i + 1 - win_length];
+                result |= rm.size() != win_length;
+            }
+            result |= median != rm.median();
+        }
+        double total = 0.0;
+        for (size_t i = COUNT - win_length; i < COUNT; ++i) {
+            total += weights[i];
+        }
+        result |= std::abs(rm.total_weight() - total) > 1e-9;
+    }
+    // Errors
+    std::vector<double> dest(COUNT);
+    std::vector<double> bad_weights(weights);
+    bad_weights[10] = -1.0;
+    result |= OrderedStructs::RollingMedian::weighted_median(
+        src.data(), 1, bad_weights.data(), 1, COUNT, 5, dest.data(), 1
+    ) != OrderedStructs::RollingMedian::ROLLING_MEDIAN_WEIGHT;
+    bad_weights[10] = std::nan("");
+    result |= OrderedStructs::RollingMedian::weighted_median(
+        src.data(), 1, bad_weights.data(), 1, COUNT, 5, dest.data(), 1
+    ) != OrderedStructs::RollingMedian::ROLLING_MEDIAN_WEIGHT;
+    try {
+        OrderedStructs::RollingMedian::WeightedRollingMedian<double> rm(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    OrderedStructs::RollingMedian::WeightedRollingMedian<double> rm(3);
+    try {
+        rm.median();
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    for (double weight : {-1.0, std::nan(""), HUGE_VAL}) {
+        try {
+            rm.push(1.0, weight);
+            result |= 1;
+        } catch (OrderedStructs::SkipList::ValueError &err) {}
+    }
+    try {
+        rm.push(std::nan(""), 1.0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    result |= rm.size() != 0;
+    return result;
+}
+
+/**
+ * @brief Test the multi-threaded rolling median of the columns of a row major 2D array against even_odd_index() on
+ * each column with different numbers of threads.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_columns() {
+    const size_t ROWS = 200;
+    const size_t COLUMNS = 37;
+    std::vector<double> src(ROWS * COLUMNS);
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = rand() % 100;
+    }
+    for (size_t win_length : {1, 4, 21}) {
+        size_t dest_rows = OrderedStructs::RollingMedian::dest_count(ROWS, win_length);
+        std::vector<double> expected(dest_rows * COLUMNS);
+        for (size_t c = 0; c < COLUMNS; ++c) {
+            result |= OrderedStructs::RollingMedian::even_odd_index(
+                src.data() + c, COLUMNS, ROWS, win_length, expected.data() + c, COLUMNS
+            );
+        }
+        for (size_t thread_count : {0, 1, 4, 64, 100000}) {
+            std::vector<double> dest(dest_rows * COLUMNS);
+            result |= OrderedStructs::RollingMedian::even_odd_index_columns(
+                src.data(), COLUMNS, 1, ROWS, COLUMNS, win_length, dest.data(), COLUMNS, 1, thread_count
+            );
+            result |= dest != expected;
+        }
+    }
+    // A NaN in one column is rethrown by the caller.
+    src[ROWS / 2 * COLUMNS + 5] = std::nan("");
+    std::vector<double> dest(ROWS * COLUMNS);
+    try {
+        OrderedStructs::RollingMedian::even_odd_index_columns(
+            src.data(), COLUMNS, 1, ROWS, COLUMNS, 5, dest.data(), COLUMNS, 1, 4
+        );
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * @brief Test the chunked parallel rolling median of a single series is identical to even_odd_index() for different
+ * window lengths, strides and numbers of threads including where the series is too short to split.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_parallel() {
+    const size_t COUNT = 1000;
+    std::vector<double> src;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < 2 * COUNT; ++i) {
+        src.push_back(rand() % 100);
+    }
+    for (size_t stride : {1, 2}) {
+        for (size_t win_length : {1, 2, 7, 100, 999, 1000}) {
+            size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+            std::vector<double> expected(dest_count * stride);
+            result |= OrderedStructs::RollingMedian::even_odd_index(
+                src.data(), stride, COUNT, win_length, expected.data(), stride
+            );
+            for (size_t thread_count : {0, 1, 3, 8, 1000}) {
+                std::vector<double> dest(dest_count * stride);
+                result |= OrderedStructs::RollingMedian::even_odd_index_parallel(
+                    src.data(), stride, COUNT, win_length, dest.data(), stride, thread_count
+                );
+                result |= dest != expected;
+            }
+        }
+    }
+    // Window longer than the series writes nothing.
+    result |= OrderedStructs::RollingMedian::even_odd_index_parallel(src.data(), 1, 5, 10, (double *) nullptr, 1, 4);
+    return result;
+}
+
+/**
+ * @brief Test that a SortedWindow gives identical rolling medians to a Skip List, with many duplicates, for both odd and
+ * even window lengths.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_sorted_window() {
+    const size_t COUNT = 1000;
+    std::vector<double> src;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < COUNT; ++i) {
+        src.push_back(rand() % 20);
+    }
+    for (size_t win_length : {1, 2, 3, 8, 33, 100, 1000}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<double> expected(dest_count);
+        std::vector<double> dest(dest_count);
+        OrderedStructs::SkipList::HeadNode<double> sl;
+        OrderedStructs::RollingMedian::SortedWindow<double> sw(win_length);
+        if (win_length % 2) {
+            result |= OrderedStructs::RollingMedian::_odd_index(sl, src.data(), 1, COUNT, win_length,
+                                                                 expected.data(), 1);
+            result |= OrderedStructs::RollingMedian::_odd_index(sw, src.data(), 1, COUNT, win_length, dest.data(), 1);
+        } else {
+            result |= OrderedStructs::RollingMedian::_even_index(sl, src.data(), 1, COUNT, win_length,
+                                                                  expected.data(), 1);
+            result |= OrderedStructs::RollingMedian::_even_index(sw, src.data(), 1, COUNT, win_length,
+                                                                  dest.data(), 1);
+        }
+        result |= dest != expected;
+        result |= sw.size() != win_length - 1;
+        // The public functions choose the engine.
+        result |= OrderedStructs::RollingMedian::even_odd_index(src.data(), 1, COUNT, win_length, dest.data(), 1);
+        result |= dest != expected;
+        std::vector<double> vector_expected;
+        std::vector<double> vector_result;
+        OrderedStructs::SkipList::HeadNode<double> sl_vector;
+        result |= OrderedStructs::RollingMedian::_rolling_median(sl_vector, src, win_length, vector_expected);
+        result |= OrderedStructs::RollingMedian::rolling_median(src, win_length, vector_result);
+        result |= vector_result != vector_expected;
+    }
+    // Errors are the same as a Skip List.
+    OrderedStructs::RollingMedian::SortedWindow<double> sw(4);
+    sw.insert(1.0);
+    try {
+        sw.remove(2.0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    try {
+        sw.insert(std::nan(""));
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    try {
+        sw.at(1);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    result |= sw.size() != 1;
+    return result;
+}
+
+/**
+ * @brief Test that a HistogramWindow gives the same results as a Skip List for unsigned, signed and wide integer
+ * types and that the public functions choose it for a small range of values.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_histogram_window() {
+    const size_t COUNT = 2000;
+    int result = 0;
+
+    srand(1);
+    // uint16_t with a range that needs several blocks and some sparse regions.
+    std::vector<uint16_t> src_u16;
+    for (size_t i = 0; i < COUNT; ++i) {
+        src_u16.push_back(rand() % 4 ? rand() % 1000 : 60000 + rand() % 5000);
+    }
+    // Negative values and a range that is not a multiple of the block size.
+    std::vector<int64_t> src_i64;
+    for (size_t i = 0; i < COUNT; ++i) {
+        src_i64.push_back(static_cast<int64_t>(rand() % 777) - 1000000000000LL);
+    }
+    for (size_t win_length : {1, 2, 3, 8, 9, 33, 100, 1000, 2000}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        {
+            std::vector<uint16_t> expected(dest_count);
+            std::vector<uint16_t> dest(dest_count);
+            OrderedStructs::SkipList::HeadNode<uint16_t> sl;
+            OrderedStructs::RollingMedian::HistogramWindow<uint16_t> hw(0, 65535);
+            if (win_length % 2) {
+                result |= OrderedStructs::RollingMedian::_odd_index(sl, src_u16.data(), 1, COUNT, win_length,
+                                                                     expected.data(), 1);
+                result |= OrderedStructs::RollingMedian::_odd_index(hw, src_u16.data(), 1, COUNT, win_length,
+                                                                     dest.data(), 1);
+            } else {
+                result |= OrderedStructs::RollingMedian::_even_index(sl, src_u16.data(), 1, COUNT, win_length,
+                                                                      expected.data(), 1);
+                result |= OrderedStructs::RollingMedian::_even_index(hw, src_u16.data(), 1, COUNT, win_length,
+                                                                      dest.data(), 1);
+            }
+            result |= dest != expected;
+            result |= hw.size() != win_length - 1;
+            result |= OrderedStructs::RollingMedian::even_odd_index(src_u16.data(), 1, COUNT, win_length,
+                                                                    dest.data(), 1);
+            result |= dest != expected;
+        }
+        {
+            std::vector<int64_t> expected(dest_count);
+            std::vector<int64_t> dest(dest_count);
+            OrderedStructs::SkipList::HeadNode<int64_t> sl;
+            result |= OrderedStructs::RollingMedian::even_odd_index(src_i64.data(), 1, COUNT, win_length,
+                                                                    dest.data(), 1);
+            if (win_length % 2) {
+                result |= OrderedStructs::RollingMedian::_odd_index(sl, src_i64.data(), 1, COUNT, win_length,
+                                                                     expected.data(), 1);
+            } else {
+                result |= OrderedStructs::RollingMedian::_even_index(sl, src_i64.data(), 1, COUNT, win_length,
+                                                                      expected.data(), 1);
+            }
+            result |= dest != expected;
+            std::vector<int64_t> vector_expected;
+            std::vector<int64_t> vector_result;
+            OrderedStructs::SkipList::HeadNode<int64_t> sl_vector;
+            result |= OrderedStructs::RollingMedian::_rolling_median(sl_vector, src_i64, win_length,
+                                                                      vector_expected);
+            result |= OrderedStructs::RollingMedian::rolling_median(src_i64, win_length, vector_result);
+            result |= vector_result != vector_expected;
+        }
+    }
+    // Engine selection.
+    int64_t min_value, max_value;
+    result |= ! OrderedStructs::RollingMedian::use_histogram_window(src_i64.data(), 1, COUNT, 9,
+                                                                     min_value, max_value);
+    result |= min_value != *std::min_element(src_i64.begin(), src_i64.end());
+    result |= max_value != *std::max_element(src_i64.begin(), src_i64.end());
+    // Too short a window.
+    result |= OrderedStructs::RollingMedian::use_histogram_window(src_i64.data(), 1, COUNT, 8,
+                                                                   min_value, max_value);
+    // Too sparse for the window.
+    uint16_t min_u16, max_u16;
+    result |= OrderedStructs::RollingMedian::use_histogram_window(src_u16.data(), 1, COUNT, 9, min_u16, max_u16);
+    const std::vector<int64_t> wide = {0, 1LL << 40};
+    result |= OrderedStructs::RollingMedian::use_histogram_window(wide.data(), 1, wide.size(), 9999,
+                                                                   min_value, max_value);
+    const std::vector<double> doubles = {0.0, 1.0};
+    double min_double, max_double;
+    result |= OrderedStructs::RollingMedian::use_histogram_window(doubles.data(), 1, doubles.size(), 9,
+                                                                   min_double, max_double);
+    // Errors are the same as a Skip List.
+    OrderedStructs::RollingMedian::HistogramWindow<int> hw(-4, 4);
+    hw.insert(1);
+    try {
+        hw.remove(2);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    try {
+        hw.insert(5);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    try {
+        hw.at(1);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        OrderedStructs::RollingMedian::HistogramWindow<int> too_wide(0, 1 << 16);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    result |= hw.size() != 1;
+    result |= hw.at(0) != 1;
+    return result;
+}
+
+/**
+ * @brief Brute force 2D median filter that sorts every block.
+ */
+template<typename T>
+static std::vector<T> _median_filter_2d_brute_force(const std::vector<T> &src, size_t rows, size_t columns,
+                                                    size_t kernel) {
+    std::vector<T> dest;
+    for (size_t r = 0; r + kernel <= rows; ++r) {
+        for (size_t c = 0; c + kernel <= columns; ++c) {
+            std::vector<T> block;
+            for (size_t i = 0; i < kernel; ++i) {
+                for (size_t j = 0; j < kernel; ++j) {
+                    block.push_back(src[(r + i) * columns + c + j]);
+                }
+            }
+            std::sort(block.begin(), block.end());
+            if (block.size() % 2) {
+                dest.push_back(block[block.size() / 2]);
+            } else {
+                dest.push_back(block[block.size() / 2 - 1] / 2 + block[block.size() / 2] / 2);
+            }
+        }
+    }
+    return dest;
+}
+
+/**
+ * @brief Test the 2D median filter against a brute force filter with each engine, with even and odd kernels,
+ * a transposed source and several threads.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+template<typename T>
+static int _test_median_filter_2d(size_t rows, size_t columns, size_t value_range, size_t kernel) {
+    int result = 0;
+    std::vector<T> src;
+    for (size_t i = 0; i < rows * columns; ++i) {
+        src.push_back(static_cast<T>(rand() % value_range));
+    }
+    std::vector<T> expected = _median_filter_2d_brute_force(src, rows, columns, kernel);
+    const size_t dest_rows = rows - kernel + 1;
+    const size_t dest_columns = columns - kernel + 1;
+    for (size_t thread_count : {1, 3}) {
+        std::vector<T> dest(dest_rows * dest_columns);
+        result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), columns, 1, rows, columns, kernel,
+                                                                  dest.data(), dest_columns, 1, thread_count);
+        result |= dest != expected;
+        // Transpose both the source and the destination with the strides.
+        std::vector<T> dest_transposed(dest_rows * dest_columns);
+        result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), 1, columns, columns, rows, kernel,
+                                                                  dest_transposed.data(), 1, dest_columns,
+                                                                  thread_count);
+        result |= dest_transposed != expected;
+    }
+    return result;
+}
+
+int test_median_filter_2d() {
+    int result = 0;
+
+    srand(1);
+    // HistogramWindow
+    result |= _test_median_filter_2d<uint8_t>(40, 50, 256, 3);
+    result |= _test_median_filter_2d<uint16_t>(40, 50, 4096, 5);
+    // SortedWindow
+    result |= _test_median_filter_2d<double>(40, 50, 1000, 1);
+    result |= _test_median_filter_2d<double>(40, 50, 1000, 4);
+    result |= _test_median_filter_2d<int>(40, 50, 1 << 30, 7);
+    // Skip List
+    result |= _test_median_filter_2d<double>(80, 90, 1000, 65);
+    result |= _test_median_filter_2d<double>(70, 80, 1000, 66);
+    // Kernel is the full size.
+    result |= _test_median_filter_2d<double>(6, 6, 10, 6);
+
+    // Errors
+    std::vector<double> src(100, 1.0);
+    std::vector<double> dest(100, -1.0);
+    result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), 0, 1, 10, 10, 3, dest.data(), 8, 1)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SOURCE_STRIDE;
+    result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), 10, 1, 10, 10, 3, dest.data(), 8, 0)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_DESTINATION_STRIDE;
+    result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), 10, 1, 10, 10, 0, dest.data(), 8, 1)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_WIN_LENGTH;
+    // Too few columns so nothing is written.
+    result |= OrderedStructs::RollingMedian::median_filter_2d(src.data(), 10, 1, 10, 2, 3, dest.data(), 8, 1);
+    result |= dest != std::vector<double>(100, -1.0);
+    src[55] = std::nan("");
+    try {
+        OrderedStructs::RollingMedian::median_filter_2d(src.data(), 10, 1, 10, 10, 3, dest.data(), 8, 1, 2);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * @brief Test the time window rolling median, and the streaming form, against a brute force median of each window
+ * with bursts of samples with the same timestamp and gaps longer than the window.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_time_window() {
+    const size_t COUNT = 2000;
+    int result = 0;
+
+    srand(1);
+    std::vector<int64_t> timestamps;
+    std::vector<double> src;
+    int64_t now = 1000;
+    for (size_t i = 0; i < COUNT; ++i) {
+        switch (rand() % 8) {
+            case 0:
+                // Burst at the same time.
+                break;
+            case 1:
+                // Gap
+                now += 500;
+                break;
+            default:
+                now += rand() % 10;
+                break;
+        }
+        timestamps.push_back(now);
+        src.push_back(rand() % 100);
+    }
+    for (int64_t duration : {1, 7, 50, 499, 100000}) {
+        std::vector<double> dest(COUNT);
+        result |= OrderedStructs::RollingMedian::time_window_median(timestamps.data(), 1, src.data(), 1, COUNT,
+                                                                    duration, dest.data(), 1);
+        OrderedStructs::RollingMedian::TimeWindowRollingMedian<double, int64_t> rm(duration);
+        for (size_t i = 0; i < COUNT; ++i) {
+            std::vector<double> window;
+            for (size_t j = 0; j <= i; ++j) {
+                if (timestamps[j] > timestamps[i] - duration) {
+                    window.push_back(src[j]);
+                }
+            }
+            std::sort(window.begin(), window.end());
+            double expected = window[window.size() / 2];
+            if (window.size() % 2 == 0) {
+                expected = window[window.size() / 2 - 1] / 2 + window[window.size() / 2] / 2;
+            }
+            result |= dest[i] != expected;
+            result |= rm.push(timestamps[i], src[i]) != expected;
+            result |= rm.size() != window.size();
+        }
+        // The same with double timestamps and a stride.
+        std::vector<double> timestamps_strided;
+        for (int64_t timestamp: timestamps) {
+            timestamps_strided.push_back(timestamp / 8.0);
+            timestamps_strided.push_back(-1.0);
+        }
+        std::vector<double> dest_strided(COUNT * 3);
+        result |= OrderedStructs::RollingMedian::time_window_median(timestamps_strided.data(), 2, src.data(), 1,
+                                                                    COUNT, duration / 8.0, dest_strided.data(), 3);
+        for (size_t i = 0; i < COUNT; ++i) {
+            result |= dest_strided[i * 3] != dest[i];
+        }
+    }
+    // Errors
+    std::vector<double> dest(COUNT);
+    std::vector<int64_t> timestamps_reversed(timestamps.rbegin(), timestamps.rend());
+    result |= OrderedStructs::RollingMedian::time_window_median(timestamps_reversed.data(), 1, src.data(), 1, COUNT,
+                                                                int64_t(10), dest.data(), 1)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_TIMESTAMP;
+    {
+        std::vector<double> timestamps_nan(COUNT, 1.0);
+        timestamps_nan[COUNT / 2] = std::nan("");
+        result |= OrderedStructs::RollingMedian::time_window_median(timestamps_nan.data(), 1, src.data(), 1, COUNT,
+                                                                    1.0, dest.data(), 1)
+                  != OrderedStructs::RollingMedian::ROLLING_MEDIAN_TIMESTAMP;
+    }
+    result |= OrderedStructs::RollingMedian::time_window_median(timestamps.data(), 1, src.data(), 1, COUNT,
+                                                                int64_t(0), dest.data(), 1)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_WIN_LENGTH;
+    result |= OrderedStructs::RollingMedian::time_window_median(timestamps.data(), 0, src.data(), 1, COUNT,
+                                                                int64_t(10), dest.data(), 1)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SOURCE_STRIDE;
+    try {
+        OrderedStructs::RollingMedian::TimeWindowRollingMedian<double> rm(0.0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    OrderedStructs::RollingMedian::TimeWindowRollingMedian<double, uint64_t> rm(10);
+    try {
+        rm.median();
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    result |= rm.push(100, 1.0) != 1.0;
+    result |= rm.push(105, 2.0) != 1.5;
+    try {
+        rm.push(104, 3.0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    try {
+        rm.push(106, std::nan(""));
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    result |= rm.size() != 2;
+    // The first value leaves the window.
+    result |= rm.push(110, 9.0) != 5.5;
+    // A gap
+    result |= rm.evict(1000) != 2;
+    result |= rm.size() != 0;
+    result |= rm.duration() != 10;
+    // A NaN timestamp would otherwise evict everything.
+    OrderedStructs::RollingMedian::TimeWindowRollingMedian<double> rm_double(10.0);
+    rm_double.push(100.0, 1.0);
+    try {
+        rm_double.push(std::nan(""), 2.0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    try {
+        rm_double.evict(std::nan(""));
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    result |= rm_double.size() != 1;
+    return result;
+}
+
+/**
+ * @brief Brute force median of a vector in the same way as even_odd_index().
+ */
+template<typename T>
+static T _median_brute_force(std::vector<T> values) {
+    std::sort(values.begin(), values.end());
+    if (values.size() % 2) {
+        return values[values.size() / 2];
+    }
+    return values[values.size() / 2 - 1] / 2 + values[values.size() / 2] / 2;
+}
+
+/**
+ * @brief Brute force median absolute deviation.
+ */
+template<typename T>
+static T _mad_brute_force(const std::vector<T> &values, T median) {
+    std::vector<T> deviations;
+    for (const T &value: values) {
+        deviations.push_back(value < median ? median - value : value - median);
+    }
+    return _median_brute_force(deviations);
+}
+
+/**
+ * @brief Test the rolling median absolute deviation with both engines and an unsigned type against a brute force
+ * computation of each window.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+template<typename T>
+static int _test_roll_med_mad(size_t value_range) {
+    const size_t COUNT = 1000;
+    int result = 0;
+    std::vector<T> src;
+    for (size_t i = 0; i < COUNT; ++i) {
+        src.push_back(static_cast<T>(rand() % value_range));
+    }
+    for (size_t win_length : {1, 2, 3, 4, 5, 10, 33, 100, 1000}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<T> median(dest_count);
+        std::vector<T> mad(dest_count);
+        result |= OrderedStructs::RollingMedian::rolling_median_mad(src.data(), 1, COUNT, win_length,
+                                                                    median.data(), mad.data(), 1);
+        std::vector<T> sl_median(dest_count);
+        std::vector<T> sl_mad(dest_count);
+        OrderedStructs::SkipList::HeadNode<T> sl;
+        result |= OrderedStructs::RollingMedian::_rolling_median_mad(sl, src.data(), 1, COUNT, win_length,
+                                                                     sl_median.data(), sl_mad.data(), 1);
+        for (size_t i = 0; i < dest_count; ++i) {
+            std::vector<T> window(src.begin() + i, src.begin() + i + win_length);
+            T expected_median = _median_brute_force(window);
+            T expected_mad = _mad_brute_force(window, expected_median);
+            result |= median[i] != expected_median;
+            result |= mad[i] != expected_mad;
+            result |= sl_median[i] != expected_median;
+            result |= sl_mad[i] != expected_mad;
+        }
+    }
+    return result;
+}
+
+int test_roll_med_mad() {
+    int result = 0;
+
+    srand(1);
+    result |= _test_roll_med_mad<double>(1000);
+    // Many duplicates.
+    result |= _test_roll_med_mad<double>(3);
+    result |= _test_roll_med_mad<uint16_t>(500);
+    return result;
+}
+
+/**
+ * @brief Test the Hampel filter against a brute force filter including in place filtering and the ends of the data.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_hampel_filter() {
+    const size_t COUNT = 1000;
+    const double N_SIGMAS = 3.0;
+    int result = 0;
+
+    srand(1);
+    std::vector<double> src;
+    for (size_t i = 0; i < COUNT; ++i) {
+        double value = std::sin(i / 10.0) + (rand() % 100) / 1000.0;
+        if (rand() % 50 == 0) {
+            value += rand() % 2 ? 5.0 : -5.0;
+        }
+        src.push_back(value);
+    }
+    for (size_t half_width : {0, 1, 3, 10, 100, 499, 500, 2000}) {
+        std::vector<double> expected(src);
+        std::vector<size_t> expected_outliers;
+        for (size_t i = half_width; i + half_width < COUNT; ++i) {
+            std::vector<double> window(src.begin() + i - half_width, src.begin() + i + half_width + 1);
+            double median = _median_brute_force(window);
+            double mad = _mad_brute_force(window, median);
+            if (std::abs(src[i] - median) > N_SIGMAS * 1.4826 * mad) {
+                expected[i] = median;
+                expected_outliers.push_back(i);
+            }
+        }
+        std::vector<double> dest(COUNT);
+        std::vector<size_t> outliers;
+        result |= OrderedStructs::RollingMedian::hampel_filter(src.data(), 1, COUNT, half_width, N_SIGMAS,
+                                                               dest.data(), 1, outliers);
+        result |= dest != expected;
+        result |= outliers != expected_outliers;
+        if (half_width == 3) {
+            // There are outliers to find.
+            result |= outliers.size() < 10;
+        }
+        // In place
+        std::vector<double> in_place(src);
+        result |= OrderedStructs::RollingMedian::hampel_filter(in_place.data(), 1, COUNT, half_width, N_SIGMAS,
+                                                               in_place.data(), 1, outliers);
+        result |= in_place != expected;
+        result |= outliers != expected_outliers;
+    }
+    // Errors
+    std::vector<double> dest(COUNT);
+    std::vector<size_t> outliers;
+    result |= OrderedStructs::RollingMedian::hampel_filter(src.data(), 1, COUNT, 3, -1.0, dest.data(), 1, outliers)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_THRESHOLD;
+    result |= OrderedStructs::RollingMedian::hampel_filter(src.data(), 1, COUNT, 3, std::nan(""), dest.data(), 1,
+                                                           outliers)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_THRESHOLD;
+    result |= OrderedStructs::RollingMedian::hampel_filter(src.data(), 0, COUNT, 3, 3.0, dest.data(), 1, outliers)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SOURCE_STRIDE;
+    return result;
+}
+
+/**
+ * @brief The distance of the rank of a value in a window from a target rank, zero if the value spans the target.
+ */
+template<typename T>
+static double _rank_distance(std::vector<T> window, const T &value, double target) {
+    std::sort(window.begin(), window.end());
+    double lower = std::lower_bound(window.begin(), window.end(), value) - window.begin();
+    double upper = std::upper_bound(window.begin(), window.end(), value) - window.begin();
+    if (target < lower) {
+        return lower - target;
+    }
+    if (target > upper) {
+        return target - upper;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Test the approximate rolling quantile of a type is within the rank error of the exact window.
+ */
+template<typename T>
+static int _test_roll_med_approximate(const std::vector<T> &src, size_t win_length, double epsilon,
+                                      double quantile) {
+    int result = 0;
+    std::vector<T> dest(src.size() - win_length + 1);
+    result |= OrderedStructs::RollingMedian::approximate_rolling_quantile(src.data(), 1, src.size(), win_length,
+                                                                         dest.data(), 1, epsilon, quantile);
+    // Check twenty or so of the windows.
+    size_t step = std::max<size_t>(1, dest.size() / 19);
+    for (size_t i = 0; i < dest.size(); i += step) {
+        std::vector<T> window(src.begin() + i, src.begin() + i + win_length);
+        result |= _rank_distance(window, dest[i], quantile * (win_length - 1)) > epsilon * win_length;
+    }
+    return result;
+}
+
+/**
+ * @brief Test the approximate rolling median and quantiles against the exact window.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_approximate() {
+    const size_t COUNT = 200000;
+    int result = 0;
+
+    srand(1);
+    std::vector<double> random(COUNT);
+    std::vector<double> increasing(COUNT);
+    std::vector<uint16_t> few_values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        random[i] = rand();
+        increasing[i] = i;
+        few_values[i] = rand() % 5;
+    }
+    for (auto &win_epsilon : std::vector<std::pair<size_t, double>>{
+            {1, 0.1}, {10, 0.1}, {1000, 0.05}, {20000, 0.05}, {50000, 0.02}, {100000, 0.05}}) {
+        for (double quantile : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+            result |= _test_roll_med_approximate(random, win_epsilon.first, win_epsilon.second, quantile);
+            result |= _test_roll_med_approximate(increasing, win_epsilon.first, win_epsilon.second, quantile);
+            result |= _test_roll_med_approximate(few_values, win_epsilon.first, win_epsilon.second, quantile);
+        }
+    }
+    // The median has the same arguments as even_odd_index().
+    std::vector<double> dest(COUNT);
+    std::vector<double> expected(COUNT);
+    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(random.data(), 1, COUNT, 1000,
+                                                                       dest.data(), 1, 0.05);
+    result |= OrderedStructs::RollingMedian::approximate_rolling_quantile(random.data(), 1, COUNT, 1000,
+                                                                         expected.data(), 1, 0.05, 0.5);
+    result |= dest != expected;
+    // Short windows are exact.
+    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(random.data(), 1, COUNT, 1001,
+                                                                       dest.data(), 1, 0.05);
+    result |= OrderedStructs::RollingMedian::odd_index(random.data(), 1, COUNT, 1001, expected.data(), 1);
+    result |= dest != expected;
+    // The memory does not depend on the window length.
+    for (size_t win_length : {100000, 1000000}) {
+        OrderedStructs::RollingMedian::WindowedQuantileSketch<double> sketch(win_length, 0.05);
+        for (size_t i = 0; i < 2 * win_length; ++i) {
+            sketch.push(random[i % COUNT]);
+        }
+        result |= sketch.size() != win_length;
+        result |= sketch.summary_size() > 32 / (0.05 * 0.05);
+    }
+    // Errors
+    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(random.data(), 1, COUNT, 1000,
+                                                                       dest.data(), 1, 0.0)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_EPSILON;
+    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(random.data(), 1, COUNT, 1000,
+                                                                       dest.data(), 1, 1.0)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_EPSILON;
+    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(random.data(), 1, COUNT, 1000,
+                                                                       dest.data(), 1, std::nan(""))
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_EPSILON;
+    result |= OrderedStructs::RollingMedian::approximate_rolling_quantile(random.data(), 1, COUNT, 1000,
+                                                                         dest.data(), 1, 0.05, 1.5)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_QUANTILE;
+    result |= OrderedStructs::RollingMedian::approximate_even_odd_index(random.data(), 0, COUNT, 1000,
+                                                                       dest.data(), 1, 0.05)
+              != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SOURCE_STRIDE;
+    try {
+        OrderedStructs::RollingMedian::WindowedQuantileSketch<double> sketch(0, 0.05);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    OrderedStructs::RollingMedian::WindowedQuantileSketch<double> sketch(1000, 0.05);
+    try {
+        sketch.quantile(0.5);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::IndexError &err) {}
+    try {
+        sketch.push(std::nan(""));
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    return result;
+}
+
+/**
+ * @brief Brute force quantile of a sorted window in the same way as numpy.quantile().
+ */
+static double _quantile_of_sorted(const std::vector<double> &sorted, double quantile,
+                                  OrderedStructs::RollingMedian::QuantileInterpolation interpolation) {
+    double position = quantile * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(position));
+    size_t higher = static_cast<size_t>(std::ceil(position));
+    double fraction = position - lower;
+    switch (interpolation) {
+        case OrderedStructs::RollingMedian::QUANTILE_LINEAR:
+            return sorted[lower] + (sorted[higher] - sorted[lower]) * fraction;
+        case OrderedStructs::RollingMedian::QUANTILE_LOWER:
+            return sorted[lower];
+        case OrderedStructs::RollingMedian::QUANTILE_HIGHER:
+            return sorted[higher];
+        case OrderedStructs::RollingMedian::QUANTILE_NEAREST:
+            return sorted[static_cast<size_t>(std::nearbyint(position))];
+        case OrderedStructs::RollingMedian::QUANTILE_MIDPOINT:
+            return sorted[lower] / 2 + sorted[higher] / 2;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Test rolling quantiles with every interpolation against a brute force quantile of each window.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_quantile() {
+    const size_t COUNT = 500;
+    const std::vector<double> quantiles = {0.0, 0.1, 0.25, 0.5, 0.9, 0.99, 1.0};
+    std::vector<double> src;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < COUNT; ++i) {
+        src.push_back(rand() % 50);
+    }
+    for (auto interpolation: {OrderedStructs::RollingMedian::QUANTILE_LINEAR,
+                              OrderedStructs::RollingMedian::QUANTILE_LOWER,
+                              OrderedStructs::RollingMedian::QUANTILE_HIGHER,
+                              OrderedStructs::RollingMedian::QUANTILE_NEAREST,
+                              OrderedStructs::RollingMedian::QUANTILE_MIDPOINT}) {
+        for (size_t win_length : {1, 2, 5, 16, 101}) {
+            size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+            std::vector<double> dest(dest_count * quantiles.size());
+            result |= OrderedStructs::RollingMedian::rolling_quantile(
+                src.data(), 1, COUNT, win_length, quantiles.data(), quantiles.size(),
+                dest.data(), quantiles.size(), interpolation
+            );
+            for (size_t i = 0; i < dest_count; ++i) {
+                std::vector<double> window(src.begin() + i, src.begin() + i + win_length);
+                std::sort(window.begin(), window.end());
+                for (size_t q = 0; q < quantiles.size(); ++q) {
+                    double expected = _quantile_of_sorted(window, quantiles[q], interpolation);
+                    result |= std::abs(dest[i * quantiles.size() + q] - expected) > 1e-9;
+                }
+            }
+        }
+    }
+    // The median with midpoint is the same as even_odd_index()
+    const double median = 0.5;
+    for (size_t win_length : {7, 8}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<double> dest(dest_count);
+        std::vector<double> expected(dest_count);
+        result |= OrderedStructs::RollingMedian::rolling_quantile(
+            src.data(), 1, COUNT, win_length, &median, 1, dest.data(), 1,
+            OrderedStructs::RollingMedian::QUANTILE_MIDPOINT
+        );
+        result |= OrderedStructs::RollingMedian::even_odd_index(
+            src.data(), 1, COUNT, win_length, expected.data(), 1
+        );
+        result |= dest != expected;
+    }
+    return result;
+}
+
+/**
+ * @brief Test rolling quantiles fail with a destination stride that is too small or a quantile out of range.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_quantile_fails() {
+    const double src[] = {1.0, 2.0, 3.0, 4.0};
+    double dest[8];
+    int result = 0;
+
+    const double quantiles[] = {0.5, 0.9};
+    result |= OrderedStructs::RollingMedian::rolling_quantile(
+        src, 1, 4, 3, quantiles, 2, dest, 1
+    ) != OrderedStructs::RollingMedian::ROLLING_MEDIAN_DESTINATION_STRIDE;
+    for (double quantile : {-0.1, 1.1, std::nan("")}) {
+        result |= OrderedStructs::RollingMedian::rolling_quantile(
+            src, 1, 4, 3, &quantile, 1, dest, 1
+        ) != OrderedStructs::RollingMedian::ROLLING_MEDIAN_QUANTILE;
+    }
+    return result;
+}
+
+/**
+ * @brief Test the streaming RollingMedian against even_odd_index() once the window is full and against a sort of the
+ * partial window while it is filling.
+ *
+ * @return Zero on success, non-zero on failure.
+ */
+int test_roll_med_streaming() {
+    const size_t COUNT = 500;
+    std::vector<double> src;
+    int result = 0;
+
+    srand(1);
+    for (size_t i = 0; i < COUNT; ++i) {
+        src.push_back(rand() % 50);
+    }
+    for (size_t win_length : {1, 2, 5, 16}) {
+        size_t dest_count = OrderedStructs::RollingMedian::dest_count(COUNT, win_length);
+        std::vector<double> expected(dest_count);
+        result |= OrderedStructs::RollingMedian::even_odd_index(
+            src.data(), 1, COUNT, win_length, expected.data(), 1
+        );
+        OrderedStructs::RollingMedian::RollingMedian<double> rm(win_length);
+        for (size_t i = 0; i < COUNT; ++i) {
+            double median = rm.push(src[i]);
+            result |= median != rm.median();
+            if (i + 1 >= win_length) {
+                result |= rm.size() != win_length;
+                result |= median != expected[i + 1 - win_length];
+            } else {
+                std::vector<double> window(src.begin(), src.begin() + i + 1);
+                std::sort(window.begin(), window.end());
+                double partial = window.size() % 2 ? window[i / 2] : window[i / 2] / 2 + window[i / 2 + 1] / 2;
+                result |= rm.size() != i + 1;
+                result |= median != partial;
+            }
+        }
+    }
+    // Zero length window
+    try {
+        OrderedStructs::RollingMedian::RollingMedian<double> rm(0);
+        result |= 1;
+    } catch (OrderedStructs::SkipList::ValueError &err) {}
+    // NaN leaves the window unchanged
+    OrderedStructs::RollingMedian::RollingMedian<double> rm(3);
+    rm.push(1.0);
+    rm.push(2.0);
+    try {
+        rm.push(std::nan(""));
+        result |= 1;
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {}
+    result |= rm.size() != 2;
+    result |= rm.median() != 1.5;
+    return result;
+}
+
 /**
  * @brief Test a simple rolling median into a dynamic array of doubles given by
  * \c OrderedStructs::RollingMedian::dest_size. Odd length window.
@@ -164,6 +1221,21 @@ int test_rolling_median_all() {
     result |= print_result("test_roll_med_simple", test_roll_med_simple());
     result |= print_result("test_roll_med_even_win", test_roll_med_even_win());
     result |= print_result("test_roll_med_even_mean", test_roll_med_even_mean());
+    result |= print_result("test_roll_med_mean_variance", test_roll_med_mean_variance());
+    result |= print_result("test_roll_med_weighted", test_roll_med_weighted());
+    result |= print_result("test_roll_med_weighted_streaming", test_roll_med_weighted_streaming());
+    result |= print_result("test_roll_med_streaming", test_roll_med_streaming());
+    result |= print_result("test_roll_med_columns", test_roll_med_columns());
+    result |= print_result("test_roll_med_parallel", test_roll_med_parallel());
+    result |= print_result("test_roll_med_sorted_window", test_roll_med_sorted_window());
+    result |= print_result("test_roll_med_histogram_window", test_roll_med_histogram_window());
+    result |= print_result("test_median_filter_2d", test_median_filter_2d());
+    result |= print_result("test_roll_med_time_window", test_roll_med_time_window());
+    result |= print_result("test_roll_med_mad", test_roll_med_mad());
+    result |= print_result("test_hampel_filter", test_hampel_filter());
+    result |= print_result("test_roll_med_approximate", test_roll_med_approximate());
+    result |= print_result("test_roll_quantile", test_roll_quantile());
+    result |= print_result("test_roll_quantile_fails", test_roll_quantile_fails());
     // Performance tests are very slow if DEBUG as checking
     // integrity is very expensive for large data sets.
 #ifndef DEBUG
@@ -13,6 +13,7 @@
 #include "SkipList.h"
 #include "cOrderedStructs.h"
 #include "cSkipList.h"
+#include "cRollingMedian.h"
 
 static char toss_coin_docs[] = \
 "Toss a coin and return True/False."
@@ -77,6 +78,14 @@ long_max_value(PyObject */* mod */) {
 static PyMethodDef orderedstructsmodule_methods[] = {
         {"toss_coin", (PyCFunction) toss_coin,      METH_NOARGS, toss_coin_docs},
         {"seed_rand", (PyCFunction) seed_rand,      METH_O,      seed_rand_docs},
+        {"rolling_median_columns", (PyCFunction) rolling_median_columns, METH_VARARGS | METH_KEYWORDS,
+                                                                 rolling_median_columns_docs},
+        {"median_filter_2d", (PyCFunction) median_filter_2d, METH_VARARGS | METH_KEYWORDS,
+                                                                 median_filter_2d_docs},
+        {"hampel_filter", (PyCFunction) hampel_filter, METH_VARARGS | METH_KEYWORDS,
+                                                                 hampel_filter_docs},
+        {"weighted_rolling_median", (PyCFunction) weighted_rolling_median, METH_VARARGS | METH_KEYWORDS,
+                                                                 weighted_rolling_median_docs},
         {"min_long",  (PyCFunction) long_min_value, METH_NOARGS,
                                                                  "Minimum value I can handle for an integer."},
         {"max_long",  (PyCFunction) long_max_value, METH_NOARGS,
@@ -87,6 +96,13 @@ static PyMethodDef orderedstructsmodule_methods[] = {
 static char c_skip_list_docs[] =
         "orderedstructs is an interface between Python and a C++ skip list implementation. It contains:"
         "\nSkipList - An implementation of a skip list for float/long/bytes or objects."
+        "\nRollingMedian - A streaming rolling median of floats."
+        "\nTimeWindowRollingMedian - A streaming rolling median of floats over a time window."
+        "\nWeightedRollingMedian - A streaming rolling weighted median of floats."
+        "\nrolling_median_columns(src, dest, window_length) - Multi-threaded rolling median of the columns of a 2D array."
+        "\nmedian_filter_2d(src, dest, kernel_size) - Multi-threaded 2D median filter of a 2D array."
+        "\nhampel_filter(src, dest, half_width) - Hampel outlier filter of a 1D array."
+        "\nweighted_rolling_median(src, weights, dest, window_length) - Rolling weighted median of a 1D array."
         "\nseed_rand(int) - Seed the random number generator."
         "\ntoss_coin() - Toss a coin using the random number generator and return True/False.";
 
@@ -178,6 +194,27 @@ initorderedstructs(void)
     if (PyModule_AddObject(module, "SkipList", (PyObject *) &SkipListType)) {
         goto except;
     }
+    if (PyType_Ready(&RollingMedianType) < 0) {
+        goto except;
+    }
+    Py_INCREF(&RollingMedianType);
+    if (PyModule_AddObject(module, "RollingMedian", (PyObject *) &RollingMedianType)) {
+        goto except;
+    }
+    if (PyType_Ready(&TimeWindowRollingMedianType) < 0) {
+        goto except;
+    }
+    Py_INCREF(&TimeWindowRollingMedianType);
+    if (PyModule_AddObject(module, "TimeWindowRollingMedian", (PyObject *) &TimeWindowRollingMedianType)) {
+        goto except;
+    }
+    if (PyType_Ready(&WeightedRollingMedianType) < 0) {
+        goto except;
+    }
+    Py_INCREF(&WeightedRollingMedianType);
+    if (PyModule_AddObject(module, "WeightedRollingMedian", (PyObject *) &WeightedRollingMedianType)) {
+        goto except;
+    }
     // Set read only class attribute with threading support.
     class_dict = SkipListType.tp_dict;
 #ifdef WITH_THREAD
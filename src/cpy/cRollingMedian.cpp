@@ -0,0 +1,1331 @@
+/**
+ * @file
+ *
+ * Project: skiplist
+ *
+ * CPython wrapper around the streaming OrderedStructs::RollingMedian::RollingMedian, TimeWindowRollingMedian and
+ * WeightedRollingMedian for floats, the multi-threaded rolling median of the columns of a 2D array, the 2D median
+ * filter, the Hampel filter and the rolling weighted median.
+ *
+ * @code
+ * MIT License
+ *
+ * Copyright (c) 2026 Paul Ross
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * @endcode
+ *
+ * Note about Python thread safety
+ * ===============================
+ *
+ * The values are C++ doubles and no Python code is called whilst the rolling median is being updated so the GIL is
+ * held throughout each method. This protects the ring buffer as well as the Skip List.
+ *
+ * rolling_median_columns(), median_filter_2d(), hampel_filter() and weighted_rolling_median() work on buffers of C
+ * types so they release the GIL whilst the medians are computed.
+ */
+
+#include <Python.h>
+#include "structmember.h"
+
+#include "RollingMedian.h"
+
+#include "OrderedStructs.h"
+#include "cOrderedStructs.h"
+#include "cRollingMedian.h"
+
+/**
+ * Set a SystemError if an object was created by __new__() but not initialised by __init__().
+ *
+ * @param pointer The wrapped C++ object, this is NULL until initialised.
+ * @return 0 if initialised, -1 with a SystemError set if not.
+ */
+static int
+check_initialised(const void *pointer) {
+    if (!pointer) {
+        PyErr_SetString(PyExc_SystemError, "The object has not been initialised by __init__().");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Contains a CPython streaming rolling median of floats.
+ */
+typedef struct {
+    PyObject_HEAD
+    /** The rolling median, NULL until initialised. */
+    OrderedStructs::RollingMedian::RollingMedian<TYPE_TYPE_DOUBLE> *pRm;
+} RollingMedian;
+
+/**
+ * Create a new CPython RollingMedian type.
+ *
+ * @param type The CPython type.
+ * @return A new CPython RollingMedian type, uninitialised.
+ */
+static PyObject *
+RollingMedian_new(PyTypeObject *type, PyObject */* args */, PyObject */* kwargs */) {
+    RollingMedian *self = NULL;
+
+    self = (RollingMedian *) type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->pRm = NULL;
+    }
+    return (PyObject *) self;
+}
+
+/**
+ * Initialise a CPython RollingMedian type.
+ *
+ * @param self The CPython RollingMedian object.
+ * @param args The arguments, the window length.
+ * @param kwargs Keyword arguments: "window_length".
+ * @return 0 on success.
+ */
+static int
+RollingMedian_init(RollingMedian *self, PyObject *args, PyObject *kwargs) {
+    int ret_val = -1;
+    Py_ssize_t window_length = 0;
+    static char *kwlist[] = {
+            (char *) "window_length",
+            NULL
+    };
+    assert(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n:__init__",
+                                     kwlist,
+                                     &window_length)) {
+        goto except;
+    }
+    if (window_length <= 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"window_length\" to __init__ must be > 0 not %zd",
+                     window_length);
+        goto except;
+    }
+    delete self->pRm;
+    self->pRm = new OrderedStructs::RollingMedian::RollingMedian<TYPE_TYPE_DOUBLE>(window_length);
+    assert(!PyErr_Occurred());
+    ret_val = 0;
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    ret_val = -1;
+finally:
+    return ret_val;
+}
+
+static void
+RollingMedian_dealloc(RollingMedian *self) {
+    if (self) {
+        delete self->pRm;
+        Py_TYPE(self)->tp_free((PyObject *) self);
+    }
+}
+
+static PyMemberDef RollingMedian_members[] = {
+        {NULL, 0, 0, 0, NULL}  /* Sentinel */
+};
+
+static PyObject *
+RollingMedian_push(RollingMedian *self, PyObject *arg) {
+    PyObject *ret_val = NULL;
+
+    assert(self);
+    assert(arg);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    if (!PyFloat_Check(arg)) {
+        PyErr_Format(PyExc_TypeError,
+                     "Argument to push() must be float not \"%s\" type",
+                     Py_TYPE(arg)->tp_name);
+        return NULL;
+    }
+    try {
+        ret_val = PyFloat_FromDouble(self->pRm->push(PyFloat_AS_DOUBLE(arg)));
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {
+        /* This will happen if arg is a NaN. */
+        PyErr_Format(PyExc_ValueError, "Can not push() a NaN with error \"%s\"", err.message().c_str());
+        return NULL;
+    }
+    return ret_val;
+}
+
+static PyObject *
+RollingMedian_median(RollingMedian *self) {
+    PyObject *ret_val = NULL;
+
+    assert(self);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    try {
+        ret_val = PyFloat_FromDouble(self->pRm->median());
+    } catch (OrderedStructs::SkipList::IndexError &err) {
+        PyErr_SetString(PyExc_IndexError, "Can not find the median() of an empty window.");
+        return NULL;
+    }
+    return ret_val;
+}
+
+/* Used by tp_as_sequence to implement len() support. */
+static Py_ssize_t
+RollingMedian_length(PyObject *self) {
+    assert(self);
+    if (check_initialised(((RollingMedian *) self)->pRm)) {
+        return -1;
+    }
+    return ((RollingMedian *) self)->pRm->size();
+}
+
+static PyObject *
+RollingMedian_size(RollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(self->pRm->size());
+}
+
+static PyObject *
+RollingMedian_window_length(RollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(self->pRm->win_length());
+}
+
+static PyMethodDef RollingMedian_methods[] = {
+        {"push", (PyCFunction) RollingMedian_push, METH_O,
+         "Add the float value to the window, evicting the oldest value if the window is full,"
+         " and return the median of the window."
+        },
+        {"median", (PyCFunction) RollingMedian_median, METH_NOARGS,
+         "Return the median of the window. Will raise an IndexError if the window is empty."
+        },
+        /* __len__ is an alias to this. */
+        {"size", (PyCFunction) RollingMedian_size, METH_NOARGS,
+         "Return the number of values in the window, this is at most the window length."
+        },
+        {"window_length", (PyCFunction) RollingMedian_window_length, METH_NOARGS,
+         "Return the window length."
+        },
+        {NULL, NULL, 0, NULL}  /* Sentinel */
+};
+
+/* Support for len(). */
+static PySequenceMethods RollingMedian_SequenceMethods = {
+        &RollingMedian_length,  /* sq_length */
+        0,                      /* sq_concat */
+        0,                      /* sq_repeat */
+        0,                      /* sq_item */
+        0,                      /* sq_slice */
+        0,                      /* sq_ass_item */
+        0,                      /* sq_ass_slice */
+        0,                      /* sq_contains */
+#if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION >= 6
+        0,                      /* sq_inplace_concat */
+        0,                      /* sq_inplace_repeat */
+#endif
+};
+
+static char py_rolling_median_docs[] =
+        "RollingMedian(window_length) - A streaming rolling median of floats."
+        " Each push(value) returns the median of the last window_length values."
+        " Storage is allocated up front so steady state pushes do not allocate memory.";
+
+PyTypeObject RollingMedianType = {
+        .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = ORDERED_STRUCTS_MODULE_NAME ".RollingMedian",
+        .tp_basicsize = sizeof(RollingMedian),
+        .tp_dealloc = (destructor) RollingMedian_dealloc,
+        .tp_as_sequence = &RollingMedian_SequenceMethods,
+        .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+        .tp_doc = py_rolling_median_docs,
+        .tp_methods = RollingMedian_methods,
+        .tp_members = RollingMedian_members,
+        .tp_init = (initproc) RollingMedian_init,
+        .tp_new = RollingMedian_new
+};
+
+/**
+ * @brief Contains a CPython streaming rolling median of floats over a time window with float timestamps.
+ */
+typedef struct {
+    PyObject_HEAD
+    /** The rolling median, NULL until initialised. */
+    OrderedStructs::RollingMedian::TimeWindowRollingMedian<TYPE_TYPE_DOUBLE, double> *pRm;
+} TimeWindowRollingMedian;
+
+/**
+ * Create a new CPython TimeWindowRollingMedian type.
+ *
+ * @param type The CPython type.
+ * @return A new CPython TimeWindowRollingMedian type, uninitialised.
+ */
+static PyObject *
+TimeWindowRollingMedian_new(PyTypeObject *type, PyObject */* args */, PyObject */* kwargs */) {
+    TimeWindowRollingMedian *self = NULL;
+
+    self = (TimeWindowRollingMedian *) type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->pRm = NULL;
+    }
+    return (PyObject *) self;
+}
+
+/**
+ * Initialise a CPython TimeWindowRollingMedian type.
+ *
+ * @param self The CPython TimeWindowRollingMedian object.
+ * @param args The arguments, the duration.
+ * @param kwargs Keyword arguments: "duration".
+ * @return 0 on success.
+ */
+static int
+TimeWindowRollingMedian_init(TimeWindowRollingMedian *self, PyObject *args, PyObject *kwargs) {
+    int ret_val = -1;
+    double duration = 0.0;
+    static char *kwlist[] = {
+            (char *) "duration",
+            NULL
+    };
+    assert(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "d:__init__",
+                                     kwlist,
+                                     &duration)) {
+        goto except;
+    }
+    if (!(duration > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"duration\" to __init__ must be > 0");
+        goto except;
+    }
+    delete self->pRm;
+    self->pRm = new OrderedStructs::RollingMedian::TimeWindowRollingMedian<TYPE_TYPE_DOUBLE, double>(duration);
+    assert(!PyErr_Occurred());
+    ret_val = 0;
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    ret_val = -1;
+finally:
+    return ret_val;
+}
+
+static void
+TimeWindowRollingMedian_dealloc(TimeWindowRollingMedian *self) {
+    if (self) {
+        delete self->pRm;
+        Py_TYPE(self)->tp_free((PyObject *) self);
+    }
+}
+
+static PyMemberDef TimeWindowRollingMedian_members[] = {
+        {NULL, 0, 0, 0, NULL}  /* Sentinel */
+};
+
+static PyObject *
+TimeWindowRollingMedian_push(TimeWindowRollingMedian *self, PyObject *args) {
+    double timestamp = 0.0;
+    double value = 0.0;
+
+    assert(self);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    if (!PyArg_ParseTuple(args, "dd:push", &timestamp, &value)) {
+        return NULL;
+    }
+    try {
+        return PyFloat_FromDouble(self->pRm->push(timestamp, value));
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {
+        /* This will happen if value is a NaN. */
+        PyErr_Format(PyExc_ValueError, "Can not push() a NaN with error \"%s\"", err.message().c_str());
+    } catch (OrderedStructs::SkipList::ValueError &err) {
+        /* This will happen if the timestamp decreases or is a NaN. */
+        PyErr_Format(PyExc_ValueError, "Can not push() with error \"%s\"", err.message().c_str());
+    }
+    return NULL;
+}
+
+static PyObject *
+TimeWindowRollingMedian_evict(TimeWindowRollingMedian *self, PyObject *arg) {
+    assert(self);
+    assert(arg);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    double timestamp = PyFloat_AsDouble(arg);
+    if (timestamp == -1.0 && PyErr_Occurred()) {
+        return NULL;
+    }
+    try {
+        return PyLong_FromSize_t(self->pRm->evict(timestamp));
+    } catch (OrderedStructs::SkipList::ValueError &err) {
+        /* This will happen if the timestamp is a NaN. */
+        PyErr_Format(PyExc_ValueError, "Can not evict() with error \"%s\"", err.message().c_str());
+    }
+    return NULL;
+}
+
+static PyObject *
+TimeWindowRollingMedian_median(TimeWindowRollingMedian *self) {
+    PyObject *ret_val = NULL;
+
+    assert(self);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    try {
+        ret_val = PyFloat_FromDouble(self->pRm->median());
+    } catch (OrderedStructs::SkipList::IndexError &err) {
+        PyErr_SetString(PyExc_IndexError, "Can not find the median() of an empty window.");
+        return NULL;
+    }
+    return ret_val;
+}
+
+/* Used by tp_as_sequence to implement len() support. */
+static Py_ssize_t
+TimeWindowRollingMedian_length(PyObject *self) {
+    assert(self);
+    if (check_initialised(((TimeWindowRollingMedian *) self)->pRm)) {
+        return -1;
+    }
+    return ((TimeWindowRollingMedian *) self)->pRm->size();
+}
+
+static PyObject *
+TimeWindowRollingMedian_size(TimeWindowRollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(self->pRm->size());
+}
+
+static PyObject *
+TimeWindowRollingMedian_duration(TimeWindowRollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyFloat_FromDouble(self->pRm->duration());
+}
+
+static PyMethodDef TimeWindowRollingMedian_methods[] = {
+        {"push", (PyCFunction) TimeWindowRollingMedian_push, METH_VARARGS,
+         "push(timestamp, value) - Evict the values that are duration or more before timestamp, add the float value"
+         " to the window and return the median of the window. The timestamps must not decrease or be NaN."
+        },
+        {"evict", (PyCFunction) TimeWindowRollingMedian_evict, METH_O,
+         "evict(timestamp) - Evict the values that are duration or more before timestamp"
+         " and return the number evicted."
+        },
+        {"median", (PyCFunction) TimeWindowRollingMedian_median, METH_NOARGS,
+         "Return the median of the window. Will raise an IndexError if the window is empty."
+        },
+        /* __len__ is an alias to this. */
+        {"size", (PyCFunction) TimeWindowRollingMedian_size, METH_NOARGS,
+         "Return the number of values in the window."
+        },
+        {"duration", (PyCFunction) TimeWindowRollingMedian_duration, METH_NOARGS,
+         "Return the duration of the window."
+        },
+        {NULL, NULL, 0, NULL}  /* Sentinel */
+};
+
+/* Support for len(). */
+static PySequenceMethods TimeWindowRollingMedian_SequenceMethods = {
+        &TimeWindowRollingMedian_length,    /* sq_length */
+        0,                                  /* sq_concat */
+        0,                                  /* sq_repeat */
+        0,                                  /* sq_item */
+        0,                                  /* sq_slice */
+        0,                                  /* sq_ass_item */
+        0,                                  /* sq_ass_slice */
+        0,                                  /* sq_contains */
+#if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION >= 6
+        0,                                  /* sq_inplace_concat */
+        0,                                  /* sq_inplace_repeat */
+#endif
+};
+
+static char py_time_window_rolling_median_docs[] =
+        "TimeWindowRollingMedian(duration) - A streaming rolling median of floats over a time window."
+        " Each push(timestamp, value) returns the median of the values with timestamps in the range"
+        " (timestamp - duration, timestamp].";
+
+PyTypeObject TimeWindowRollingMedianType = {
+        .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = ORDERED_STRUCTS_MODULE_NAME ".TimeWindowRollingMedian",
+        .tp_basicsize = sizeof(TimeWindowRollingMedian),
+        .tp_dealloc = (destructor) TimeWindowRollingMedian_dealloc,
+        .tp_as_sequence = &TimeWindowRollingMedian_SequenceMethods,
+        .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+        .tp_doc = py_time_window_rolling_median_docs,
+        .tp_methods = TimeWindowRollingMedian_methods,
+        .tp_members = TimeWindowRollingMedian_members,
+        .tp_init = (initproc) TimeWindowRollingMedian_init,
+        .tp_new = TimeWindowRollingMedian_new
+};
+
+/**
+ * @brief Contains a CPython streaming rolling weighted median of floats.
+ */
+typedef struct {
+    PyObject_HEAD
+    /** The rolling weighted median, NULL until initialised. */
+    OrderedStructs::RollingMedian::WeightedRollingMedian<TYPE_TYPE_DOUBLE> *pRm;
+} WeightedRollingMedian;
+
+/**
+ * Create a new CPython WeightedRollingMedian type.
+ *
+ * @param type The CPython type.
+ * @return A new CPython WeightedRollingMedian type, uninitialised.
+ */
+static PyObject *
+WeightedRollingMedian_new(PyTypeObject *type, PyObject */* args */, PyObject */* kwargs */) {
+    WeightedRollingMedian *self = NULL;
+
+    self = (WeightedRollingMedian *) type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->pRm = NULL;
+    }
+    return (PyObject *) self;
+}
+
+/**
+ * Initialise a CPython WeightedRollingMedian type.
+ *
+ * @param self The CPython WeightedRollingMedian object.
+ * @param args The arguments, the window length.
+ * @param kwargs Keyword arguments: "window_length".
+ * @return 0 on success.
+ */
+static int
+WeightedRollingMedian_init(WeightedRollingMedian *self, PyObject *args, PyObject *kwargs) {
+    int ret_val = -1;
+    Py_ssize_t window_length = 0;
+    static char *kwlist[] = {
+            (char *) "window_length",
+            NULL
+    };
+    assert(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n:__init__",
+                                     kwlist,
+                                     &window_length)) {
+        goto except;
+    }
+    if (window_length <= 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"window_length\" to __init__ must be > 0 not %zd",
+                     window_length);
+        goto except;
+    }
+    delete self->pRm;
+    self->pRm = new OrderedStructs::RollingMedian::WeightedRollingMedian<TYPE_TYPE_DOUBLE>(window_length);
+    assert(!PyErr_Occurred());
+    ret_val = 0;
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    ret_val = -1;
+finally:
+    return ret_val;
+}
+
+static void
+WeightedRollingMedian_dealloc(WeightedRollingMedian *self) {
+    if (self) {
+        delete self->pRm;
+        Py_TYPE(self)->tp_free((PyObject *) self);
+    }
+}
+
+static PyMemberDef WeightedRollingMedian_members[] = {
+        {NULL, 0, 0, 0, NULL}  /* Sentinel */
+};
+
+static PyObject *
+WeightedRollingMedian_push(WeightedRollingMedian *self, PyObject *args) {
+    double value = 0.0;
+    double weight = 0.0;
+
+    assert(self);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    if (!PyArg_ParseTuple(args, "dd:push", &value, &weight)) {
+        return NULL;
+    }
+    try {
+        return PyFloat_FromDouble(self->pRm->push(value, weight));
+    } catch (OrderedStructs::SkipList::FailedComparison &err) {
+        /* This will happen if value is a NaN. */
+        PyErr_Format(PyExc_ValueError, "Can not push() a NaN with error \"%s\"", err.message().c_str());
+    } catch (OrderedStructs::SkipList::ValueError &err) {
+        /* This will happen if the weight is negative or not finite. */
+        PyErr_Format(PyExc_ValueError, "Can not push() with error \"%s\"", err.message().c_str());
+    }
+    return NULL;
+}
+
+static PyObject *
+WeightedRollingMedian_median(WeightedRollingMedian *self) {
+    PyObject *ret_val = NULL;
+
+    assert(self);
+    assert(!PyErr_Occurred());
+
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    try {
+        ret_val = PyFloat_FromDouble(self->pRm->median());
+    } catch (OrderedStructs::SkipList::IndexError &err) {
+        PyErr_SetString(PyExc_IndexError, "Can not find the median() of an empty window.");
+        return NULL;
+    }
+    return ret_val;
+}
+
+/* Used by tp_as_sequence to implement len() support. */
+static Py_ssize_t
+WeightedRollingMedian_length(PyObject *self) {
+    assert(self);
+    if (check_initialised(((WeightedRollingMedian *) self)->pRm)) {
+        return -1;
+    }
+    return ((WeightedRollingMedian *) self)->pRm->size();
+}
+
+static PyObject *
+WeightedRollingMedian_size(WeightedRollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(self->pRm->size());
+}
+
+static PyObject *
+WeightedRollingMedian_window_length(WeightedRollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(self->pRm->win_length());
+}
+
+static PyObject *
+WeightedRollingMedian_total_weight(WeightedRollingMedian *self) {
+    assert(self);
+    if (check_initialised(self->pRm)) {
+        return NULL;
+    }
+    return PyFloat_FromDouble(self->pRm->total_weight());
+}
+
+static PyMethodDef WeightedRollingMedian_methods[] = {
+        {"push", (PyCFunction) WeightedRollingMedian_push, METH_VARARGS,
+         "push(value, weight) - Add the float value with its weight to the window, evicting the oldest value if the"
+         " window is full, and return the weighted median of the window."
+         " The weight must be finite and non-negative."
+        },
+        {"median", (PyCFunction) WeightedRollingMedian_median, METH_NOARGS,
+         "Return the weighted median of the window. Will raise an IndexError if the window is empty."
+        },
+        /* __len__ is an alias to this. */
+        {"size", (PyCFunction) WeightedRollingMedian_size, METH_NOARGS,
+         "Return the number of values in the window, this is at most the window length."
+        },
+        {"window_length", (PyCFunction) WeightedRollingMedian_window_length, METH_NOARGS,
+         "Return the window length."
+        },
+        {"total_weight", (PyCFunction) WeightedRollingMedian_total_weight, METH_NOARGS,
+         "Return the total weight of the window."
+        },
+        {NULL, NULL, 0, NULL}  /* Sentinel */
+};
+
+/* Support for len(). */
+static PySequenceMethods WeightedRollingMedian_SequenceMethods = {
+        &WeightedRollingMedian_length,  /* sq_length */
+        0,                              /* sq_concat */
+        0,                              /* sq_repeat */
+        0,                              /* sq_item */
+        0,                              /* sq_slice */
+        0,                              /* sq_ass_item */
+        0,                              /* sq_ass_slice */
+        0,                              /* sq_contains */
+#if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION >= 6
+        0,                              /* sq_inplace_concat */
+        0,                              /* sq_inplace_repeat */
+#endif
+};
+
+static char py_weighted_rolling_median_docs[] =
+        "WeightedRollingMedian(window_length) - A streaming rolling weighted median of floats."
+        " Each push(value, weight) returns the first value of the last window_length values, in sorted order, where the"
+        " cumulative weight reaches half the total weight of the window.";
+
+PyTypeObject WeightedRollingMedianType = {
+        .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = ORDERED_STRUCTS_MODULE_NAME ".WeightedRollingMedian",
+        .tp_basicsize = sizeof(WeightedRollingMedian),
+        .tp_dealloc = (destructor) WeightedRollingMedian_dealloc,
+        .tp_as_sequence = &WeightedRollingMedian_SequenceMethods,
+        .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+        .tp_doc = py_weighted_rolling_median_docs,
+        .tp_methods = WeightedRollingMedian_methods,
+        .tp_members = WeightedRollingMedian_members,
+        .tp_init = (initproc) WeightedRollingMedian_init,
+        .tp_new = WeightedRollingMedian_new
+};
+
+/**
+ * Check that a buffer is a 2D array with non-negative strides and set a ValueError if not.
+ *
+ * @param name The name of the argument for the error message.
+ * @param view The buffer.
+ * @return 0 on success, non-zero on failure.
+ */
+static int
+check_2d_buffer(const char *name, const Py_buffer &view) {
+    if (view.ndim != 2) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"%s\" must be a 2D array not %d dimensions", name, view.ndim);
+        return -1;
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (view.strides[i] < 0 || view.strides[i] % view.itemsize != 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "Argument \"%s\" must have positive strides that are a multiple of the item size.", name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Check that a buffer is a 2D array of doubles with non-negative strides and set a ValueError if not.
+ *
+ * @param name The name of the argument for the error message.
+ * @param view The buffer.
+ * @return 0 on success, non-zero on failure.
+ */
+static int
+check_2d_double_buffer(const char *name, const Py_buffer &view) {
+    if (view.ndim != 2) {
+        return check_2d_buffer(name, view);
+    }
+    if (!view.format || strcmp(view.format, "d") != 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"%s\" must be an array of doubles not format \"%s\"",
+                     name, view.format ? view.format : "B");
+        return -1;
+    }
+    return check_2d_buffer(name, view);
+}
+
+/**
+ * Check that a buffer is a 1D array of doubles with positive strides and set a ValueError if not.
+ *
+ * @param name The name of the argument for the error message.
+ * @param view The buffer.
+ * @return 0 on success, non-zero on failure.
+ */
+static int
+check_1d_double_buffer(const char *name, const Py_buffer &view) {
+    if (view.ndim != 1) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"%s\" must be a 1D array not %d dimensions", name, view.ndim);
+        return -1;
+    }
+    if (!view.format || strcmp(view.format, "d") != 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"%s\" must be an array of doubles not format \"%s\"",
+                     name, view.format ? view.format : "B");
+        return -1;
+    }
+    if (view.strides[0] <= 0 || view.strides[0] % view.itemsize != 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"%s\" must have positive strides that are a multiple of the item size.", name);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Set a Python exception from a C++ exception that was caught whilst the GIL was released, the GIL must be held.
+ * A std::bad_alloc becomes a MemoryError and anything else, for example a std::system_error when a thread can not be
+ * started, becomes a RuntimeError.
+ *
+ * @param error The exception.
+ */
+static void
+set_error_from_exception(std::exception_ptr error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (std::bad_alloc &err) {
+        PyErr_NoMemory();
+    } catch (std::exception &err) {
+        PyErr_SetString(PyExc_RuntimeError, err.what());
+    } catch (...) {
+        PyErr_SetString(PyExc_RuntimeError, "Unknown C++ exception.");
+    }
+}
+
+char rolling_median_columns_docs[] =
+        "rolling_median_columns(src, dest, window_length, thread_count=0) -"
+        " Compute the rolling median of every column of the 2D array of floats src and write them to dest."
+        " dest must be a writable 2D array of floats with shape (rows - window_length + 1, columns)."
+        " Even window lengths use the mean of the two central values."
+        " This uses thread_count threads, at most one per CPU or one per CPU if zero, with the GIL released.";
+
+/**
+ * Rolling median of all the columns of a 2D buffer of doubles in parallel.
+ *
+ * @param args The arguments: src, dest, window_length and optionally thread_count.
+ * @param kwargs Keyword arguments: "src", "dest", "window_length", "thread_count".
+ * @return None on success, NULL on failure.
+ */
+PyObject *
+rolling_median_columns(PyObject */* module */, PyObject *args, PyObject *kwargs) {
+    PyObject *ret_val = NULL;
+    PyObject *src = NULL;
+    PyObject *dest = NULL;
+    Py_ssize_t window_length = 0;
+    Py_ssize_t thread_count = 0;
+    Py_buffer src_view = {};
+    Py_buffer dest_view = {};
+    OrderedStructs::RollingMedian::RollingMedianResult result = OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS;
+    bool failed_comparison = false;
+    std::exception_ptr error;
+    static char *kwlist[] = {
+            (char *) "src",
+            (char *) "dest",
+            (char *) "window_length",
+            (char *) "thread_count",
+            NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOn|n:rolling_median_columns",
+                                     kwlist,
+                                     &src, &dest, &window_length, &thread_count)) {
+        goto except;
+    }
+    if (window_length <= 0) {
+        PyErr_Format(PyExc_ValueError, "Argument \"window_length\" must be > 0 not %zd", window_length);
+        goto except;
+    }
+    if (thread_count < 0) {
+        PyErr_Format(PyExc_ValueError, "Argument \"thread_count\" must be >= 0 not %zd", thread_count);
+        goto except;
+    }
+    if (PyObject_GetBuffer(src, &src_view, PyBUF_STRIDES | PyBUF_FORMAT)) {
+        goto except;
+    }
+    if (PyObject_GetBuffer(dest, &dest_view, PyBUF_STRIDES | PyBUF_FORMAT | PyBUF_WRITABLE)) {
+        goto except;
+    }
+    if (check_2d_double_buffer("src", src_view) || check_2d_double_buffer("dest", dest_view)) {
+        goto except;
+    }
+    if (src_view.shape[0] < window_length) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"src\" has %zd rows which is less than the window length %zd",
+                     src_view.shape[0], window_length);
+        goto except;
+    }
+    if (dest_view.shape[0] != src_view.shape[0] - window_length + 1 || dest_view.shape[1] != src_view.shape[1]) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"dest\" must have shape (%zd, %zd) not (%zd, %zd)",
+                     src_view.shape[0] - window_length + 1, src_view.shape[1],
+                     dest_view.shape[0], dest_view.shape[1]);
+        goto except;
+    }
+    Py_BEGIN_ALLOW_THREADS
+        try {
+            result = OrderedStructs::RollingMedian::even_odd_index_columns(
+                    static_cast<const double *>(src_view.buf),
+                    src_view.strides[0] / src_view.itemsize, src_view.strides[1] / src_view.itemsize,
+                    src_view.shape[0], src_view.shape[1], window_length,
+                    static_cast<double *>(dest_view.buf),
+                    dest_view.strides[0] / dest_view.itemsize, dest_view.strides[1] / dest_view.itemsize,
+                    thread_count
+            );
+        } catch (OrderedStructs::SkipList::FailedComparison &err) {
+            /* This will happen if there is a NaN in src. */
+            failed_comparison = true;
+        } catch (...) {
+            /* The Python exception can only be set once the GIL is held again. */
+            error = std::current_exception();
+        }
+    Py_END_ALLOW_THREADS
+    if (failed_comparison) {
+        PyErr_SetString(PyExc_ValueError, "Can not compute the rolling median of columns containing a NaN.");
+        goto except;
+    }
+    if (error) {
+        set_error_from_exception(error);
+        goto except;
+    }
+    if (result != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS) {
+        PyErr_Format(PyExc_ValueError, "Rolling median failed with error code %d", result);
+        goto except;
+    }
+    assert(!PyErr_Occurred());
+    Py_INCREF(Py_None);
+    ret_val = Py_None;
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    ret_val = NULL;
+finally:
+    if (src_view.obj) {
+        PyBuffer_Release(&src_view);
+    }
+    if (dest_view.obj) {
+        PyBuffer_Release(&dest_view);
+    }
+    return ret_val;
+}
+
+char median_filter_2d_docs[] =
+        "median_filter_2d(src, dest, kernel_size, thread_count=0) -"
+        " Compute the 2D median filter of the 2D array src with a square kernel_size x kernel_size window and write it"
+        " to dest."
+        " src can be an array of floats, uint8 or uint16 and dest must be a writable array of the same type with shape"
+        " (rows - kernel_size + 1, columns - kernel_size + 1)."
+        " Even kernel sizes use the mean of the two central values."
+        " This uses thread_count threads, at most one per CPU or one per CPU if zero, with the GIL released.";
+
+/**
+ * Apply the 2D median filter to buffers that have been checked to have the type T.
+ */
+template<typename T>
+static OrderedStructs::RollingMedian::RollingMedianResult
+median_filter_2d_buffer(const Py_buffer &src_view, Py_buffer &dest_view, size_t kernel_size, size_t thread_count) {
+    return OrderedStructs::RollingMedian::median_filter_2d(
+            static_cast<const T *>(src_view.buf),
+            src_view.strides[0] / src_view.itemsize, src_view.strides[1] / src_view.itemsize,
+            src_view.shape[0], src_view.shape[1], kernel_size,
+            static_cast<T *>(dest_view.buf),
+            dest_view.strides[0] / dest_view.itemsize, dest_view.strides[1] / dest_view.itemsize,
+            thread_count
+    );
+}
+
+/**
+ * 2D median filter of a 2D buffer of doubles, unsigned char or unsigned short in parallel.
+ *
+ * @param args The arguments: src, dest, kernel_size and optionally thread_count.
+ * @param kwargs Keyword arguments: "src", "dest", "kernel_size", "thread_count".
+ * @return None on success, NULL on failure.
+ */
+PyObject *
+median_filter_2d(PyObject */* module */, PyObject *args, PyObject *kwargs) {
+    PyObject *ret_val = NULL;
+    PyObject *src = NULL;
+    PyObject *dest = NULL;
+    Py_ssize_t kernel_size = 0;
+    Py_ssize_t thread_count = 0;
+    Py_buffer src_view = {};
+    Py_buffer dest_view = {};
+    char format = '\0';
+    OrderedStructs::RollingMedian::RollingMedianResult result = OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS;
+    bool failed_comparison = false;
+    std::exception_ptr error;
+    static char *kwlist[] = {
+            (char *) "src",
+            (char *) "dest",
+            (char *) "kernel_size",
+            (char *) "thread_count",
+            NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOn|n:median_filter_2d",
+                                     kwlist,
+                                     &src, &dest, &kernel_size, &thread_count)) {
+        goto except;
+    }
+    if (kernel_size <= 0) {
+        PyErr_Format(PyExc_ValueError, "Argument \"kernel_size\" must be > 0 not %zd", kernel_size);
+        goto except;
+    }
+    if (thread_count < 0) {
+        PyErr_Format(PyExc_ValueError, "Argument \"thread_count\" must be >= 0 not %zd", thread_count);
+        goto except;
+    }
+    if (PyObject_GetBuffer(src, &src_view, PyBUF_STRIDES | PyBUF_FORMAT)) {
+        goto except;
+    }
+    if (PyObject_GetBuffer(dest, &dest_view, PyBUF_STRIDES | PyBUF_FORMAT | PyBUF_WRITABLE)) {
+        goto except;
+    }
+    if (check_2d_buffer("src", src_view) || check_2d_buffer("dest", dest_view)) {
+        goto except;
+    }
+    /* A NULL format means unsigned bytes. */
+    format = src_view.format ? src_view.format[0] : 'B';
+    if ((src_view.format && strlen(src_view.format) != 1) || !strchr("dBH", format)) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"src\" must be an array of doubles, unsigned char or unsigned short not format \"%s\"",
+                     src_view.format);
+        goto except;
+    }
+    if (strcmp(dest_view.format ? dest_view.format : "B", src_view.format ? src_view.format : "B") != 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"dest\" must have the same format as \"src\" \"%c\" not \"%s\"",
+                     format, dest_view.format ? dest_view.format : "B");
+        goto except;
+    }
+    if (src_view.shape[0] < kernel_size || src_view.shape[1] < kernel_size) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"src\" has shape (%zd, %zd) which is smaller than the kernel size %zd",
+                     src_view.shape[0], src_view.shape[1], kernel_size);
+        goto except;
+    }
+    if (dest_view.shape[0] != src_view.shape[0] - kernel_size + 1
+        || dest_view.shape[1] != src_view.shape[1] - kernel_size + 1) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"dest\" must have shape (%zd, %zd) not (%zd, %zd)",
+                     src_view.shape[0] - kernel_size + 1, src_view.shape[1] - kernel_size + 1,
+                     dest_view.shape[0], dest_view.shape[1]);
+        goto except;
+    }
+    Py_BEGIN_ALLOW_THREADS
+        try {
+            switch (format) {
+                case 'd':
+                    result = median_filter_2d_buffer<double>(src_view, dest_view, kernel_size, thread_count);
+                    break;
+                case 'B':
+                    result = median_filter_2d_buffer<unsigned char>(src_view, dest_view, kernel_size, thread_count);
+                    break;
+                case 'H':
+                    result = median_filter_2d_buffer<unsigned short>(src_view, dest_view, kernel_size,
+                                                                     thread_count);
+                    break;
+                default:
+                    assert(0);
+                    break;
+            }
+        } catch (OrderedStructs::SkipList::FailedComparison &err) {
+            /* This will happen if there is a NaN in src. */
+            failed_comparison = true;
+        } catch (...) {
+            /* The Python exception can only be set once the GIL is held again. */
+            error = std::current_exception();
+        }
+    Py_END_ALLOW_THREADS
+    if (failed_comparison) {
+        PyErr_SetString(PyExc_ValueError, "Can not compute the median filter of an array containing a NaN.");
+        goto except;
+    }
+    if (error) {
+        set_error_from_exception(error);
+        goto except;
+    }
+    if (result != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS) {
+        PyErr_Format(PyExc_ValueError, "Median filter failed with error code %d", result);
+        goto except;
+    }
+    assert(!PyErr_Occurred());
+    Py_INCREF(Py_None);
+    ret_val = Py_None;
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    ret_val = NULL;
+finally:
+    if (src_view.obj) {
+        PyBuffer_Release(&src_view);
+    }
+    if (dest_view.obj) {
+        PyBuffer_Release(&dest_view);
+    }
+    return ret_val;
+}
+
+char hampel_filter_docs[] =
+        "hampel_filter(src, dest, half_width, n_sigmas=3.0) -"
+        " Hampel outlier filter of the 1D array of floats src, the filtered values are written to dest which must be a"
+        " writable 1D array of floats of the same length, this can be src."
+        " Each value is compared with the median and median absolute deviation (MAD) of the window of"
+        " 2 * half_width + 1 values centred on it, if it differs from the median by more than n_sigmas * 1.4826 * MAD"
+        " it is replaced by the median."
+        " The half_width values at each end are unchanged."
+        " Returns a list of the indexes of the outliers.";
+
+/**
+ * Hampel filter of a 1D buffer of doubles.
+ *
+ * @param args The arguments: src, dest, half_width and optionally n_sigmas.
+ * @param kwargs Keyword arguments: "src", "dest", "half_width", "n_sigmas".
+ * @return A list of the outlier indexes on success, NULL on failure.
+ */
+PyObject *
+hampel_filter(PyObject */* module */, PyObject *args, PyObject *kwargs) {
+    PyObject *ret_val = NULL;
+    PyObject *src = NULL;
+    PyObject *dest = NULL;
+    Py_ssize_t half_width = 0;
+    double n_sigmas = 3.0;
+    Py_buffer src_view = {};
+    Py_buffer dest_view = {};
+    std::vector<size_t> outliers;
+    OrderedStructs::RollingMedian::RollingMedianResult result = OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS;
+    bool failed_comparison = false;
+    std::exception_ptr error;
+    static char *kwlist[] = {
+            (char *) "src",
+            (char *) "dest",
+            (char *) "half_width",
+            (char *) "n_sigmas",
+            NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOn|d:hampel_filter",
+                                     kwlist,
+                                     &src, &dest, &half_width, &n_sigmas)) {
+        goto except;
+    }
+    if (half_width < 0) {
+        PyErr_Format(PyExc_ValueError, "Argument \"half_width\" must be >= 0 not %zd", half_width);
+        goto except;
+    }
+    if (!(n_sigmas >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"n_sigmas\" must be >= 0");
+        goto except;
+    }
+    if (PyObject_GetBuffer(src, &src_view, PyBUF_STRIDES | PyBUF_FORMAT)) {
+        goto except;
+    }
+    if (PyObject_GetBuffer(dest, &dest_view, PyBUF_STRIDES | PyBUF_FORMAT | PyBUF_WRITABLE)) {
+        goto except;
+    }
+    if (check_1d_double_buffer("src", src_view) || check_1d_double_buffer("dest", dest_view)) {
+        goto except;
+    }
+    if (dest_view.shape[0] != src_view.shape[0]) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"dest\" must have length %zd not %zd", src_view.shape[0], dest_view.shape[0]);
+        goto except;
+    }
+    Py_BEGIN_ALLOW_THREADS
+        try {
+            result = OrderedStructs::RollingMedian::hampel_filter(
+                    static_cast<const double *>(src_view.buf), src_view.strides[0] / src_view.itemsize,
+                    src_view.shape[0], half_width, n_sigmas,
+                    static_cast<double *>(dest_view.buf), dest_view.strides[0] / dest_view.itemsize,
+                    outliers
+            );
+        } catch (OrderedStructs::SkipList::FailedComparison &err) {
+            /* This will happen if there is a NaN in src. */
+            failed_comparison = true;
+        } catch (...) {
+            /* The Python exception can only be set once the GIL is held again. */
+            error = std::current_exception();
+        }
+    Py_END_ALLOW_THREADS
+    if (failed_comparison) {
+        PyErr_SetString(PyExc_ValueError, "Can not compute the Hampel filter of an array containing a NaN.");
+        goto except;
+    }
+    if (error) {
+        set_error_from_exception(error);
+        goto except;
+    }
+    if (result != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS) {
+        PyErr_Format(PyExc_ValueError, "Hampel filter failed with error code %d", result);
+        goto except;
+    }
+    ret_val = PyList_New(outliers.size());
+    if (!ret_val) {
+        goto except;
+    }
+    for (size_t i = 0; i < outliers.size(); ++i) {
+        PyObject *index = PyLong_FromSize_t(outliers[i]);
+        if (!index) {
+            goto except;
+        }
+        PyList_SET_ITEM(ret_val, i, index);
+    }
+    assert(!PyErr_Occurred());
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    Py_XDECREF(ret_val);
+    ret_val = NULL;
+finally:
+    if (src_view.obj) {
+        PyBuffer_Release(&src_view);
+    }
+    if (dest_view.obj) {
+        PyBuffer_Release(&dest_view);
+    }
+    return ret_val;
+}
+
+char weighted_rolling_median_docs[] =
+        "weighted_rolling_median(src, weights, dest, window_length) -"
+        " Compute the rolling weighted median of the 1D array of floats src with the 1D array of float weights and"
+        " write it to dest."
+        " The weighted median is the first value of the window, in sorted order, where the cumulative weight reaches"
+        " half the total weight of the window."
+        " The weights must be finite and non-negative."
+        " dest must be a writable 1D array of floats of length len(src) - window_length + 1."
+        " This releases the GIL.";
+
+/**
+ * Rolling weighted median of a 1D buffer of doubles with a 1D buffer of double weights.
+ *
+ * @param args The arguments: src, weights, dest and window_length.
+ * @param kwargs Keyword arguments: "src", "weights", "dest", "window_length".
+ * @return None on success, NULL on failure.
+ */
+PyObject *
+weighted_rolling_median(PyObject */* module */, PyObject *args, PyObject *kwargs) {
+    PyObject *ret_val = NULL;
+    PyObject *src = NULL;
+    PyObject *weights = NULL;
+    PyObject *dest = NULL;
+    Py_ssize_t window_length = 0;
+    Py_buffer src_view = {};
+    Py_buffer weights_view = {};
+    Py_buffer dest_view = {};
+    OrderedStructs::RollingMedian::RollingMedianResult result = OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS;
+    bool failed_comparison = false;
+    std::exception_ptr error;
+    static char *kwlist[] = {
+            (char *) "src",
+            (char *) "weights",
+            (char *) "dest",
+            (char *) "window_length",
+            NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOn:weighted_rolling_median",
+                                     kwlist,
+                                     &src, &weights, &dest, &window_length)) {
+        goto except;
+    }
+    if (window_length <= 0) {
+        PyErr_Format(PyExc_ValueError, "Argument \"window_length\" must be > 0 not %zd", window_length);
+        goto except;
+    }
+    if (PyObject_GetBuffer(src, &src_view, PyBUF_STRIDES | PyBUF_FORMAT)) {
+        goto except;
+    }
+    if (PyObject_GetBuffer(weights, &weights_view, PyBUF_STRIDES | PyBUF_FORMAT)) {
+        goto except;
+    }
+    if (PyObject_GetBuffer(dest, &dest_view, PyBUF_STRIDES | PyBUF_FORMAT | PyBUF_WRITABLE)) {
+        goto except;
+    }
+    if (check_1d_double_buffer("src", src_view) || check_1d_double_buffer("weights", weights_view)
+        || check_1d_double_buffer("dest", dest_view)) {
+        goto except;
+    }
+    if (weights_view.shape[0] != src_view.shape[0]) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"weights\" must have length %zd not %zd", src_view.shape[0], weights_view.shape[0]);
+        goto except;
+    }
+    if (src_view.shape[0] < window_length) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"src\" has length %zd which is less than the window length %zd",
+                     src_view.shape[0], window_length);
+        goto except;
+    }
+    if (dest_view.shape[0] != src_view.shape[0] - window_length + 1) {
+        PyErr_Format(PyExc_ValueError,
+                     "Argument \"dest\" must have length %zd not %zd",
+                     src_view.shape[0] - window_length + 1, dest_view.shape[0]);
+        goto except;
+    }
+    Py_BEGIN_ALLOW_THREADS
+        try {
+            result = OrderedStructs::RollingMedian::weighted_median(
+                    static_cast<const double *>(src_view.buf), src_view.strides[0] / src_view.itemsize,
+                    static_cast<const double *>(weights_view.buf), weights_view.strides[0] / weights_view.itemsize,
+                    src_view.shape[0], window_length,
+                    static_cast<double *>(dest_view.buf), dest_view.strides[0] / dest_view.itemsize
+            );
+        } catch (OrderedStructs::SkipList::FailedComparison &err) {
+            /* This will happen if there is a NaN in src. */
+            failed_comparison = true;
+        } catch (...) {
+            /* The Python exception can only be set once the GIL is held again. */
+            error = std::current_exception();
+        }
+    Py_END_ALLOW_THREADS
+    if (failed_comparison) {
+        PyErr_SetString(PyExc_ValueError, "Can not compute the weighted median of an array containing a NaN.");
+        goto except;
+    }
+    if (error) {
+        set_error_from_exception(error);
+        goto except;
+    }
+    if (result == OrderedStructs::RollingMedian::ROLLING_MEDIAN_WEIGHT) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"weights\" must be finite and non-negative.");
+        goto except;
+    }
+    if (result != OrderedStructs::RollingMedian::ROLLING_MEDIAN_SUCCESS) {
+        PyErr_Format(PyExc_ValueError, "Weighted median failed with error code %d", result);
+        goto except;
+    }
+    assert(!PyErr_Occurred());
+    Py_INCREF(Py_None);
+    ret_val = Py_None;
+    goto finally;
+except:
+    assert(PyErr_Occurred());
+    ret_val = NULL;
+finally:
+    if (src_view.obj) {
+        PyBuffer_Release(&src_view);
+    }
+    if (weights_view.obj) {
+        PyBuffer_Release(&weights_view);
+    }
+    if (dest_view.obj) {
+        PyBuffer_Release(&dest_view);
+    }
+    return ret_val;
+}
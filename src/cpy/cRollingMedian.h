@@ -0,0 +1,31 @@
+//
+//  cRollingMedian.h
+//  skiplist
+//
+
+#ifndef skiplist_cRollingMedian_h
+#define skiplist_cRollingMedian_h
+
+extern PyTypeObject RollingMedianType;
+
+extern PyTypeObject TimeWindowRollingMedianType;
+
+extern PyTypeObject WeightedRollingMedianType;
+
+extern char rolling_median_columns_docs[];
+
+PyObject *rolling_median_columns(PyObject *module, PyObject *args, PyObject *kwargs);
+
+extern char median_filter_2d_docs[];
+
+PyObject *median_filter_2d(PyObject *module, PyObject *args, PyObject *kwargs);
+
+extern char hampel_filter_docs[];
+
+PyObject *hampel_filter(PyObject *module, PyObject *args, PyObject *kwargs);
+
+extern char weighted_rolling_median_docs[];
+
+PyObject *weighted_rolling_median(PyObject *module, PyObject *args, PyObject *kwargs);
+
+#endif
@@ -869,6 +869,174 @@ SkipList_index(SkipList *self, PyObject *arg) {
     return ret_val;
 }
 
+/******* Implementation of floor(), ceiling() and nearest() ********/
+
+/** The query made by floor(), ceiling() or nearest(). */
+enum BoundQuery {
+    BOUND_FLOOR, BOUND_CEILING, BOUND_NEAREST
+};
+
+/**
+ * Make the query on a HeadNode. nearest() is only available for arithmetic types, for others this returns empty but
+ * the caller raises a TypeError before getting here.
+ */
+template <typename T, typename Compare>
+static std::optional<T>
+bound_query(const OrderedStructs::SkipList::HeadNode<T, Compare> *pSl, const T &value, BoundQuery query) {
+    switch (query) {
+        case BOUND_FLOOR:
+            return pSl->floor(value);
+        case BOUND_CEILING:
+            return pSl->ceiling(value);
+        case BOUND_NEAREST:
+            if constexpr (std::is_arithmetic<T>::value) {
+                return pSl->nearest(value);
+            }
+            break;
+    }
+    return std::nullopt;
+}
+
+/**
+ * Returns the result of floor(), ceiling() or nearest() for native Python objects, Py_None if there is no such value,
+ * or NULL on failure (such a failed comparison between types).
+ * As this calls into arbitrary Python code the GIL has to be claimed for the duration of this function.
+ */
+static PyObject *
+bound_query_object(SkipList *self, PyObject *arg, BoundQuery query) {
+    PyObject * ret_val = NULL;
+    AcquireLock _lock(self);
+
+    assert(self->_data_type == TYPE_OBJECT);
+    try {
+        std::optional<TYPE_TYPE_OBJECT> result = bound_query(self->pSl_object, arg, query);
+        ret_val = result ? *result : Py_None;
+        Py_INCREF(ret_val);
+    } catch (std::invalid_argument &err) {
+        // Thrown if PyObject_RichCompareBool returns -1
+        // A TypeError should be set
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError, err.what());
+        }
+    }
+    return ret_val;
+}
+
+/**
+ * Returns the result of floor(), ceiling() or nearest(), None if there is no such value, or NULL on failure.
+ * nearest() needs a SkipList of int or float and raises a TypeError otherwise.
+ */
+static PyObject *
+SkipList_bound_query(SkipList *self, PyObject *arg, BoundQuery query, const char *name) {
+    PyObject * ret_val = NULL;
+
+    assert(self && self->pSl_void);
+    ASSERT_TYPE_IN_RANGE;
+    assert(!PyErr_Occurred());
+
+    if (query == BOUND_NEAREST && self->_data_type != TYPE_LONG && self->_data_type != TYPE_DOUBLE) {
+        PyErr_Format(PyExc_TypeError, "%s() needs a SkipList of int or float", name);
+        return NULL;
+    }
+    Py_INCREF(arg);
+    switch (self->_data_type) {
+        case TYPE_LONG: {
+            if (!PyLong_Check(arg)) {
+                PyErr_Format(PyExc_TypeError,
+                             "Argument to %s() must be long not \"%s\" type",
+                             name, Py_TYPE(arg)->tp_name);
+                goto except;
+            }
+            TYPE_TYPE_LONG value = PyLong_AsLongLong(arg);
+            if (value == -1 && PyErr_Occurred()) {
+                goto except;
+            }
+            std::optional<TYPE_TYPE_LONG> result = bound_query(self->pSl_long, value, query);
+            if (result) {
+                ret_val = PyLong_FromLongLong(*result);
+            } else {
+                ret_val = Py_None;
+                Py_INCREF(ret_val);
+            }
+        }
+            break;
+        case TYPE_DOUBLE: {
+            if (!PyFloat_Check(arg)) {
+                PyErr_Format(PyExc_TypeError,
+                             "Argument to %s() must be float not \"%s\" type",
+                             name, Py_TYPE(arg)->tp_name);
+                goto except;
+            }
+            std::optional<TYPE_TYPE_DOUBLE> result;
+            try {
+                result = bound_query(self->pSl_double, PyFloat_AS_DOUBLE(arg), query);
+            } catch (OrderedStructs::SkipList::FailedComparison &err) {
+                /* This will happen if arg is a NaN. */
+                PyErr_Format(PyExc_ValueError, "Can not %s() a NaN with error \"%s\"", name, err.message().c_str());
+                goto except;
+            }
+            if (result) {
+                ret_val = PyFloat_FromDouble(*result);
+            } else {
+                ret_val = Py_None;
+                Py_INCREF(ret_val);
+            }
+        }
+            break;
+        case TYPE_BYTES: {
+            if (!PyBytes_Check(arg)) {
+                PyErr_Format(PyExc_TypeError,
+                             "Argument to %s() must be bytes not \"%s\" type",
+                             name, Py_TYPE(arg)->tp_name);
+                goto except;
+            }
+            std::optional<TYPE_TYPE_BYTES> result = bound_query(self->pSl_bytes, bytes_as_std_string(arg), query);
+            if (result) {
+                ret_val = std_string_as_bytes(*result);
+            } else {
+                ret_val = Py_None;
+                Py_INCREF(ret_val);
+            }
+        }
+            break;
+        case TYPE_OBJECT:
+            ret_val = bound_query_object(self, arg, query);
+            if (!ret_val) {
+                goto except;
+            }
+            break;
+        default:
+            PyErr_BadInternalCall();
+            goto except;
+            break;
+    }
+    assert(!PyErr_Occurred());
+    assert(ret_val);
+    goto finally;
+    except:
+    assert(PyErr_Occurred());
+    Py_XDECREF(ret_val);
+    ret_val = NULL;
+    finally:
+    Py_DECREF(arg);
+    return ret_val;
+}
+
+static PyObject *
+SkipList_floor(SkipList *self, PyObject *arg) {
+    return SkipList_bound_query(self, arg, BOUND_FLOOR, "floor");
+}
+
+static PyObject *
+SkipList_ceiling(SkipList *self, PyObject *arg) {
+    return SkipList_bound_query(self, arg, BOUND_CEILING, "ceiling");
+}
+
+static PyObject *
+SkipList_nearest(SkipList *self, PyObject *arg) {
+    return SkipList_bound_query(self, arg, BOUND_NEAREST, "nearest");
+}
+
 /* Used by tp_as_sequence to implement len() support. */
 Py_ssize_t SkipList_length(PyObject * self) {
     Py_ssize_t ret_val = 0;
@@ -937,11 +1105,15 @@ SkipList_height(SkipList *self) {
     return ret_val;
 }
 
-static PyObject *
-SkipList_insert(SkipList *self, PyObject *arg) {
+/**
+ * Insert the value and return the index where it landed or -1 with an exception set on failure.
+ */
+static Py_ssize_t
+insert_with_rank(SkipList *self, PyObject *arg) {
     assert(self && self->pSl_void);
     ASSERT_TYPE_IN_RANGE;
     assert(!PyErr_Occurred());
+    size_t rank = 0;
 
     switch (self->_data_type) {
         case TYPE_LONG:
@@ -949,11 +1121,11 @@ SkipList_insert(SkipList *self, PyObject *arg) {
                 PyErr_Format(PyExc_TypeError,
                              "Type must be long not \"%s\" type",
                              Py_TYPE(arg)->tp_name);
-                return NULL;
+                return -1;
             }
-            self->pSl_long->insert(PyLong_AsLongLong(arg));
+            rank = self->pSl_long->insert_with_rank(PyLong_AsLongLong(arg));
             if (PyErr_Occurred()) {
-                return NULL;
+                return -1;
             }
             break;
         case TYPE_DOUBLE:
@@ -961,14 +1133,14 @@ SkipList_insert(SkipList *self, PyObject *arg) {
                 PyErr_Format(PyExc_TypeError,
                              "Type must be float not \"%s\" type",
                              Py_TYPE(arg)->tp_name);
-                return NULL;
+                return -1;
             }
             try {
-                self->pSl_double->insert(PyFloat_AS_DOUBLE(arg));
+                rank = self->pSl_double->insert_with_rank(PyFloat_AS_DOUBLE(arg));
             } catch (OrderedStructs::SkipList::FailedComparison &err) {
                 /* This will happen if arg is a NaN. */
                 PyErr_Format(PyExc_ValueError, "Can not insert a NaN with error \"%s\"", err.message().c_str());
-                return NULL;
+                return -1;
             }
             break;
         case TYPE_BYTES:
@@ -976,33 +1148,54 @@ SkipList_insert(SkipList *self, PyObject *arg) {
                 PyErr_Format(PyExc_TypeError,
                              "Type must be bytes not \"%s\" type",
                              Py_TYPE(arg)->tp_name);
-                return NULL;
+                return -1;
             }
-            self->pSl_bytes->insert(bytes_as_std_string(arg));
+            rank = self->pSl_bytes->insert_with_rank(bytes_as_std_string(arg));
             break;
         case TYPE_OBJECT:
             Py_INCREF(arg);
             {
                 AcquireLock _lock(self);
                 try {
-                    self->pSl_object->insert(arg);
+                    rank = self->pSl_object->insert_with_rank(arg);
                 } catch (std::invalid_argument &err) {
                     // Thrown if PyObject_RichCompareBool returns -1
                     // A TypeError should be set
                     if (!PyErr_Occurred()) {
                         PyErr_SetString(PyExc_TypeError, err.what());
                     }
-                    return NULL;
+                    return -1;
                 }
             }
             break;
         default:
             PyErr_BadInternalCall();
-            break;
+            return -1;
+    }
+    return static_cast<Py_ssize_t>(rank);
+}
+
+static PyObject *
+SkipList_insert(SkipList *self, PyObject *arg) {
+    if (insert_with_rank(self, arg) < 0) {
+        return NULL;
     }
     Py_RETURN_NONE;
 }
 
+/**
+ * Insert the value and return the index where it landed. This is a single descent so is cheaper than insert() followed
+ * by index() and, with duplicate values, it is the index of the value just inserted rather than of the first equal one.
+ */
+static PyObject *
+SkipList_insert_with_rank(SkipList *self, PyObject *arg) {
+    Py_ssize_t rank = insert_with_rank(self, arg);
+    if (rank < 0) {
+        return NULL;
+    }
+    return PyLong_FromSsize_t(rank);
+}
+
 /******* Type specific implementations of remove() ********/
 static PyObject *
 remove_long(SkipList *self, PyObject *arg) {
@@ -1359,6 +1552,77 @@ SkipList_size_of(SkipList *self) {
     return ret_val;
 }
 
+/**
+ * Create a copy of the Skip List with HeadNode::clone().
+ * This copies the structure in one pass so is O(n) rather than the O(n log(n)) of inserting every value into a new
+ * Skip List. For Python objects this is a shallow copy, the copy has new references to the same objects.
+ *
+ * @param self The CPython Skip List.
+ * @return The new CPython Skip List, NULL on failure.
+ */
+static PyObject *
+SkipList_copy(SkipList *self) {
+    SkipList *ret_val = NULL;
+
+    assert(self && self->pSl_void);
+    ASSERT_TYPE_IN_RANGE;
+    assert(!PyErr_Occurred());
+
+    ret_val = (SkipList *) SkipList_new(Py_TYPE(self), NULL, NULL);
+    if (!ret_val) {
+        return NULL;
+    }
+#ifdef WITH_THREAD
+    ret_val->lock = PyThread_allocate_lock();
+    if (ret_val->lock == NULL) {
+        PyErr_SetString(PyExc_MemoryError, "Unable to allocate thread lock.");
+        goto except;
+    }
+#endif
+    try {
+        switch (self->_data_type) {
+            case TYPE_LONG:
+                ret_val->pSl_long = self->pSl_long->clone().release();
+                break;
+            case TYPE_DOUBLE:
+                ret_val->pSl_double = self->pSl_double->clone().release();
+                break;
+            case TYPE_BYTES:
+                ret_val->pSl_bytes = self->pSl_bytes->clone().release();
+                break;
+            case TYPE_OBJECT: {
+                AcquireLock _lock(self);
+                auto pSl_object = self->pSl_object->clone();
+                std::vector<TYPE_TYPE_OBJECT> values;
+                if (pSl_object->size()) {
+                    pSl_object->at(0, pSl_object->size(), values);
+                }
+                // The copy owns a reference to each value, these are released by decref_all_contents().
+                for (PyObject *value: values) {
+                    Py_INCREF(value);
+                }
+                ret_val->pSl_object = pSl_object.release();
+            }
+                break;
+            default:
+                PyErr_BadInternalCall();
+                break;
+        }
+    } catch (std::bad_alloc &err) {
+        PyErr_NoMemory();
+    }
+    if (PyErr_Occurred()) {
+        goto except;
+    }
+    ret_val->_data_type = self->_data_type;
+    assert(!PyErr_Occurred());
+    return (PyObject *) ret_val;
+except:
+    assert(PyErr_Occurred());
+    Py_DECREF(ret_val);
+    return NULL;
+}
+
 static PyMethodDef SkipList_methods[] = {
         {"has", (PyCFunction) SkipList_has, METH_O,
          "Return True if the value is in the skip list, False otherwise."
@@ -1373,6 +1637,16 @@ static PyMethodDef SkipList_methods[] = {
          "Return the index of the given value."
          " Will raise a ValueError if not found."
         },
+        {"floor", (PyCFunction) SkipList_floor, METH_O,
+         "Return the largest value <= the given value or None if there is none."
+        },
+        {"ceiling", (PyCFunction) SkipList_ceiling, METH_O,
+         "Return the smallest value >= the given value or None if there is none."
+        },
+        {"nearest", (PyCFunction) SkipList_nearest, METH_O,
+         "Return the value closest to the given value, the smaller if two are equally close, or None if empty."
+         " Only for a SkipList of int or float."
+        },
         /* __len__ is an alias to this. */
         {"size", (PyCFunction) SkipList_size, METH_NOARGS,
          "Return the number of elements in the skip list."
@@ -1387,9 +1661,19 @@ static PyMethodDef SkipList_methods[] = {
         {"insert", (PyCFunction) SkipList_insert, METH_O,
          "Insert the value into the skip list."
         },
+        {"insert_with_rank", (PyCFunction) SkipList_insert_with_rank, METH_O,
+         "Insert the value into the skip list and return the index where it landed."
+        },
         {"remove", (PyCFunction) SkipList_remove, METH_O,
          "Remove the value from the skip list."
         },
+        {"copy", (PyCFunction) SkipList_copy, METH_NOARGS,
+         "Return a shallow copy of the skip list in O(n) time."
+        },
+        /* copy.copy() uses this. */
+        {"__copy__", (PyCFunction) SkipList_copy, METH_NOARGS,
+         "Return a shallow copy of the skip list in O(n) time."
+        },
 #ifdef INCLUDE_METHODS_THAT_USE_STREAMS
         {"dot_file", (PyCFunction) SkipList_dot_file, METH_NOARGS,
          "Returns a bytes object suitable for Graphviz processing of the"
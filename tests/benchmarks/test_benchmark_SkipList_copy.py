@@ -0,0 +1,55 @@
+"""
+Benchmark tests for copying a Skip List with copy(), which is O(n), against rebuilding it by inserting every value
+into a new Skip List, which is O(n log(n)).
+Typical usage:
+
+pytest tests/benchmarks/test_benchmark_SkipList_copy.py --runslow --benchmark-sort=name --benchmark-autosave --benchmark-histogram -v
+"""
+import random
+import typing
+
+import pytest
+
+import orderedstructs
+
+# Make formatted strings so that the test name sorts nicely.
+SKIPLIST_LENGTHS = tuple(f'{2 ** i:8d}' for i in range(10, 21, 2))
+
+
+def _setup_skiplist(typ: typing.Type, n: int) -> orderedstructs.SkipList:
+    """Returns a skiplist of length n with the values inserted in a random order."""
+    values = [typ(v) for v in range(n)]
+    random.Random(1).shuffle(values)
+    sl = orderedstructs.SkipList(typ)
+    for value in values:
+        sl.insert(value)
+    return sl
+
+
+def _copy(skip_list: orderedstructs.SkipList) -> orderedstructs.SkipList:
+    return skip_list.copy()
+
+
+def _rebuild(skip_list: orderedstructs.SkipList, typ: typing.Type) -> orderedstructs.SkipList:
+    result = orderedstructs.SkipList(typ)
+    for value in skip_list.at_seq(0, skip_list.size()):
+        result.insert(value)
+    return result
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('typ', (int, float))
+@pytest.mark.parametrize('length', SKIPLIST_LENGTHS)
+def test_copy(benchmark, typ, length):
+    skip_list = _setup_skiplist(typ, int(length))
+    result = benchmark(_copy, skip_list)
+    assert result.size() == int(length)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('typ', (int, float))
+@pytest.mark.parametrize('length', SKIPLIST_LENGTHS)
+def test_rebuild(benchmark, typ, length):
+    skip_list = _setup_skiplist(typ, int(length))
+    result = benchmark(_rebuild, skip_list, typ)
+    assert result.size() == int(length)
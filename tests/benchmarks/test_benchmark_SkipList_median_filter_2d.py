@@ -0,0 +1,54 @@
+"""
+Benchmark tests for the multi-threaded 2D median filter of an image.
+Compare with the numpy median of every window and the column wise rolling median approximation.
+Typical usage:
+
+pytest tests/benchmarks/test_benchmark_SkipList_median_filter_2d.py --runslow --benchmark-sort=name --benchmark-autosave --benchmark-histogram -v
+"""
+import numpy as np
+
+import pytest
+
+import orderedstructs
+
+IMAGE_SIZE = 1024
+
+
+def _create_arrays(dtype, kernel_size: int) -> tuple[np.ndarray, np.ndarray]:
+    if dtype == np.float64:
+        read_array = np.random.random((IMAGE_SIZE, IMAGE_SIZE))
+    else:
+        read_array = np.random.randint(0, np.iinfo(dtype).max + 1, size=(IMAGE_SIZE, IMAGE_SIZE)).astype(dtype)
+    write_array = np.empty((IMAGE_SIZE - kernel_size + 1, IMAGE_SIZE - kernel_size + 1), dtype=dtype)
+    return read_array, write_array
+
+
+def _test_numpy_median_filter_2d(read_array: np.ndarray, kernel_size: int) -> None:
+    """Baseline, the numpy median of every window."""
+    windows = np.lib.stride_tricks.sliding_window_view(read_array, (kernel_size, kernel_size))
+    np.median(windows, axis=(-2, -1))
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('kernel_size', (3, 5, 9,))
+def test_numpy_median_filter_2d(benchmark, kernel_size):
+    read_array, _write_array = _create_arrays(np.float64, kernel_size)
+    benchmark(_test_numpy_median_filter_2d, read_array, kernel_size)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('kernel_size', (3, 5, 9,))
+def test_rolling_median_columns_approximation(benchmark, kernel_size):
+    """The column wise rolling median that the 2D median filter replaces."""
+    read_array, _write_array = _create_arrays(np.float64, kernel_size)
+    write_array = np.empty((IMAGE_SIZE - kernel_size + 1, IMAGE_SIZE))
+    benchmark(orderedstructs.rolling_median_columns, read_array, write_array, kernel_size)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('dtype', (np.uint8, np.uint16, np.float64,))
+@pytest.mark.parametrize('kernel_size', (3, 5, 9, 15,))
+@pytest.mark.parametrize('thread_count', (1, 4,))
+def test_median_filter_2d(benchmark, dtype, kernel_size, thread_count):
+    read_array, write_array = _create_arrays(dtype, kernel_size)
+    benchmark(orderedstructs.median_filter_2d, read_array, write_array, kernel_size, thread_count=thread_count)
@@ -0,0 +1,69 @@
+"""
+Benchmark tests for the multi-threaded rolling median of the columns of a 2D array.
+Compare with test_benchmark_SkipList_rolling_median_sh_mem.py that uses multiprocessing and shared memory.
+Typical usage:
+
+pytest tests/benchmarks/test_benchmark_SkipList_rolling_median_columns.py --runslow --benchmark-sort=name --benchmark-autosave --benchmark-histogram -v
+"""
+import numpy as np
+
+import pytest
+
+import orderedstructs
+
+WINDOW_LENGTH = 21
+
+
+def _test_rolling_median_columns(read_array: np.ndarray, write_array: np.ndarray, thread_count: int) -> None:
+    orderedstructs.rolling_median_columns(read_array, write_array, WINDOW_LENGTH, thread_count=thread_count)
+
+
+def _test_rolling_median_column_by_column(read_array: np.ndarray, write_array: np.ndarray) -> None:
+    """Baseline, a Python loop over the columns each using a RollingMedian."""
+    for column in range(read_array.shape[1]):
+        rolling_median = orderedstructs.RollingMedian(WINDOW_LENGTH)
+        for row in range(read_array.shape[0]):
+            median = rolling_median.push(float(read_array[row, column]))
+            if row >= WINDOW_LENGTH - 1:
+                write_array[row - WINDOW_LENGTH + 1, column] = median
+
+
+def _create_arrays(rows: int, columns: int) -> tuple[np.ndarray, np.ndarray]:
+    read_array = np.random.random((rows, columns))
+    write_array = np.empty((rows - WINDOW_LENGTH + 1, columns))
+    return read_array, write_array
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize(
+    'rows, columns',
+    (
+            (1024 * 64, 16,),
+            (1024, 1024,),
+            (64, 16384,),
+    )
+)
+def test_rolling_median_column_by_column(benchmark, rows, columns):
+    read_array, write_array = _create_arrays(rows, columns)
+    benchmark(_test_rolling_median_column_by_column, read_array, write_array)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('thread_count', (1, 2, 4, 8, 16,))
+def test_rolling_median_columns_8388608_16(benchmark, thread_count):
+    read_array, write_array = _create_arrays(1024 * 1024 * 8, 16)
+    benchmark(_test_rolling_median_columns, read_array, write_array, thread_count)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('thread_count', (1, 2, 4, 8, 16,))
+def test_rolling_median_columns_131072_1024(benchmark, thread_count):
+    read_array, write_array = _create_arrays(1024 * 128, 1024)
+    benchmark(_test_rolling_median_columns, read_array, write_array, thread_count)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('thread_count', (1, 2, 4, 8, 16,))
+def test_rolling_median_columns_2048_65536(benchmark, thread_count):
+    read_array, write_array = _create_arrays(1024 * 2, 65536)
+    benchmark(_test_rolling_median_columns, read_array, write_array, thread_count)
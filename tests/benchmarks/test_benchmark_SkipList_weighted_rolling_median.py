@@ -0,0 +1,74 @@
+"""
+Benchmark tests for the rolling weighted median, such as a volume weighted median price, of 1m samples.
+Compare with a numpy reference that sorts every window.
+Typical usage:
+
+pytest tests/benchmarks/test_benchmark_SkipList_weighted_rolling_median.py --runslow --benchmark-sort=name --benchmark-autosave --benchmark-histogram -v
+"""
+import numpy as np
+
+import pytest
+
+import orderedstructs
+
+LENGTH = 1000 ** 2
+# The numpy reference sorts this many windows at a time to bound the memory used.
+NUMPY_CHUNK = 10_000
+
+
+def _create_arrays(window_length: int) -> tuple[np.ndarray, np.ndarray, np.ndarray]:
+    rng = np.random.default_rng(1)
+    prices = 100.0 + rng.normal(0.0, 1.0, LENGTH)
+    volumes = rng.integers(1, 1000, LENGTH).astype(np.float64)
+    dest = np.empty(LENGTH - window_length + 1)
+    return prices, volumes, dest
+
+
+def _numpy_weighted_rolling_median(prices: np.ndarray, volumes: np.ndarray, dest: np.ndarray,
+                                   window_length: int) -> None:
+    """Baseline, sort each window then search the cumulative weights for half the total."""
+    price_windows = np.lib.stride_tricks.sliding_window_view(prices, window_length)
+    volume_windows = np.lib.stride_tricks.sliding_window_view(volumes, window_length)
+    for begin in range(0, len(dest), NUMPY_CHUNK):
+        end = min(begin + NUMPY_CHUNK, len(dest))
+        order = np.argsort(price_windows[begin:end], axis=1)
+        sorted_prices = np.take_along_axis(price_windows[begin:end], order, axis=1)
+        cumulative = np.cumsum(np.take_along_axis(volume_windows[begin:end], order, axis=1), axis=1)
+        index = np.argmax(cumulative >= cumulative[:, -1:] / 2, axis=1)
+        dest[begin:end] = sorted_prices[np.arange(end - begin), index]
+
+
+def _streaming_weighted_rolling_median(prices: np.ndarray, volumes: np.ndarray, window_length: int) -> None:
+    rm = orderedstructs.WeightedRollingMedian(window_length)
+    for price, volume in zip(prices.tolist(), volumes.tolist()):
+        rm.push(price, volume)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('window_length', (11, 101, 1001,))
+def test_numpy_weighted_rolling_median(benchmark, window_length):
+    prices, volumes, dest = _create_arrays(window_length)
+    benchmark(_numpy_weighted_rolling_median, prices, volumes, dest, window_length)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('window_length', (11, 101, 1001, 10001,))
+def test_weighted_rolling_median(benchmark, window_length):
+    prices, volumes, dest = _create_arrays(window_length)
+    benchmark(orderedstructs.weighted_rolling_median, prices, volumes, dest, window_length)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('window_length', (11, 101, 1001,))
+def test_streaming_weighted_rolling_median(benchmark, window_length):
+    prices, volumes, _dest = _create_arrays(window_length)
+    benchmark(_streaming_weighted_rolling_median, prices, volumes, window_length)
+
+
+@pytest.mark.slow
+def test_weighted_rolling_median_matches_numpy():
+    prices, volumes, dest = _create_arrays(101)
+    expected = np.empty_like(dest)
+    orderedstructs.weighted_rolling_median(prices, volumes, dest, 101)
+    _numpy_weighted_rolling_median(prices, volumes, expected, 101)
+    assert np.array_equal(dest, expected)
@@ -1,3 +1,4 @@
+import copy
 import itertools
 import math
 import sys
@@ -741,6 +742,149 @@ def test_integer___sizeof__():
         prev_size_of = sys.getsizeof(sl)
 
 
+@pytest.mark.parametrize('typ, seq',
+                         ((int_type, (8, 4, 4, 2, 16, 1)), (float, (8.0, 4.0, 4.0, 2.0, 16.0, 1.0)),
+                          (bytes, (b'8', b'4', b'4', b'2', b'16', b'1')),))
+@pytest.mark.parametrize('copier', (lambda sl: sl.copy(), copy.copy))
+def test_copy(typ, seq, copier):
+    sl = orderedstructs.SkipList(typ)
+    for value in seq:
+        sl.insert(value)
+    sl_copy = copier(sl)
+    assert type(sl_copy) is orderedstructs.SkipList
+    assert sl_copy.lacks_integrity() == 0
+    assert sl_copy.size() == sl.size()
+    assert sl_copy.height() == sl.height()
+    for i in range(sl.size()):
+        assert sl_copy.at(i) == sl.at(i)
+        assert sl_copy.node_height(i) == sl.node_height(i)
+        for level in range(sl.node_height(i)):
+            assert sl_copy.node_width(i, level) == sl.node_width(i, level)
+    # The copy is independent of the original.
+    sl_copy.remove(seq[0])
+    assert sl_copy.size() == len(seq) - 1
+    assert sl.size() == len(seq)
+    del sl
+    assert sl_copy.lacks_integrity() == 0
+    assert sl_copy.at_seq(0, sl_copy.size()) == tuple(sorted(seq[1:]))
+
+
+@pytest.mark.parametrize('typ', [int_type, float, bytes])
+def test_copy_empty(typ):
+    sl_copy = orderedstructs.SkipList(typ).copy()
+    assert sl_copy.size() == 0
+    assert sl_copy.lacks_integrity() == 0
+
+
+@pytest.mark.parametrize('typ, seq',
+                         ((int_type, (8, 4, 4, 2, 16, 1, 8)), (float, (8.0, 4.0, 4.0, 2.0, 16.0, 1.0, 8.0)),
+                          (bytes, (b'8', b'4', b'4', b'2', b'16', b'1', b'8')),))
+def test_insert_with_rank(typ, seq):
+    sl = orderedstructs.SkipList(typ)
+    inserted = []
+    for value in seq:
+        rank = sl.insert_with_rank(value)
+        # Equal values go after the existing ones.
+        assert rank == len([v for v in inserted if v <= value])
+        inserted.append(value)
+        assert sl.at(rank) == value
+    assert sl.lacks_integrity() == 0
+    assert sl.at_seq(0, sl.size()) == tuple(sorted(seq))
+
+
+@pytest.mark.parametrize('typ, value', ((int_type, 1.0), (float, 1), (bytes, 1.0),))
+def test_insert_with_rank_fails_type(typ, value):
+    sl = orderedstructs.SkipList(typ)
+    with pytest.raises(TypeError):
+        sl.insert_with_rank(value)
+    assert sl.size() == 0
+
+
+def test_insert_with_rank_fails_nan():
+    sl = orderedstructs.SkipList(float)
+    with pytest.raises(ValueError):
+        sl.insert_with_rank(math.nan)
+    assert sl.size() == 0
+
+
+@pytest.mark.parametrize('typ, seq, query, floor, ceiling',
+                         (
+                                 (int_type, (2, 4, 4, 8), 1, None, 2),
+                                 (int_type, (2, 4, 4, 8), 4, 4, 4),
+                                 (int_type, (2, 4, 4, 8), 5, 4, 8),
+                                 (int_type, (2, 4, 4, 8), 9, 8, None),
+                                 (float, (2.0, 4.0, 4.0, 8.0), 1.5, None, 2.0),
+                                 (float, (2.0, 4.0, 4.0, 8.0), 4.0, 4.0, 4.0),
+                                 (float, (2.0, 4.0, 4.0, 8.0), 4.5, 4.0, 8.0),
+                                 (float, (2.0, 4.0, 4.0, 8.0), 8.5, 8.0, None),
+                                 (bytes, (b'b', b'd', b'd', b'h'), b'a', None, b'b'),
+                                 (bytes, (b'b', b'd', b'd', b'h'), b'd', b'd', b'd'),
+                                 (bytes, (b'b', b'd', b'd', b'h'), b'e', b'd', b'h'),
+                                 (bytes, (b'b', b'd', b'd', b'h'), b'i', b'h', None),
+                         ))
+def test_floor_ceiling(typ, seq, query, floor, ceiling):
+    sl = orderedstructs.SkipList(typ)
+    for value in seq:
+        sl.insert(value)
+    assert sl.floor(query) == floor
+    assert sl.ceiling(query) == ceiling
+
+
+@pytest.mark.parametrize('typ, seq, query, expected',
+                         (
+                                 (int_type, (2, 4, 8), 1, 2),
+                                 (int_type, (2, 4, 8), 5, 4),
+                                 # Equally close, the smaller is returned.
+                                 (int_type, (2, 4, 8), 6, 4),
+                                 (int_type, (2, 4, 8), 7, 8),
+                                 (int_type, (2, 4, 8), 9, 8),
+                                 (int_type, (-(1 << 63), (1 << 63) - 1), -1, -(1 << 63)),
+                                 (int_type, (-(1 << 63), (1 << 63) - 1), 1, (1 << 63) - 1),
+                                 (float, (2.0, 4.0, 8.0), 5.5, 4.0),
+                                 (float, (2.0, 4.0, 8.0), 6.0, 4.0),
+                                 (float, (2.0, 4.0, 8.0), 6.5, 8.0),
+                                 (float, (2.0, 4.0, 8.0), -math.inf, 2.0),
+                         ))
+def test_nearest(typ, seq, query, expected):
+    sl = orderedstructs.SkipList(typ)
+    for value in seq:
+        sl.insert(value)
+    assert sl.nearest(query) == expected
+
+
+@pytest.mark.parametrize('typ, value', ((int_type, 1), (float, 1.0), (bytes, b'1'),))
+def test_floor_ceiling_nearest_empty(typ, value):
+    sl = orderedstructs.SkipList(typ)
+    assert sl.floor(value) is None
+    assert sl.ceiling(value) is None
+    if typ is not bytes:
+        assert sl.nearest(value) is None
+
+
+@pytest.mark.parametrize('method', ('floor', 'ceiling', 'nearest',))
+@pytest.mark.parametrize('typ, value', ((int_type, 1.0), (float, 1), (bytes, 1.0),))
+def test_floor_ceiling_nearest_fails_type(method, typ, value):
+    sl = orderedstructs.SkipList(typ)
+    with pytest.raises(TypeError):
+        getattr(sl, method)(value)
+
+
+def test_nearest_fails_bytes():
+    sl = orderedstructs.SkipList(bytes)
+    sl.insert(b'a')
+    with pytest.raises(TypeError) as err:
+        sl.nearest(b'a')
+    assert err.value.args[0] == 'nearest() needs a SkipList of int or float'
+
+
+@pytest.mark.parametrize('method', ('floor', 'ceiling', 'nearest',))
+def test_floor_ceiling_nearest_fails_nan(method):
+    sl = orderedstructs.SkipList(float)
+    sl.insert(1.0)
+    with pytest.raises(ValueError):
+        getattr(sl, method)(math.nan)
+
+
 def test_dot_file():
     sl = orderedstructs.SkipList(float)
     sl.insert(42.0)
@@ -1,4 +1,5 @@
 """Some specific PyObject* tests"""
+import copy
 import sys
 
 import psutil
@@ -104,8 +105,61 @@ def test_ordered_refcount_at(cls):
     assert sys.getrefcount(obj) == rc + 2
 
 
+@pytest.mark.parametrize('cls', [TotalOrdered, OrderedLt])
+def test_ordered_refcount_copy(cls):
+    """Reference count is incremented by copy() and restored when the copy is deleted."""
+    sl = orderedstructs.SkipList(object)
+    obj = cls(0)
+    rc = sys.getrefcount(obj)
+    sl.insert(obj)
+    sl_copy = sl.copy()
+    assert sys.getrefcount(obj) == rc + 2
+    assert id(sl_copy.at(0)) == id(obj)
+    del sl_copy
+    assert sys.getrefcount(obj) == rc + 1
+    del sl
+    assert sys.getrefcount(obj) == rc
+
+
 # ---- END: Refcount tests -------
 
+@pytest.mark.parametrize('cls', [TotalOrdered, OrderedLt])
+def test_ordered_insert_with_rank(cls):
+    sl = orderedstructs.SkipList(object)
+    obj = cls(4)
+    rc = sys.getrefcount(obj)
+    assert sl.insert_with_rank(obj) == 0
+    assert sys.getrefcount(obj) == rc + 1
+    assert sl.insert_with_rank(cls(8)) == 1
+    assert sl.insert_with_rank(cls(0)) == 0
+    assert sl.insert_with_rank(cls(4)) == 2
+    assert id(sl.at(1)) == id(obj)
+    assert sl.lacks_integrity() == 0
+    del sl
+    assert sys.getrefcount(obj) == rc
+
+
+@pytest.mark.parametrize('cls', [TotalOrdered, OrderedLt])
+def test_ordered_floor_ceiling(cls):
+    sl = orderedstructs.SkipList(object)
+    assert sl.floor(cls(4)) is None
+    assert sl.ceiling(cls(4)) is None
+    obj = cls(4)
+    rc = sys.getrefcount(obj)
+    sl.insert(cls(2))
+    sl.insert(obj)
+    sl.insert(cls(8))
+    assert id(sl.floor(cls(5))) == id(obj)
+    assert id(sl.ceiling(cls(3))) == id(obj)
+    assert sl.floor(cls(1)) is None
+    assert sl.ceiling(cls(9)) is None
+    assert sys.getrefcount(obj) == rc + 1
+    with pytest.raises(TypeError):
+        sl.nearest(cls(4))
+    del sl
+    assert sys.getrefcount(obj) == rc
+
+
 @pytest.mark.parametrize('cls', [TotalOrdered, OrderedLt])
 def test_ordered_insert(cls):
     sl = orderedstructs.SkipList(object)
@@ -244,6 +298,22 @@ def test_fails_with_no_comparison(obj0, obj1, method):
         getattr(sl, method)(obj1)
 
 
+def test_insert_fails_with_no_comparison_does_not_leak():
+    """A failed comparison during insert() must not leak the node that was made for the value."""
+    count = 1024 * 512
+    sl = orderedstructs.SkipList(object)
+    sl.insert(object())
+    proc = psutil.Process()
+    rss_start = proc.memory_info().rss
+    for _i in range(count):
+        with pytest.raises(TypeError):
+            sl.insert(1j)
+    rss_end = proc.memory_info().rss
+    assert sl.size() == 1
+    # A leaked node is around 100 bytes so this would be around 50MB.
+    assert rss_end - rss_start < 10e6, f'RSS change {rss_end - rss_start:,d}'
+
+
 # ==== Bespoke comparison function fails ====
 
 # ---- Bespoke non-object and comparison function fails ----
@@ -408,6 +478,19 @@ def test_ordered_insert_remove_cmp_reversed(cls):
         assert removed_obj == obj
 
 
+@pytest.mark.parametrize('cls', [TotalOrdered, ])
+def test_ordered_copy_cmp_reversed(cls):
+    """A copy keeps the comparison function."""
+    sl = orderedstructs.SkipList(object, lambda x, y: y < x)
+    for i in range(8):
+        sl.insert(cls(i))
+    sl_copy = copy.copy(sl)
+    del sl
+    sl_copy.insert(cls(4))
+    assert sl_copy.lacks_integrity() == 0
+    assert [sl_copy.at(i) for i in range(sl_copy.size())] == [cls(v) for v in (7, 6, 5, 4, 4, 3, 2, 1, 0)]
+
+
 @pytest.mark.slow
 @pytest.mark.parametrize(
     'cls, size, rounds, expected_getsizeof, maximum_increase_at_empty',
@@ -0,0 +1,91 @@
+import math
+
+import numpy as np
+import pytest
+
+import orderedstructs
+
+
+def hampel_filter_reference(array: np.ndarray, half_width: int, n_sigmas: float) -> tuple[np.ndarray, list[int]]:
+    """Hampel filter using numpy."""
+    result = array.copy()
+    outliers = []
+    for i in range(half_width, len(array) - half_width):
+        window = array[i - half_width:i + half_width + 1]
+        median = np.median(window)
+        mad = np.median(np.abs(window - median))
+        if abs(array[i] - median) > n_sigmas * 1.4826 * mad:
+            result[i] = median
+            outliers.append(i)
+    return result, outliers
+
+
+def _noisy_signal_with_outliers(length: int) -> np.ndarray:
+    rng = np.random.default_rng(1)
+    array = np.sin(np.arange(length) / 10.0) + rng.normal(0.0, 0.05, length)
+    array[rng.integers(0, length, length // 50)] += 5.0
+    return array
+
+
+@pytest.mark.parametrize('half_width', (0, 1, 3, 10, 250, 1000))
+@pytest.mark.parametrize('n_sigmas', (0.0, 2.0, 3.0))
+def test_hampel_filter(half_width, n_sigmas):
+    array = _noisy_signal_with_outliers(500)
+    dest = np.empty_like(array)
+    outliers = orderedstructs.hampel_filter(array, dest, half_width, n_sigmas=n_sigmas)
+    expected, expected_outliers = hampel_filter_reference(array, half_width, n_sigmas)
+    assert outliers == expected_outliers
+    assert np.allclose(dest, expected)
+
+
+def test_hampel_filter_finds_outliers():
+    array = _noisy_signal_with_outliers(1000)
+    dest = np.empty_like(array)
+    outliers = orderedstructs.hampel_filter(array, dest, 5)
+    assert len(outliers) >= 10
+    assert np.max(np.abs(dest)) < 2.0
+
+
+def test_hampel_filter_in_place():
+    array = _noisy_signal_with_outliers(500)
+    expected, expected_outliers = hampel_filter_reference(array, 5, 3.0)
+    outliers = orderedstructs.hampel_filter(array, array, 5)
+    assert outliers == expected_outliers
+    assert np.allclose(array, expected)
+
+
+def test_hampel_filter_strided():
+    array = _noisy_signal_with_outliers(1000)[::3]
+    dest = np.empty((len(array), 2))[:, 1]
+    outliers = orderedstructs.hampel_filter(array, dest, 5)
+    expected, expected_outliers = hampel_filter_reference(array, 5, 3.0)
+    assert outliers == expected_outliers
+    assert np.allclose(dest, expected)
+
+
+@pytest.mark.parametrize(
+    'src, dest, half_width, n_sigmas, expected',
+    (
+            (np.zeros(10), np.zeros(10), -1, 3.0, 'Argument "half_width" must be >= 0 not -1'),
+            (np.zeros(10), np.zeros(10), 2, -3.0, 'Argument "n_sigmas" must be >= 0'),
+            (np.zeros(10), np.zeros(10), 2, math.nan, 'Argument "n_sigmas" must be >= 0'),
+            (np.zeros((10, 2)), np.zeros(10), 2, 3.0, 'Argument "src" must be a 1D array not 2 dimensions'),
+            (np.zeros(10, dtype=np.int32), np.zeros(10), 2, 3.0,
+             'Argument "src" must be an array of doubles not format "i"'),
+            (np.zeros(10), np.zeros(9), 2, 3.0, 'Argument "dest" must have length 10 not 9'),
+            (np.zeros(10)[::-1], np.zeros(10), 2, 3.0,
+             'Argument "src" must have positive strides that are a multiple of the item size.'),
+    )
+)
+def test_hampel_filter_raises(src, dest, half_width, n_sigmas, expected):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.hampel_filter(src, dest, half_width, n_sigmas)
+    assert err.value.args[0] == expected
+
+
+def test_hampel_filter_nan_raises():
+    array = np.zeros(10)
+    array[5] = math.nan
+    with pytest.raises(ValueError) as err:
+        orderedstructs.hampel_filter(array, np.zeros(10), 2)
+    assert err.value.args[0] == 'Can not compute the Hampel filter of an array containing a NaN.'
@@ -0,0 +1,87 @@
+import math
+
+import numpy as np
+import pytest
+
+import orderedstructs
+
+
+def median_filter_2d_reference(array: np.ndarray, kernel_size: int) -> np.ndarray:
+    """2D median filter, 'valid' mode, using numpy."""
+    windows = np.lib.stride_tricks.sliding_window_view(array, (kernel_size, kernel_size))
+    return np.median(windows, axis=(-2, -1))
+
+
+@pytest.mark.parametrize('kernel_size', (1, 2, 3, 4, 9, 66))
+@pytest.mark.parametrize('thread_count', (0, 1, 4))
+def test_median_filter_2d_float(kernel_size, thread_count):
+    rng = np.random.default_rng(1)
+    array = rng.random((90, 77))
+    dest = np.empty((array.shape[0] - kernel_size + 1, array.shape[1] - kernel_size + 1))
+    result = orderedstructs.median_filter_2d(array, dest, kernel_size, thread_count=thread_count)
+    assert result is None
+    assert np.allclose(dest, median_filter_2d_reference(array, kernel_size))
+
+
+@pytest.mark.parametrize('dtype, maximum', ((np.uint8, 256), (np.uint16, 4096), (np.uint16, 65536)))
+@pytest.mark.parametrize('kernel_size', (1, 3, 5, 11))
+def test_median_filter_2d_integer(dtype, maximum, kernel_size):
+    rng = np.random.default_rng(1)
+    array = rng.integers(0, maximum, size=(60, 70), dtype=dtype)
+    dest = np.empty((array.shape[0] - kernel_size + 1, array.shape[1] - kernel_size + 1), dtype=dtype)
+    orderedstructs.median_filter_2d(array, dest, kernel_size)
+    assert np.array_equal(dest, median_filter_2d_reference(array, kernel_size).astype(dtype))
+
+
+@pytest.mark.parametrize('order', ('C', 'F'))
+def test_median_filter_2d_order(order):
+    rng = np.random.default_rng(1)
+    array = np.asarray(rng.random((40, 30)), order=order)
+    dest = np.empty((36, 26), order=order)
+    orderedstructs.median_filter_2d(array, dest, 5)
+    assert np.allclose(dest, median_filter_2d_reference(array, 5))
+
+
+def test_median_filter_2d_strided():
+    rng = np.random.default_rng(1)
+    array = rng.integers(0, 256, size=(100, 90), dtype=np.uint8)[::2, ::3]
+    dest = np.empty((array.shape[0] - 2, array.shape[1] - 2), dtype=np.uint8)
+    orderedstructs.median_filter_2d(array, dest, 3)
+    assert np.array_equal(dest, median_filter_2d_reference(array, 3).astype(np.uint8))
+
+
+@pytest.mark.parametrize(
+    'src, dest, kernel_size, expected',
+    (
+            (np.zeros((10, 8)), np.zeros((6, 4)), 0, 'Argument "kernel_size" must be > 0 not 0'),
+            (np.zeros(10), np.zeros(6), 5, 'Argument "src" must be a 2D array not 1 dimensions'),
+            (np.zeros((10, 8), dtype=np.int32), np.zeros((6, 4), dtype=np.int32), 5,
+             'Argument "src" must be an array of doubles, unsigned char or unsigned short not format "i"'),
+            (np.zeros((10, 8), dtype=np.uint8), np.zeros((6, 4)), 5,
+             'Argument "dest" must have the same format as "src" "B" not "d"'),
+            (np.zeros((4, 8)), np.zeros((1, 4)), 5,
+             'Argument "src" has shape (4, 8) which is smaller than the kernel size 5'),
+            (np.zeros((10, 8)), np.zeros((6, 8)), 5, 'Argument "dest" must have shape (6, 4) not (6, 8)'),
+            (np.zeros((10, 8))[::-1], np.zeros((6, 4)), 5,
+             'Argument "src" must have positive strides that are a multiple of the item size.'),
+    )
+)
+def test_median_filter_2d_raises(src, dest, kernel_size, expected):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.median_filter_2d(src, dest, kernel_size)
+    assert err.value.args[0] == expected
+
+
+def test_median_filter_2d_read_only_dest_raises():
+    dest = np.zeros((6, 4))
+    dest.flags.writeable = False
+    with pytest.raises(ValueError):
+        orderedstructs.median_filter_2d(np.zeros((10, 8)), dest, 5)
+
+
+def test_median_filter_2d_nan_raises():
+    array = np.zeros((10, 8))
+    array[5, 2] = math.nan
+    with pytest.raises(ValueError) as err:
+        orderedstructs.median_filter_2d(array, np.zeros((6, 4)), 5, thread_count=2)
+    assert err.value.args[0] == 'Can not compute the median filter of an array containing a NaN.'
@@ -6,7 +6,10 @@ import orderedstructs
 
 
 def test_orderedstructs_dir():
-    assert dir(orderedstructs) == ['SkipList',
+    assert dir(orderedstructs) == ['RollingMedian',
+                                   'SkipList',
+                                   'TimeWindowRollingMedian',
+                                   'WeightedRollingMedian',
                                    '__build_docs__',
                                    '__build_target__',
                                    '__build_time__',
@@ -18,10 +21,14 @@ def test_orderedstructs_dir():
                                    '__package__',
                                    '__spec__',
                                    '__version__',
+                                   'hampel_filter',
                                    'max_long',
+                                   'median_filter_2d',
                                    'min_long',
+                                   'rolling_median_columns',
                                    'seed_rand',
-                                   'toss_coin']
+                                   'toss_coin',
+                                   'weighted_rolling_median']
 
 
 @pytest.mark.parametrize(
@@ -54,6 +61,7 @@ def test_orderedstructs_getattr(attribute, expected):
 @pytest.mark.skipif(not (sys.version_info.minor < 11), reason='Python < 3.11')
 def test_orderedstructs_skiplist_dir():
     assert dir(orderedstructs.SkipList) == ['__class__',
+                                            '__copy__',
                                             '__delattr__',
                                             '__dir__',
                                             '__doc__',
@@ -79,12 +87,17 @@ def test_orderedstructs_skiplist_dir():
                                             '__subclasshook__',
                                             'at',
                                             'at_seq',
+                                            'ceiling',
+                                            'copy',
                                             'dot_file',
+                                            'floor',
                                             'has',
                                             'height',
                                             'index',
                                             'insert',
+                                            'insert_with_rank',
                                             'lacks_integrity',
+                                            'nearest',
                                             'node_height',
                                             'node_width',
                                             'remove',
@@ -96,6 +109,7 @@ def test_orderedstructs_skiplist_dir():
 @pytest.mark.skipif(not (sys.version_info.minor >= 11), reason='Python 3.11+')
 def test_orderedstructs_skiplist_dir():
     assert dir(orderedstructs.SkipList) == ['__class__',
+                                            '__copy__',
                                             '__delattr__',
                                             '__dir__',
                                             '__doc__',
@@ -122,12 +136,17 @@ def test_orderedstructs_skiplist_dir():
                                             '__subclasshook__',
                                             'at',
                                             'at_seq',
+                                            'ceiling',
+                                            'copy',
                                             'dot_file',
+                                            'floor',
                                             'has',
                                             'height',
                                             'index',
                                             'insert',
+                                            'insert_with_rank',
                                             'lacks_integrity',
+                                            'nearest',
                                             'node_height',
                                             'node_width',
                                             'remove',
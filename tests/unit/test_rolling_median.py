@@ -188,3 +188,169 @@ def test_simple_array_works_with_nan_ffill(input_vector, window_length, expected
     result = rolling_median_with_nan_forward_fill(input_vector, window_length)
     print(result)
     assert lists_are_equal(result, expected)
+
+
+def rolling_median_reference(vector: typing.List[float], window_length: int) -> typing.List[float]:
+    """Computes the median of the last window_length values, or fewer at the start, by sorting."""
+    ret: typing.List[float] = []
+    for i in range(len(vector)):
+        window = sorted(vector[max(0, i + 1 - window_length):i + 1])
+        mid = len(window) // 2
+        if len(window) % 2:
+            ret.append(window[mid])
+        else:
+            ret.append(window[mid - 1] / 2 + window[mid] / 2)
+    return ret
+
+
+@pytest.mark.parametrize('window_length', (1, 2, 5, 16))
+def test_streaming_rolling_median(window_length):
+    vector = [float((i * 7919) % 97) for i in range(500)]
+    rm = orderedstructs.RollingMedian(window_length)
+    assert rm.window_length() == window_length
+    result = [rm.push(value) for value in vector]
+    assert result == rolling_median_reference(vector, window_length)
+    assert rm.median() == result[-1]
+    assert len(rm) == window_length
+    assert rm.size() == window_length
+
+
+def test_streaming_rolling_median_partial_window():
+    rm = orderedstructs.RollingMedian(window_length=5)
+    assert len(rm) == 0
+    assert rm.push(4.0) == 4.0
+    assert rm.push(1.0) == 2.5
+    assert rm.push(3.0) == 3.0
+    assert len(rm) == 3
+
+
+def test_streaming_rolling_median_empty_raises():
+    rm = orderedstructs.RollingMedian(3)
+    with pytest.raises(IndexError) as err:
+        rm.median()
+    assert err.value.args[0] == 'Can not find the median() of an empty window.'
+
+
+@pytest.mark.parametrize('window_length', (0, -1))
+def test_streaming_rolling_median_window_length_raises(window_length):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.RollingMedian(window_length)
+    assert err.value.args[0] == f'Argument "window_length" to __init__ must be > 0 not {window_length}'
+
+
+def test_streaming_rolling_median_push_type_raises():
+    rm = orderedstructs.RollingMedian(3)
+    with pytest.raises(TypeError) as err:
+        rm.push(1)
+    assert err.value.args[0] == 'Argument to push() must be float not "int" type'
+
+
+def test_streaming_rolling_median_push_nan_raises():
+    rm = orderedstructs.RollingMedian(3)
+    rm.push(1.0)
+    rm.push(2.0)
+    with pytest.raises(ValueError) as err:
+        rm.push(math.nan)
+    assert err.value.args[0] == (
+        'Can not push() a NaN with error "Can not work with something that does not compare equal to itself."'
+    )
+    # The window is unchanged.
+    assert len(rm) == 2
+    assert rm.median() == 1.5
+
+
+@pytest.mark.parametrize('method, args', (('push', (1.0,)), ('median', ()), ('size', ()), ('window_length', ()),
+                                          ('__len__', ())))
+def test_streaming_rolling_median_not_initialised_raises(method, args):
+    rm = orderedstructs.RollingMedian.__new__(orderedstructs.RollingMedian)
+    with pytest.raises(SystemError) as err:
+        getattr(rm, method)(*args)
+    assert err.value.args[0] == 'The object has not been initialised by __init__().'
+
+
+def time_window_median_reference(timestamps: typing.List[float], vector: typing.List[float],
+                                 duration: float) -> typing.List[float]:
+    """The median of the values with timestamps in (timestamp - duration, timestamp]."""
+    ret: typing.List[float] = []
+    for i in range(len(vector)):
+        window = sorted(vector[j] for j in range(i + 1) if timestamps[j] > timestamps[i] - duration)
+        mid = len(window) // 2
+        if len(window) % 2:
+            ret.append(window[mid])
+        else:
+            ret.append(window[mid - 1] / 2 + window[mid] / 2)
+    return ret
+
+
+@pytest.mark.parametrize('duration', (0.5, 3.0, 30.0, 1000.0))
+def test_time_window_rolling_median(duration):
+    # Irregular arrivals with bursts at the same time and gaps.
+    timestamps = []
+    now = 0.0
+    for i in range(500):
+        now += (0.0, 0.25, 1.0, 45.0)[(i * 31) % 7 % 4]
+        timestamps.append(now)
+    vector = [float((i * 7919) % 97) for i in range(500)]
+    rm = orderedstructs.TimeWindowRollingMedian(duration)
+    assert rm.duration() == duration
+    result = [rm.push(timestamp, value) for timestamp, value in zip(timestamps, vector)]
+    assert result == time_window_median_reference(timestamps, vector, duration)
+    assert rm.median() == result[-1]
+
+
+def test_time_window_rolling_median_evict():
+    rm = orderedstructs.TimeWindowRollingMedian(duration=30.0)
+    assert rm.push(0.0, 4.0) == 4.0
+    assert rm.push(10.0, 1.0) == 2.5
+    assert rm.push(20.0, 3.0) == 3.0
+    assert len(rm) == 3
+    # The first value leaves.
+    assert rm.push(30, 8.0) == 3.0
+    assert rm.size() == 3
+    assert rm.evict(45.0) == 1
+    assert rm.evict(1000.0) == 2
+    assert len(rm) == 0
+    with pytest.raises(IndexError) as err:
+        rm.median()
+    assert err.value.args[0] == 'Can not find the median() of an empty window.'
+
+
+@pytest.mark.parametrize('duration', (0.0, -1.0, math.nan))
+def test_time_window_rolling_median_duration_raises(duration):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.TimeWindowRollingMedian(duration)
+    assert err.value.args[0] == 'Argument "duration" to __init__ must be > 0'
+
+
+def test_time_window_rolling_median_push_raises():
+    rm = orderedstructs.TimeWindowRollingMedian(10.0)
+    rm.push(5.0, 1.0)
+    rm.push(6.0, 2.0)
+    with pytest.raises(ValueError) as err:
+        rm.push(4.0, 3.0)
+    assert err.value.args[0] == 'Can not push() with error "Timestamps must not decrease."'
+    with pytest.raises(ValueError) as err:
+        rm.push(7.0, math.nan)
+    assert err.value.args[0] == (
+        'Can not push() a NaN with error "Can not work with something that does not compare equal to itself."'
+    )
+    with pytest.raises(TypeError):
+        rm.push(8.0, 'a')
+    with pytest.raises(ValueError) as err:
+        rm.push(math.nan, 3.0)
+    assert err.value.args[0] == 'Can not push() with error "Timestamps must compare equal to themselves."'
+    with pytest.raises(ValueError) as err:
+        rm.evict(math.nan)
+    assert err.value.args[0] == 'Can not evict() with error "Timestamps must compare equal to themselves."'
+    # The window is unchanged.
+    assert len(rm) == 2
+    assert rm.median() == 1.5
+
+
+@pytest.mark.parametrize('method, args', (('push', (1.0, 2.0)), ('evict', (1.0,)), ('median', ()), ('size', ()),
+                                          ('duration', ()), ('__len__', ())))
+def test_time_window_rolling_median_not_initialised_raises(method, args):
+    rm = orderedstructs.TimeWindowRollingMedian.__new__(orderedstructs.TimeWindowRollingMedian)
+    with pytest.raises(SystemError) as err:
+        getattr(rm, method)(*args)
+    assert err.value.args[0] == 'The object has not been initialised by __init__().'
@@ -0,0 +1,75 @@
+import math
+
+import numpy as np
+import pytest
+
+import orderedstructs
+
+
+def rolling_median_columns_reference(array: np.ndarray, window_length: int) -> np.ndarray:
+    """Rolling median of each column using numpy."""
+    windows = np.lib.stride_tricks.sliding_window_view(array, window_length, axis=0)
+    return np.median(windows, axis=-1)
+
+
+@pytest.mark.parametrize('window_length', (1, 2, 5, 21))
+@pytest.mark.parametrize('thread_count', (0, 1, 4, 4000))
+def test_rolling_median_columns(window_length, thread_count):
+    rng = np.random.default_rng(1)
+    array = rng.random((200, 37))
+    dest = np.empty((array.shape[0] - window_length + 1, array.shape[1]))
+    result = orderedstructs.rolling_median_columns(array, dest, window_length, thread_count=thread_count)
+    assert result is None
+    assert np.allclose(dest, rolling_median_columns_reference(array, window_length))
+
+
+@pytest.mark.parametrize('order', ('C', 'F'))
+def test_rolling_median_columns_order(order):
+    rng = np.random.default_rng(1)
+    array = np.asarray(rng.random((100, 8)), order=order)
+    dest = np.empty((96, 8), order=order)
+    orderedstructs.rolling_median_columns(array, dest, 5)
+    assert np.allclose(dest, rolling_median_columns_reference(array, 5))
+
+
+def test_rolling_median_columns_strided():
+    rng = np.random.default_rng(1)
+    array = rng.random((100, 16))[::2, ::3]
+    dest = np.empty((array.shape[0] - 4, array.shape[1]))
+    orderedstructs.rolling_median_columns(array, dest, 5)
+    assert np.allclose(dest, rolling_median_columns_reference(array, 5))
+
+
+@pytest.mark.parametrize(
+    'src, dest, window_length, expected',
+    (
+            (np.zeros((10, 2)), np.zeros((6, 2)), 0, 'Argument "window_length" must be > 0 not 0'),
+            (np.zeros(10), np.zeros(6), 5, 'Argument "src" must be a 2D array not 1 dimensions'),
+            (np.zeros((10, 2), dtype=np.int32), np.zeros((6, 2)), 5,
+             'Argument "src" must be an array of doubles not format "i"'),
+            (np.zeros((4, 2)), np.zeros((1, 2)), 5,
+             'Argument "src" has 4 rows which is less than the window length 5'),
+            (np.zeros((10, 2)), np.zeros((6, 3)), 5, 'Argument "dest" must have shape (6, 2) not (6, 3)'),
+            (np.zeros((10, 2))[::-1], np.zeros((6, 2)), 5,
+             'Argument "src" must have positive strides that are a multiple of the item size.'),
+    )
+)
+def test_rolling_median_columns_raises(src, dest, window_length, expected):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.rolling_median_columns(src, dest, window_length)
+    assert err.value.args[0] == expected
+
+
+def test_rolling_median_columns_read_only_dest_raises():
+    dest = np.zeros((6, 2))
+    dest.flags.writeable = False
+    with pytest.raises(ValueError):
+        orderedstructs.rolling_median_columns(np.zeros((10, 2)), dest, 5)
+
+
+def test_rolling_median_columns_nan_raises():
+    array = np.zeros((10, 4))
+    array[5, 2] = math.nan
+    with pytest.raises(ValueError) as err:
+        orderedstructs.rolling_median_columns(array, np.zeros((6, 4)), 5, thread_count=2)
+    assert err.value.args[0] == 'Can not compute the rolling median of columns containing a NaN.'
@@ -0,0 +1,152 @@
+import math
+
+import numpy as np
+import pytest
+
+import orderedstructs
+
+
+def weighted_median_reference(values: np.ndarray, weights: np.ndarray) -> float:
+    """The first value, in sorted order, where the cumulative weight reaches half the total weight."""
+    order = np.lexsort((weights, values))
+    cumulative = np.cumsum(weights[order])
+    index = min(np.searchsorted(cumulative, cumulative[-1] / 2, side='left'), len(values) - 1)
+    return values[order[index]]
+
+
+def weighted_rolling_median_reference(values: np.ndarray, weights: np.ndarray, window_length: int) -> np.ndarray:
+    return np.array(
+        [
+            weighted_median_reference(values[i:i + window_length], weights[i:i + window_length])
+            for i in range(len(values) - window_length + 1)
+        ]
+    )
+
+
+def _values_and_weights(length: int) -> tuple[np.ndarray, np.ndarray]:
+    rng = np.random.default_rng(1)
+    # Integer weights so that the cumulative sums are exact.
+    return rng.integers(0, 50, length).astype(np.float64), rng.integers(0, 10, length).astype(np.float64)
+
+
+@pytest.mark.parametrize('window_length', (1, 2, 5, 16, 101))
+def test_weighted_rolling_median(window_length):
+    values, weights = _values_and_weights(500)
+    dest = np.empty(len(values) - window_length + 1)
+    orderedstructs.weighted_rolling_median(values, weights, dest, window_length)
+    assert np.array_equal(dest, weighted_rolling_median_reference(values, weights, window_length))
+
+
+def test_weighted_rolling_median_equal_weights():
+    values, _weights = _values_and_weights(500)
+    dest = np.empty(len(values) - 6)
+    orderedstructs.weighted_rolling_median(values, np.ones_like(values), dest, 7)
+    windows = np.lib.stride_tricks.sliding_window_view(values, 7)
+    assert np.array_equal(dest, np.median(windows, axis=1))
+
+
+def test_weighted_rolling_median_strided():
+    values, weights = _values_and_weights(1000)
+    values = values[::2]
+    weights = weights[::2]
+    dest = np.empty((len(values) - 10, 2))[:, 1]
+    orderedstructs.weighted_rolling_median(values, weights, dest, 11)
+    assert np.array_equal(dest, weighted_rolling_median_reference(values, weights, 11))
+
+
+@pytest.mark.parametrize(
+    'weight, expected',
+    (
+            (-1.0, 'Argument "weights" must be finite and non-negative.'),
+            (math.nan, 'Argument "weights" must be finite and non-negative.'),
+            (math.inf, 'Argument "weights" must be finite and non-negative.'),
+    )
+)
+def test_weighted_rolling_median_bad_weight_raises(weight, expected):
+    values, weights = _values_and_weights(100)
+    weights[50] = weight
+    dest = np.empty(len(values) - 4)
+    with pytest.raises(ValueError) as err:
+        orderedstructs.weighted_rolling_median(values, weights, dest, 5)
+    assert err.value.args[0] == expected
+
+
+@pytest.mark.parametrize(
+    'values_length, weights_length, dest_length, window_length, expected',
+    (
+            (100, 100, 96, 0, 'Argument "window_length" must be > 0 not 0'),
+            (100, 99, 96, 5, 'Argument "weights" must have length 100 not 99'),
+            (100, 100, 100, 5, 'Argument "dest" must have length 96 not 100'),
+            (4, 4, 1, 5, 'Argument "src" has length 4 which is less than the window length 5'),
+    )
+)
+def test_weighted_rolling_median_shape_raises(values_length, weights_length, dest_length, window_length, expected):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.weighted_rolling_median(np.zeros(values_length), np.ones(weights_length),
+                                               np.empty(dest_length), window_length)
+    assert err.value.args[0] == expected
+
+
+def test_weighted_rolling_median_nan_raises():
+    values, weights = _values_and_weights(100)
+    values[50] = math.nan
+    dest = np.empty(len(values) - 4)
+    with pytest.raises(ValueError) as err:
+        orderedstructs.weighted_rolling_median(values, weights, dest, 5)
+    assert err.value.args[0] == 'Can not compute the weighted median of an array containing a NaN.'
+
+
+@pytest.mark.parametrize('window_length', (1, 2, 5, 16, 101))
+def test_streaming_weighted_rolling_median(window_length):
+    values, weights = _values_and_weights(500)
+    rm = orderedstructs.WeightedRollingMedian(window_length)
+    assert rm.window_length() == window_length
+    result = [rm.push(value, weight) for value, weight in zip(values, weights)]
+    for i, median in enumerate(result):
+        begin = max(0, i + 1 - window_length)
+        assert median == weighted_median_reference(values[begin:i + 1], weights[begin:i + 1])
+    assert len(rm) == window_length
+    assert rm.median() == result[-1]
+    assert rm.total_weight() == sum(weights[-window_length:])
+
+
+def test_streaming_weighted_rolling_median_volume_weighted():
+    rm = orderedstructs.WeightedRollingMedian(3)
+    assert rm.push(100.0, 10.0) == 100.0
+    assert rm.push(101.0, 30.0) == 101.0
+    assert rm.push(99.0, 5.0) == 101.0
+    # 100.0 is evicted.
+    assert rm.push(98.0, 50.0) == 98.0
+    assert rm.size() == 3
+    assert rm.total_weight() == 85.0
+
+
+def test_streaming_weighted_rolling_median_empty_raises():
+    rm = orderedstructs.WeightedRollingMedian(3)
+    with pytest.raises(IndexError) as err:
+        rm.median()
+    assert err.value.args[0] == 'Can not find the median() of an empty window.'
+
+
+@pytest.mark.parametrize('window_length', (0, -1))
+def test_streaming_weighted_rolling_median_window_length_raises(window_length):
+    with pytest.raises(ValueError) as err:
+        orderedstructs.WeightedRollingMedian(window_length)
+    assert err.value.args[0] == f'Argument "window_length" to __init__ must be > 0 not {window_length}'
+
+
+@pytest.mark.parametrize('value, weight', ((math.nan, 1.0), (1.0, -1.0), (1.0, math.nan), (1.0, math.inf)))
+def test_streaming_weighted_rolling_median_push_raises(value, weight):
+    rm = orderedstructs.WeightedRollingMedian(3)
+    with pytest.raises(ValueError):
+        rm.push(value, weight)
+    assert len(rm) == 0
+
+
+@pytest.mark.parametrize('method, args', (('push', (1.0, 2.0)), ('median', ()), ('size', ()), ('window_length', ()),
+                                          ('total_weight', ()), ('__len__', ())))
+def test_streaming_weighted_rolling_median_not_initialised_raises(method, args):
+    rm = orderedstructs.WeightedRollingMedian.__new__(orderedstructs.WeightedRollingMedian)
+    with pytest.raises(SystemError) as err:
+        getattr(rm, method)(*args)
+    assert err.value.args[0] == 'The object has not been initialised by __init__().'